@@ -14,12 +14,14 @@
  */
 /**
  * Top-level configuration for node code for the AntiTheft demo app.
- * Instantiates the sensors, dissemination and collection services, and
- * does all the necessary wiring.
+ * Instantiates the sensors, dissemination service and alert transport
+ * (flooding, or collection with ALERT_TRANSPORT=ctp), and does all the
+ * necessary wiring.
  *
  * @author David Gay
  */
 #include "antitheft.h"
+#include "StorageVolumes.h"
 
 configuration AntiTheftAppC { }
 implementation
@@ -27,9 +29,10 @@ implementation
   /* First wire the low-level services (booting, serial port, radio).
      There is no standard name for the actual radio component, so we use
      #ifdef to get the right one for the current platform. */
-  components AntiTheftC, ActiveMessageC, MainC, LedsC,
-    new TimerMilliC() as MyTimer, new TimerMilliC() as SleepTimer;
-#if defined(PLATFORM_MICA2)
+  components ActiveMessageC, MainC, LedsC;
+#if defined(TOSSIM)
+#error "Build the TOSSIM simulation of the AntiTheft application in the sim directory"
+#elif defined(PLATFORM_MICA2)
   components CC1000CsmaRadioC as Radio;
 #elif defined(PLATFORM_MICAZ)
   components CC2420ActiveMessageC as Radio;
@@ -39,37 +42,92 @@ implementation
 #error "The AntiTheft application is only supported for mica2, micaz and iris nodes"
 #endif
 
-  AntiTheftC.Boot -> MainC.Boot;
-  AntiTheftC.Check -> MyTimer;
-  AntiTheftC.BlacklistSleep -> SleepTimer;
-  AntiTheftC.Leds -> LedsC;
-  AntiTheftC.RadioControl -> ActiveMessageC;
-  AntiTheftC.LowPowerListening -> Radio;
+  /* The node code, with the buffer, path, duplicate cache and
+     aggregation sizes of antitheft.h */
+  components new AntiTheftC(MSG_POOL_SIZE, PATH_DEPTH, DUP_CACHE_SIZE,
+			    AGGREGATION_WINDOW) as AntiTheft;
 
-  /* DemoSensor reads battery voltage. */
+  AntiTheft.Boot -> MainC.Boot;
+  AntiTheft.LowPowerListening -> Radio;
 
-  components new DemoSensorC() as ReadBattery;
+  /* The flash volume (volumes-at45db.xml) that keeps the version of the
+     blacklist listing last acted on across reboots */
+  components new ConfigStorageC(VOLUME_ANTITHEFT) as Store;
 
-  AntiTheftC.BatteryLevel -> ReadBattery;
+  AntiTheft.Mount -> Store;
+  AntiTheft.ConfigStorage -> Store;
 
-  components DisseminationC;
-  AntiTheftC.DisseminationControl -> DisseminationC;
+  /* DemoSensor reads battery voltage. */
 
-  /* Instantiate and wire our settings dissemination service */
-  components new DisseminatorC(settings_t, DIS_SETTINGS);
-  AntiTheftC.SettingsValue -> DisseminatorC;
+  components new DemoSensorC() as ReadBattery;
 
+#ifdef ALERT_TRANSPORT_CTP
   /* Instantiate and wire our collection service for blacklist alerts */
-  components CollectionC; //, new CollectionSenderC(COL_ALERTS) as AlertSender;
-
-  //AntiTheftC.AlertRoot -> AlertSender;
-  AntiTheftC.CollectionControl -> CollectionC;
+  components CollectionC, new CollectionSenderC(COL_ALERTS) as AlertSender;
 
+  AntiTheft.CollectionControl -> CollectionC;
+  AntiTheft.AlertSend -> AlertSender;
+  AntiTheft.AlertIntercept -> CollectionC.Intercept[COL_ALERTS];
+#else
   /* Instantiate and wire our local radio-broadcast blacklist alert and 
      reception services */
   components new AMSenderC(AM_THEFT) as SendTheft, 
     new AMReceiverC(AM_THEFT) as ReceiveTheft;
+#endif
+
+#ifdef ENERGY_ACCOUNTING
+  /* Account for the energy spent by the radio, alerts, battery readings
+     and leds (make micaz ENERGY_ACCOUNTING=1) */
+  components EnergyMeterC;
+
+  AntiTheft.Leds -> EnergyMeterC;
+  AntiTheft.RadioControl -> EnergyMeterC;
+  AntiTheft.BatteryLevel -> EnergyMeterC;
+  EnergyMeterC.SubLeds -> LedsC;
+  EnergyMeterC.SubRadioControl -> ActiveMessageC;
+  EnergyMeterC.SubBatteryLevel -> ReadBattery;
+#ifndef ALERT_TRANSPORT_CTP
+  AntiTheft.TheftSend -> EnergyMeterC;
+  AntiTheft.TheftReceive -> EnergyMeterC;
+  EnergyMeterC.SubTheftSend -> SendTheft;
+  EnergyMeterC.SubTheftReceive -> ReceiveTheft;
+#endif
+#else
+  AntiTheft.Leds -> LedsC;
+  AntiTheft.RadioControl -> ActiveMessageC;
+  AntiTheft.BatteryLevel -> ReadBattery;
+#ifndef ALERT_TRANSPORT_CTP
+  AntiTheft.TheftSend -> SendTheft;
+  AntiTheft.TheftReceive -> ReceiveTheft;
+#endif
+#endif
+
+  components DisseminationC;
+  AntiTheft.DisseminationControl -> DisseminationC;
+
+  /* Instantiate and wire our settings dissemination service, one item
+     per part of the settings, and one per page of the tables */
+  components new DisseminatorC(sampling_t, DIS_SAMPLING) as SamplingC,
+    new DisseminatorC(reporting_t, DIS_REPORTING) as ReportingC,
+    new PagedItemsC(blacklist_t, DIS_BLACKLIST) as BlacklistC,
+    new PagedItemsC(profiles_t, DIS_PROFILES) as ProfilesC;
+  AntiTheft.SamplingValue -> SamplingC;
+  AntiTheft.ReportingValue -> ReportingC;
+  AntiTheft.BlacklistValue -> BlacklistC.Value;
+  AntiTheft.ProfilesValue -> ProfilesC.Value;
+
+  /* Source-routed commands from the root, passed on hop by hop */
+  components new AMSenderC(AM_COMMAND) as SendCommand,
+    new AMReceiverC(AM_COMMAND) as ReceiveCommand;
+
+  AntiTheft.CommandSend -> SendCommand;
+  AntiTheft.CommandReceive -> ReceiveCommand;
+  AntiTheft.CommandAcks -> ActiveMessageC;
+
+  /* Blacklist pages of urgent pushes, flooded ahead of dissemination */
+  components new AMSenderC(AM_URGENT) as SendUrgent,
+    new AMReceiverC(AM_URGENT) as ReceiveUrgent;
 
-  AntiTheftC.TheftSend -> SendTheft;
-  AntiTheftC.TheftReceive -> ReceiveTheft;
+  AntiTheft.UrgentSend -> SendUrgent;
+  AntiTheft.UrgentReceive -> ReceiveUrgent;
 }
@@ -0,0 +1,965 @@
+// This file has been modified by Chris Zimmerman.
+// This file, along with the other original AntiTheft application code
+// can be found at tinyos.net 
+
+// $Id: AntiTheftC.nc,v 1.7 2009/10/28 19:11:15 razvanm Exp $
+/*
+ * Copyright (c) 2007 Intel Corporation
+ * All rights reserved.
+ *
+ * This file is distributed under the terms in the attached INTEL-LICENSE     
+ * file. If you do not find these files, copies can be found by writing to
+ * Intel Research Berkeley, 2150 Shattuck Avenue, Suite 1300, Berkeley, CA, 
+ * 94704.  Attention:  Intel License Inquiry.
+ */
+/**
+ * Main code for the anti theft demo application.
+ *
+ * Alerts are flooded hop by hop over AM_THEFT broadcasts unless the
+ * application is built with ALERT_TRANSPORT=ctp, which sends them to
+ * the root over collection (CTP) instead. Either way every node on the
+ * way records itself in the alert's path.
+ *
+ * Alerts the node originates and alerts it forwards are built in buffers
+ * from one pool (MsgPool, MSG_POOL_SIZE buffers) and wait in AlertQueue
+ * until the radio takes them, one at a time. A flooded alert is forwarded
+ * in the buffer it was received in, and a pool buffer goes back to the
+ * radio stack in its place.
+ *
+ * The sizes of a deployment are generic parameters, so each build only
+ * carries the tables it uses (see AntiTheftC, which also sizes the
+ * buffer pool):
+ * - PATH_DEPTH: hops of the alert path (at most the six of alert_t) that
+ *   are checked for loops and recorded when forwarding
+ * - DUP_CACHE_SIZE: recently forwarded alerts remembered, so that copies
+ *   of a flooded alert arriving over other paths are not sent again
+ *   (0: none)
+ * - AGGREGATION_WINDOW: time (ms) queued alerts are held before sending;
+ *   a newer alert from the same node replaces one still held, so only
+ *   its latest reading goes out (0: send at once)
+ *
+ * A send that has not completed after SEND_TIMEOUT (the radio was
+ * stopped under it, or its completion event was lost) is cancelled and
+ * counted, and the queue moves on, so that one lost sendDone cannot take
+ * the node out of the network. A send that is still pending after
+ * STUCK_LIMIT timeouts, or when the radio stops or starts, is abandoned:
+ * its buffer may never come back, so a spare buffer takes its place in
+ * the pool.
+ *
+ * A node told to blacklist itself drains before it turns its radio off:
+ * it stops originating and forwarding alerts, sends what is queued, and
+ * only then stops the radio, or after DRAIN_TIMEOUT at the latest. The
+ * version of the listing it acted on is kept in a config volume, and
+ * read back before the radio starts, so that a node which reboots does
+ * not blacklist itself again for a listing it has already served.
+ *
+ * Settings arrive as separate dissemination items (see sampling_t), so
+ * a blacklist leaves the check timer alone, and a new check interval
+ * does not touch how the node reports. The blacklist table and the
+ * profiles table are too big for one item, so each comes as pages of
+ * their own items. The profiles table may give the node's range of IDs
+ * its own check interval and reporting policy; the node looks itself up
+ * in it by binary search whenever a page changes.
+ *
+ * The blacklist page of an urgent push also arrives ahead of
+ * dissemination, flooded by the root: a node acts on a newer page at
+ * once and broadcasts it again after a short random delay.
+ *
+ * Commands for a single node (command_t) arrive as unicasts along a
+ * source route. A node on the route passes them on to the next hop; the
+ * target acts on them and sends them back towards the root as their
+ * acknowledgement.
+ *
+ * @author David Gay
+ */
+#include "antitheft.h"
+
+generic module AntiTheftP(uint8_t PATH_DEPTH, uint8_t DUP_CACHE_SIZE,
+			  uint16_t AGGREGATION_WINDOW)
+{
+  uses {
+    interface Timer<TMilli> as Check;
+    interface Timer<TMilli> as BlacklistSleep;
+    interface Timer<TMilli> as AggregationTimer;
+    interface Timer<TMilli> as SendWatchdog;
+    interface Timer<TMilli> as DrainTimer;
+    interface Leds;
+    interface Boot;
+    interface Mount;
+    interface ConfigStorage;
+    interface DisseminationValue<sampling_t> as SamplingValue;
+    interface DisseminationValue<reporting_t> as ReportingValue;
+    interface DisseminationValue<profiles_t> as ProfilesValue[uint8_t page];
+    interface DisseminationValue<blacklist_t> as BlacklistValue[uint8_t page];
+    interface StdControl as DisseminationControl;
+    interface SplitControl as RadioControl;
+    interface LowPowerListening;
+    interface Read<uint16_t> as BatteryLevel;
+    interface Pool<message_t> as MsgPool;
+    interface Queue<message_t *> as AlertQueue;
+    interface AMSend as CommandSend;
+    interface Receive as CommandReceive;
+    interface PacketAcknowledgements as CommandAcks;
+    interface AMSend as UrgentSend;
+    interface Receive as UrgentReceive;
+    interface Timer<TMilli> as UrgentTimer;
+    interface Random;
+#ifdef ALERT_TRANSPORT_CTP
+    interface StdControl as CollectionControl;
+    interface Send as AlertSend;
+    interface Intercept as AlertIntercept;
+#else
+    interface AMSend as TheftSend;
+    interface Receive as TheftReceive;
+#endif
+  }
+}
+implementation
+{
+  enum {
+    /* A battery with voltage below this level is conisdered low on power */
+    BATTERY_THRESHOLD = 300, 
+
+    /* Amount of time node "goes to sleep" (turns its radio off) for. */
+    SLEEP_TIME = 10000,
+
+    /* Amount of time warning leds should stay on (in checkInterval counts) */
+    WARNING_TIME = 3,
+
+    /* Hops an alert_t records (path1..path6), and an unused hop */
+    ALERT_PATH_LEN = 6,
+    NO_HOP = 999,
+    DEPTH = PATH_DEPTH < ALERT_PATH_LEN ? PATH_DEPTH : ALERT_PATH_LEN,
+
+    /* A send may wait out a whole low-power listening interval, twice
+       with a retry, before it completes */
+    SEND_TIMEOUT = 2 * LPL_INTERVAL + 1000,
+
+    /* Timeouts a send may outlast before it is abandoned, and spare
+       buffers that replace the ones abandoned sends strand */
+    STUCK_LIMIT = 3,
+    SPARE_BUFFERS = 2,
+
+    /* Longest time queued alerts may take to go out before blacklisting */
+    DRAIN_TIMEOUT = SEND_TIMEOUT,
+
+    /* Longest delay (ms) before repeating an urgent flood, so that
+       neighbours do not all send at once */
+    URGENT_JITTER = 64
+  };
+
+  sampling_t sampling;
+  reporting_t reporting;
+  uint16_t profileInterval; /* Our entry in the profiles table, 0 if none */
+  uint8_t profileAlert;
+  uint16_t settingsVersion; /* Newest settings version received */
+  bool haveSettings; /* and whether there was one */
+  uint16_t blacklistDuration; /* How long the radio stays off when blacklisted */
+  uint16_t blacklistVersion; /* Version of the listing last acted on */
+  bool actedOnListing; /* and whether there was one */
+  uint16_t storedVersion; /* blacklistVersion as written to ConfigStorage */
+  bool storeBusy;
+  uint16_t blacklistNewest; /* Newest listing in the blacklist pages we have */
+  bool haveBlacklist; /* and whether we have one */
+  uint8_t listedPages; /* Bit p set if blacklist page p lists us */
+  message_t urgentMsg; /* The urgent blacklist page being repeated */
+  bool urgentBusy;
+  uint16_t ledTime; /* Time left until leds switched off */
+  uint16_t currentVolt; /* Current voltage read by the sensor node */
+  bool fwdBusy; /* Set while the head of AlertQueue is being sent */
+  uint16_t alertSeqno; /* Sequence number of the next alert this node originates */
+  bool holding; /* Queued alerts are held for the aggregation window */
+  uint16_t stuckSends; /* Sends the watchdog gave up on */
+  uint8_t overdue; /* Timeouts the send in progress has outlasted */
+  message_t spareMsgs[SPARE_BUFFERS]; /* Replace buffers abandoned sends strand */
+  uint8_t sparesUsed;
+  bool draining; /* Sending what is queued before the radio goes off */
+  bool commandedDrain; /* and whether a command asked for it */
+  message_t commandMsg; /* The command being passed on */
+  am_addr_t commandDest; /* and where to */
+  bool commandBusy;
+  uint8_t commandRetries;
+
+  task void sendTask();
+  void abandonSend();
+  void startDrain(bool commanded);
+  void stopDrain();
+
+  /* (stolenId, packetId) of the last DUP_CACHE_SIZE alerts forwarded;
+     the oldest is replaced first */
+  struct {
+    uint16_t stolenId, packetId;
+  } forwarded[DUP_CACHE_SIZE];
+  uint8_t forwardedCount, forwardedNext;
+
+  /********* LED handling **********/
+
+  /* Warn that some error occurred */
+  void errorLed() {
+    ledTime = WARNING_TIME;
+    call Leds.led2On();
+  }
+
+  /* Notify user that settings changed */
+  void settingsLed() {
+    ledTime = WARNING_TIME;
+    call Leds.led1On();
+  }
+
+  /* Turn on bright red light! (LED) */
+  void theftLed() {
+    ledTime = WARNING_TIME;
+    call Leds.led0On();
+  }
+
+  /* Time-out leds. Called every checkInterval */
+  void updateLeds() {
+    if (ledTime && !--ledTime)
+      {
+	call Leds.led0Off();
+	call Leds.led1Off();
+	call Leds.led2Off();
+      }
+  }
+
+  /* Check result code and report error if a problem occurred */
+  void check(error_t ok) {
+    if (ok != SUCCESS)
+      errorLed();
+  }
+
+  /* At boot time, start the periodic timer, and the radio once we know
+     which listing we last acted on */
+  event void Boot.booted() {
+    errorLed();
+    reporting.alert = DEFAULT_ALERT;
+    sampling.detect = DEFAULT_DETECT;
+    sampling.checkInterval = DEFAULT_CHECK_INTERVAL;
+
+    call Check.startPeriodic(DEFAULT_CHECK_INTERVAL);
+    if (call Mount.mount() != SUCCESS)
+      call RadioControl.start();
+  }
+
+  /********* Stored listing **********/
+
+  /* A volume that cannot be read leaves us with no listing acted on */
+  event void Mount.mountDone(error_t error) {
+    if (error != SUCCESS || !call ConfigStorage.valid() ||
+	call ConfigStorage.read(0, &storedVersion, sizeof storedVersion) != SUCCESS)
+      call RadioControl.start();
+  }
+
+  event void ConfigStorage.readDone(storage_addr_t addr, void *buf, storage_len_t len,
+				    error_t error) {
+    if (error == SUCCESS)
+      {
+	blacklistVersion = storedVersion;
+	actedOnListing = TRUE;
+      }
+    call RadioControl.start();
+  }
+
+  /* Keep blacklistVersion across reboots. A listing acted on while the
+     last one is being written is written once that is done. */
+  void storeListing() {
+    if (storeBusy)
+      return;
+    storedVersion = blacklistVersion;
+    if (call ConfigStorage.write(0, &storedVersion, sizeof storedVersion) == SUCCESS)
+      storeBusy = TRUE;
+  }
+
+  event void ConfigStorage.writeDone(storage_addr_t addr, void *buf, storage_len_t len,
+				     error_t error) {
+    if (error != SUCCESS || call ConfigStorage.commit() != SUCCESS)
+      storeBusy = FALSE;
+  }
+
+  event void ConfigStorage.commitDone(error_t error) {
+    storeBusy = FALSE;
+    if (storedVersion != blacklistVersion)
+      storeListing();
+  }
+
+  /* Radio started. Now start the collection protocol and set the
+     wakeup interval for low-power-listening wakeup to half a second. */
+  event void RadioControl.startDone(error_t ok) {
+    abandonSend();
+    if (ok == SUCCESS)
+      {
+	call DisseminationControl.start();
+#ifdef ALERT_TRANSPORT_CTP
+	call CollectionControl.start();
+#endif
+	call LowPowerListening.setLocalWakeupInterval(LPL_INTERVAL);
+      }
+    else
+      errorLed();
+  }
+
+  /* The radio has shut down, so shut down the dissemination and
+     collection controls and start the blacklist timer. */
+  event void RadioControl.stopDone(error_t ok) 
+  { 
+	dbg("AntiTheft", "radio-off %llu %hu\n", sim_time(), blacklistDuration);
+	abandonSend();
+  	call DisseminationControl.stop();
+#ifdef ALERT_TRANSPORT_CTP
+	call CollectionControl.stop();
+#endif
+        call BlacklistSleep.startOneShot(blacklistDuration);
+  }
+
+  /* The blacklist time period has expired, so start the radio again. */
+  event void BlacklistSleep.fired()
+  {
+	dbg("AntiTheft", "radio-on %llu\n", sim_time());
+	call RadioControl.start();
+  }
+
+  /* A part of the settings changed. Alerts report the newest version
+     received; the items of one push may arrive in any order. */
+  void settingsChanged(uint16_t version) {
+    settingsLed();
+    if (!haveSettings || (int16_t)(version - settingsVersion) > 0)
+      {
+	haveSettings = TRUE;
+	settingsVersion = version;
+	dbg("AntiTheft", "settings %llu %hu\n", sim_time(), settingsVersion);
+      }
+  }
+
+  /* The check interval and reporting policy in force: our profile's,
+     unless it leaves them to the network-wide settings */
+  uint16_t checkInterval() {
+    return profileInterval ? profileInterval : sampling.checkInterval;
+  }
+
+  uint8_t alertPolicy() {
+    return profileAlert ? profileAlert : reporting.alert;
+  }
+
+  /* Restart the check timer if the interval in force is no longer
+     oldInterval */
+  void intervalChanged(uint16_t oldInterval) {
+    if (checkInterval() != oldInterval)
+      call Check.startPeriodic(checkInterval());
+  }
+
+  /* New sampling policy. Only a new check interval restarts the check
+     timer. */
+  event void SamplingValue.changed() {
+    uint16_t oldInterval = checkInterval();
+
+    sampling = *call SamplingValue.get();
+    intervalChanged(oldInterval);
+    settingsChanged(sampling.version);
+  }
+
+  event void ReportingValue.changed() {
+    reporting = *call ReportingValue.get();
+    settingsChanged(reporting.version);
+  }
+
+  /* Entry i of the profiles table is entry i % PROFILE_PAGE_SIZE of page
+     i / PROFILE_PAGE_SIZE. The table runs on from page 0 while the pages
+     are full and stamped with page 0's version. */
+  uint8_t profileCount() {
+    const profiles_t *head = call ProfilesValue.get[0]();
+    uint8_t page, count = 0;
+
+    for (page = 0; head != NULL && page < PROFILE_PAGES; page++)
+      {
+	const profiles_t *profiles = call ProfilesValue.get[page]();
+
+	if (profiles == NULL || profiles->version != head->version)
+	  break;
+	if (profiles->count < PROFILE_PAGE_SIZE)
+	  return count + profiles->count;
+	count += PROFILE_PAGE_SIZE;
+      }
+    return count;
+  }
+
+  const profiles_t *profilePage(uint8_t entry) {
+    return call ProfilesValue.get[entry / PROFILE_PAGE_SIZE]();
+  }
+
+  /* The entry of the profiles table covering node: the last one whose
+     first ID is not above node, found by binary search. -1 if none. */
+  int8_t profileOf(uint16_t node) {
+    uint8_t low = 0, high = profileCount();
+
+    while (low < high)
+      {
+	uint8_t middle = (low + high) / 2;
+
+	if (profilePage(middle)->first[middle % PROFILE_PAGE_SIZE] <= node)
+	  low = middle + 1;
+	else
+	  high = middle;
+      }
+    return (int8_t)low - 1;
+  }
+
+  event void ProfilesValue.changed[uint8_t page]() {
+    int8_t entry = profileOf(TOS_NODE_ID);
+    uint16_t oldInterval = checkInterval();
+
+    profileInterval = 0;
+    profileAlert = 0;
+    if (entry >= 0)
+      {
+	const profiles_t *profiles = profilePage(entry);
+
+	profileInterval = profiles->interval[entry % PROFILE_PAGE_SIZE];
+	profileAlert = profiles->alert[entry % PROFILE_PAGE_SIZE];
+      }
+    dbg("AntiTheft", "profile %llu %hu %hhu\n", sim_time(), checkInterval(), alertPolicy());
+    intervalChanged(oldInterval);
+    settingsChanged(call ProfilesValue.get[page]()->version);
+  }
+
+  default command const profiles_t *ProfilesValue.get[uint8_t page]() { return NULL; }
+
+  /* New blacklist page. If we are newly listed in it, stop the radio
+     for the duration listed, once the alerts already queued are out. If
+     no page lists us any more, stay on. */
+  uint16_t newestListing(const blacklist_t *blacklist) {
+    uint16_t newest = blacklist->version[0];
+    uint8_t i;
+
+    for (i = 1; i < BLACKLIST_PAGE_SIZE; i++)
+      if ((int16_t)(blacklist->version[i] - newest) > 0)
+	newest = blacklist->version[i];
+    return newest;
+  }
+
+  void blacklistChanged(uint8_t page, const blacklist_t *blacklist) {
+    uint16_t newest = newestListing(blacklist);
+    uint8_t i;
+
+    if (!haveBlacklist || (int16_t)(newest - blacklistNewest) > 0)
+      blacklistNewest = newest;
+    haveBlacklist = TRUE;
+    listedPages &= ~(1 << page);
+    for (i = 0; i < BLACKLIST_PAGE_SIZE; i++)
+      {
+	if (blacklist->target[i] == TOS_NODE_ID)
+	  {
+	    listedPages |= 1 << page;
+	    if (!actedOnListing || (int16_t)(blacklist->version[i] - blacklistVersion) > 0)
+	      {
+		actedOnListing = TRUE;
+		blacklistVersion = blacklist->version[i];
+		blacklistDuration = blacklist->duration[i];
+		storeListing();
+		startDrain(FALSE);
+	      }
+	  }
+      }
+    /* A page only calls off the drains pages started */
+    if (!listedPages && draining && !commandedDrain)
+      stopDrain();
+    settingsChanged(blacklistNewest);
+  }
+
+  event void BlacklistValue.changed[uint8_t page]() {
+    blacklistChanged(page, call BlacklistValue.get[page]());
+  }
+
+  default command const blacklist_t *BlacklistValue.get[uint8_t page]() { return NULL; }
+
+  /********* Urgent settings **********/
+
+  void urgentDone() {
+    urgentBusy = FALSE;
+    if (draining)
+      post sendTask();
+  }
+
+  /* A blacklist page flooded by the root for an urgent push: act on it
+     now rather than when dissemination gets here, and pass it on once.
+     Pages listing nothing newer than we have have been seen already. */
+  event message_t *UrgentReceive.receive(message_t *msg, void *payload, uint8_t len)
+  {
+    blacklist_t *blacklist = payload, *fwd;
+
+    if (len != sizeof(*blacklist) || blacklist->page >= BLACKLIST_PAGES || urgentBusy ||
+	(haveBlacklist && (int16_t)(newestListing(blacklist) - blacklistNewest) <= 0))
+      return msg;
+
+    fwd = call UrgentSend.getPayload(&urgentMsg, sizeof(blacklist_t));
+    if (fwd == NULL)
+      return msg;
+    *fwd = *blacklist;
+    urgentBusy = TRUE;
+    dbg("AntiTheft", "urgent %llu %hu\n", sim_time(), newestListing(blacklist));
+    blacklistChanged(blacklist->page, blacklist);
+    call UrgentTimer.startOneShot(call Random.rand16() % URGENT_JITTER);
+    return msg;
+  }
+
+  event void UrgentTimer.fired() {
+    if (call UrgentSend.send(AM_BROADCAST_ADDR, &urgentMsg, sizeof(blacklist_t)) != SUCCESS)
+      urgentDone();
+  }
+
+  event void UrgentSend.sendDone(message_t *msg, error_t error) {
+    if (msg == &urgentMsg)
+      urgentDone();
+  }
+
+  /* Every check interval: update leds, check for low battery 
+     based on current settings */
+  event void Check.fired() 
+  {
+    updateLeds();
+
+    if (sampling.detect & LOW_BATTERY && !call MsgPool.empty())
+    {
+      call BatteryLevel.read();
+    }
+  }
+
+  /* The alert in msg, and sending msg, over the alert transport */
+  alert_t *alertPayload(message_t *msg) {
+#ifdef ALERT_TRANSPORT_CTP
+    return call AlertSend.getPayload(msg, sizeof(alert_t));
+#else
+    return call TheftSend.getPayload(msg, sizeof(alert_t));
+#endif
+  }
+
+  error_t sendAlert(message_t *msg) {
+#ifdef ALERT_TRANSPORT_CTP
+    return call AlertSend.send(msg, sizeof(alert_t));
+#else
+    return call TheftSend.send(AM_BROADCAST_ADDR, msg, sizeof(alert_t));
+#endif
+  }
+
+  error_t cancelAlert(message_t *msg) {
+#ifdef ALERT_TRANSPORT_CTP
+    return call AlertSend.cancel(msg);
+#else
+    return call TheftSend.cancel(msg);
+#endif
+  }
+
+  /********* Draining **********/
+
+  /* Start draining, for a blacklist page or a command (commanded). A
+     drain a command started stays the command's. */
+  void startDrain(bool commanded) {
+    commandedDrain = commanded || (draining && commandedDrain);
+    dbg("AntiTheft", "drain %llu %hhu\n", sim_time(), call AlertQueue.size());
+    draining = TRUE;
+    call DrainTimer.startOneShot(DRAIN_TIMEOUT);
+    post sendTask();
+  }
+
+  void stopDrain() {
+    draining = FALSE;
+    call DrainTimer.stop();
+  }
+
+  /* Everything queued has gone: blacklist ourselves */
+  void drained() {
+    stopDrain();
+    call RadioControl.stop();
+  }
+
+  /* Out of time: drop what has not been sent, and cancel the alert
+     being sent (its sendDone finishes the drain). If the cancel is
+     refused the radio goes off anyway, and stopDone abandons the send. */
+  event void DrainTimer.fired() {
+    message_t *sending = NULL;
+    uint8_t dropped = 0;
+
+    if (!draining)
+      return;
+
+    if (fwdBusy)
+      sending = call AlertQueue.dequeue();
+    while (!call AlertQueue.empty())
+      {
+	call MsgPool.put(call AlertQueue.dequeue());
+	dropped++;
+      }
+    dbg("AntiTheft", "drain-timeout %llu %hhu\n", sim_time(), dropped);
+
+    if (sending == NULL)
+      drained();
+    else
+      {
+	call AlertQueue.enqueue(sending);
+	if (cancelAlert(sending) != SUCCESS)
+	  drained();
+      }
+  }
+
+  /********* Alert paths **********/
+
+  /* path1..path6 are consecutive, path1 is the last hop */
+  nx_uint16_t *alertPath(alert_t *alert) {
+    return &alert->path1;
+  }
+
+  bool onPath(alert_t *alert) {
+    nx_uint16_t *path = alertPath(alert);
+    uint8_t i;
+
+    for (i = 0; i < DEPTH; i++)
+      if (path[i] == TOS_NODE_ID)
+	return TRUE;
+    return FALSE;
+  }
+
+  /* Add this node to the front of the path */
+  void prependToPath(alert_t *alert) {
+    nx_uint16_t *path = alertPath(alert);
+    uint8_t i;
+
+    for (i = DEPTH - 1; i > 0; i--)
+      path[i] = path[i - 1];
+    path[0] = TOS_NODE_ID;
+  }
+
+  /********* Duplicate suppression **********/
+
+  bool forwardedBefore(alert_t *alert) {
+    uint8_t i;
+
+    for (i = 0; i < forwardedCount; i++)
+      if (forwarded[i].stolenId == alert->stolenId &&
+	  forwarded[i].packetId == alert->packetId)
+	return TRUE;
+    return FALSE;
+  }
+
+  void rememberForwarded(alert_t *alert) {
+    if (DUP_CACHE_SIZE == 0)
+      return;
+    forwarded[forwardedNext].stolenId = alert->stolenId;
+    forwarded[forwardedNext].packetId = alert->packetId;
+    if (++forwardedNext == DUP_CACHE_SIZE)
+      forwardedNext = 0;
+    if (forwardedCount < DUP_CACHE_SIZE)
+      forwardedCount++;
+  }
+
+  /********* Sending **********/
+
+  /* Send the alert at the head of AlertQueue. A buffer the radio refuses
+     is dropped, so that one bad send does not hold up the rest. */
+  task void sendTask() {
+    if (fwdBusy)
+      return;
+    if (call AlertQueue.empty())
+      {
+	/* A command acknowledgement, or an urgent flood we are repeating,
+	   goes out before the radio goes off */
+	if (draining && !commandBusy && !urgentBusy)
+	  drained();
+	return;
+      }
+    /* A full queue, or draining, ends the aggregation window early */
+    if (holding && !draining && call AlertQueue.size() < call AlertQueue.maxSize())
+      return;
+
+    if (sendAlert(call AlertQueue.head()) == SUCCESS)
+      {
+	fwdBusy = TRUE;
+	overdue = 0;
+	call SendWatchdog.startOneShot(SEND_TIMEOUT);
+      }
+    else
+      {
+	call MsgPool.put(call AlertQueue.dequeue());
+	post sendTask();
+      }
+  }
+
+  /* If an alert from the same node as the one in msg is held in
+     AlertQueue (and not being sent), overwrite it with msg's */
+  bool aggregate(message_t *msg) {
+    alert_t *alert = alertPayload(msg);
+    uint8_t i;
+
+    for (i = fwdBusy ? 1 : 0; i < call AlertQueue.size(); i++)
+      {
+	alert_t *held = alertPayload(call AlertQueue.element(i));
+
+	if (held->stolenId == alert->stolenId)
+	  {
+	    dbg("AntiTheft", "aggregate %llu %hu %hu %hu\n", sim_time(),
+		held->stolenId, held->packetId, alert->packetId);
+	    *held = *alert;
+	    return TRUE;
+	  }
+      }
+    return FALSE;
+  }
+
+  /* Queue msg, a buffer from MsgPool, for sending. With an aggregation
+     window, the first alert queued while nothing is being sent opens
+     it. */
+  void queueAlert(message_t *msg) {
+    if (AGGREGATION_WINDOW && aggregate(msg))
+      {
+	call MsgPool.put(msg);
+	return;
+      }
+    if (AGGREGATION_WINDOW && !fwdBusy && call AlertQueue.empty())
+      {
+	holding = TRUE;
+	call AggregationTimer.startOneShot(AGGREGATION_WINDOW);
+      }
+    if (call AlertQueue.enqueue(msg) == SUCCESS)
+      post sendTask();
+    else
+      call MsgPool.put(msg);
+  }
+
+  event void AggregationTimer.fired() {
+    holding = FALSE;
+    post sendTask();
+  }
+
+  /* The head of AlertQueue is overdue: cancel it. A cancelled send
+     still completes with sendDone, which recycles the buffer. A refused
+     cancel means the radio stack may still hold the buffer, so the
+     cancel is tried again next time, up to STUCK_LIMIT times. */
+  event void SendWatchdog.fired() {
+    if (!fwdBusy)
+      return;
+
+    stuckSends++;
+    errorLed();
+    dbg("AntiTheft", "stuck %llu %hu\n", sim_time(), stuckSends);
+    if (++overdue >= STUCK_LIMIT)
+      abandonSend();
+    else
+      {
+	cancelAlert(call AlertQueue.head());
+	call SendWatchdog.startOneShot(SEND_TIMEOUT);
+      }
+  }
+
+  /* Give up on the send in progress for good. Its buffer is not put
+     back in MsgPool, where it could be reused while the radio stack
+     still writes to it: a spare takes its place while there is one, and
+     a late sendDone for it is ignored. */
+  void abandonSend() {
+    if (!fwdBusy)
+      return;
+
+    call SendWatchdog.stop();
+    call AlertQueue.dequeue();
+    fwdBusy = FALSE;
+    if (sparesUsed < SPARE_BUFFERS)
+      call MsgPool.put(&spareMsgs[sparesUsed++]);
+    dbg("AntiTheft", "abandon %llu %hhu\n", sim_time(), sparesUsed);
+    post sendTask();
+  }
+
+  /* Send packets to the base node, based on current settings */
+  void blacklist() 
+  {
+    if (alertPolicy() & BROADCAST && !draining) //The "Broadcast" checkbox must be checked to broadcast
+    {				      //a packet through the network.
+	message_t *msg = call MsgPool.get();
+	uint8_t i;
+
+	if(msg != NULL)
+    	{	
+		alert_t *fwdAlert = alertPayload(msg);
+	
+		if(fwdAlert == NULL)
+			call MsgPool.put(msg);
+		else
+		{		
+			//fill in all of the data members of the packet
+			fwdAlert->stolenId = TOS_NODE_ID;
+			fwdAlert->voltageData = currentVolt;
+			fwdAlert->packetId = alertSeqno++;
+			for (i = 1; i < ALERT_PATH_LEN; i++)
+				alertPath(fwdAlert)[i] = NO_HOP;
+			alertPath(fwdAlert)[0] = TOS_NODE_ID;
+			fwdAlert->ignoredId = TOS_NODE_ID;
+			fwdAlert->settingsVersion = settingsVersion;
+
+			call Leds.led1On();
+
+			dbg("AntiTheft", "origin %llu %hu %hu\n", sim_time(),
+			    fwdAlert->stolenId, fwdAlert->packetId);
+			queueAlert(msg);
+		}    
+	}
+	
+    }	
+      
+  }
+
+  /* Battery level reading completed. Check if it's a low battery. */
+  event void BatteryLevel.readDone(error_t ok, uint16_t val)
+  {
+	currentVolt = val;
+	blacklist();
+
+  }
+
+
+
+#ifdef ALERT_TRANSPORT_CTP
+  /* Collection is forwarding an alert through this node: add ourselves
+     to its path, as flooding nodes do. */
+  event bool AlertIntercept.forward(message_t *msg, void *payload, uint8_t len)
+  {
+    alert_t *fwdAlert = payload;
+
+    if (len == sizeof(*fwdAlert))
+      {
+	prependToPath(fwdAlert);
+	dbg("AntiTheft", "relay %llu %hu %hu\n", sim_time(), fwdAlert->stolenId,
+	    fwdAlert->packetId);
+      }
+    return TRUE;
+  }
+#else
+  /* We've received a blacklist packet from a neighbor. Forward it through the network
+     to the base station. */
+
+  event message_t *TheftReceive.receive(message_t* msg, void* payload, uint8_t len) 
+  {
+    alert_t *fwdAlert = payload;
+    message_t *freeMsg;
+
+    if (len != sizeof(*fwdAlert) || draining)
+      return msg;
+
+    //This prevents flooding & cycling.
+    //If this node's ID is in the routing path, it's cycling, so just drop the packet.
+    if (onPath(fwdAlert))
+      return msg;
+
+    /* A copy of this alert came in over another path and went out already */
+    if (forwardedBefore(fwdAlert))
+      {
+	dbg("AntiTheft", "duplicate %llu %hu %hu\n", sim_time(), fwdAlert->stolenId,
+	    fwdAlert->packetId);
+	return msg;
+      }
+
+    /* Keep msg for sending and give the radio stack a pool buffer instead */
+    freeMsg = call MsgPool.get();
+    if (freeMsg == NULL)
+      {
+	dbg("AntiTheft", "busy %llu %hu %hu\n", sim_time(), fwdAlert->stolenId,
+	    fwdAlert->packetId);
+	return msg;
+      }
+
+    //Otherwise, add the current node ID to the front of the route path and send the packet.
+    prependToPath(fwdAlert);
+    rememberForwarded(fwdAlert);
+
+    dbg("AntiTheft", "forward %llu %hu %hu\n", sim_time(),
+	fwdAlert->stolenId, fwdAlert->packetId);
+    queueAlert(msg);
+    return freeMsg;
+  }
+#endif
+  
+  /********* Commands **********/
+
+  nx_uint16_t *commandRoute(command_t *cmd) {
+    return &cmd->route1;
+  }
+
+  void sendCommand() {
+    call CommandAcks.requestAck(&commandMsg);
+    if (call CommandSend.send(commandDest, &commandMsg, sizeof(command_t)) == SUCCESS)
+      commandBusy = TRUE;
+  }
+
+  void runCommand(command_t *cmd) {
+    if (cmd->type == COMMAND_BLACKLIST)
+      {
+	blacklistDuration = cmd->duration;
+	startDrain(TRUE);
+      }
+  }
+
+  /* A command addressed to us as a hop of its route: pass it on, towards
+     the target or, once acknowledged, back towards the root */
+  event message_t *CommandReceive.receive(message_t *msg, void *payload, uint8_t len)
+  {
+    command_t *cmd = payload, *fwd;
+
+    if (len != sizeof(*cmd) || commandBusy || cmd->hops == 0 ||
+	cmd->hops > COMMAND_MAX_HOPS || cmd->hop >= cmd->hops ||
+	commandRoute(cmd)[cmd->hop] != TOS_NODE_ID)
+      return msg;
+
+    fwd = call CommandSend.getPayload(&commandMsg, sizeof(command_t));
+    if (fwd == NULL)
+      return msg;
+    *fwd = *cmd;
+
+    if (!fwd->ack && fwd->hop == fwd->hops - 1)
+      {
+	dbg("AntiTheft", "command %llu %hu %hhu\n", sim_time(), fwd->seqno, fwd->type);
+	runCommand(fwd);
+	fwd->ack = TRUE;
+      }
+    if (!fwd->ack)
+      commandDest = commandRoute(fwd)[++fwd->hop];
+    else if (fwd->hop == 0)
+      commandDest = fwd->rootId;
+    else
+      commandDest = commandRoute(fwd)[--fwd->hop];
+
+    commandRetries = 0;
+    sendCommand();
+    return msg;
+  }
+
+  /* Retry unacknowledged hops; the PC falls back to dissemination if a
+     command is lost for good */
+  event void CommandSend.sendDone(message_t *msg, error_t error)
+  {
+    if (msg != &commandMsg)
+      return;
+
+    commandBusy = FALSE;
+    dbg("AntiTheft", "command-sent %llu %hu %hhu\n", sim_time(), commandDest,
+	error == SUCCESS && call CommandAcks.wasAcked(msg));
+    if ((error != SUCCESS || !call CommandAcks.wasAcked(msg)) &&
+	commandRetries++ < COMMAND_RETRIES)
+      sendCommand();
+    else if (draining)
+      post sendTask();
+  }
+
+  //The packet has been sent, so the node is no longer busy.
+#ifdef ALERT_TRANSPORT_CTP
+  event void AlertSend.sendDone(message_t *msg, error_t error)
+#else
+  event void TheftSend.sendDone(message_t *msg, error_t error)
+#endif
+  {
+	dbg("AntiTheft", "sent %llu %hhu\n", sim_time(), error);
+	if (fwdBusy && call AlertQueue.head() == msg)
+	  {
+	    call SendWatchdog.stop();
+	    call MsgPool.put(call AlertQueue.dequeue());
+	    fwdBusy = FALSE;
+	    post sendTask();
+	  }
+  }
+
+
+}
@@ -0,0 +1,54 @@
+/**
+ * Energy accounting for the AntiTheft node code (see EnergyMeterP).
+ * Wire AntiTheftC's radio control, alert, battery and led interfaces
+ * to this component, and this component's Sub interfaces to the
+ * services AntiTheftC would otherwise use.
+ */
+#include "antitheft.h"
+
+configuration EnergyMeterC
+{
+  provides {
+    interface SplitControl as RadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface AMSend as TheftSend;
+    interface Receive as TheftReceive;
+#endif
+    interface Read<uint16_t> as BatteryLevel;
+    interface Leds;
+  }
+  uses {
+    interface SplitControl as SubRadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface AMSend as SubTheftSend;
+    interface Receive as SubTheftReceive;
+#endif
+    interface Read<uint16_t> as SubBatteryLevel;
+    interface Leds as SubLeds;
+  }
+}
+implementation
+{
+  components EnergyMeterP, LocalTimeMilliC, new TimerMilliC() as ReportTimer,
+    new AMSenderC(AM_ENERGY) as ReportSend;
+
+  RadioControl = EnergyMeterP.RadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+  TheftSend = EnergyMeterP.TheftSend;
+  TheftReceive = EnergyMeterP.TheftReceive;
+#endif
+  BatteryLevel = EnergyMeterP.BatteryLevel;
+  Leds = EnergyMeterP.Leds;
+
+  EnergyMeterP.SubRadioControl = SubRadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+  EnergyMeterP.SubTheftSend = SubTheftSend;
+  EnergyMeterP.SubTheftReceive = SubTheftReceive;
+#endif
+  EnergyMeterP.SubBatteryLevel = SubBatteryLevel;
+  EnergyMeterP.SubLeds = SubLeds;
+
+  EnergyMeterP.LocalTime -> LocalTimeMilliC;
+  EnergyMeterP.ReportTimer -> ReportTimer;
+  EnergyMeterP.ReportSend -> ReportSend;
+}
@@ -0,0 +1,231 @@
+/**
+ * Energy accounting for the AntiTheft node code (ENERGY_ACCOUNTING
+ * builds). Sits between AntiTheftC and the radio, alert, battery sensor
+ * and led services it uses, and keeps track of what draws current: how
+ * long the radio is on, alerts sent and received, battery readings and
+ * led on time. The host side (sim/energy.py) turns these into joules.
+ * Alerts are only counted when they are flooded (ALERT_TRANSPORT=flood):
+ * collection sends and forwards them below AntiTheftC.
+ *
+ * Every ENERGY_REPORT_INTERVAL the totals are broadcast one hop as an
+ * energy_report_t; under TOSSIM they are printed on the AntiTheft debug
+ * channel instead, every SIM_ENERGY_REPORT_INTERVAL.
+ */
+#include "antitheft.h"
+#ifdef TOSSIM
+#include "antitheftsim.h"
+#endif
+
+module EnergyMeterP
+{
+  provides {
+    interface SplitControl as RadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface AMSend as TheftSend;
+    interface Receive as TheftReceive;
+#endif
+    interface Read<uint16_t> as BatteryLevel;
+    interface Leds;
+  }
+  uses {
+    interface SplitControl as SubRadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface AMSend as SubTheftSend;
+    interface Receive as SubTheftReceive;
+#endif
+    interface Read<uint16_t> as SubBatteryLevel;
+    interface Leds as SubLeds;
+    interface LocalTime<TMilli>;
+    interface Timer<TMilli> as ReportTimer;
+    interface AMSend as ReportSend;
+  }
+}
+implementation
+{
+  enum {
+#ifdef TOSSIM
+    REPORT_INTERVAL = SIM_ENERGY_REPORT_INTERVAL
+#else
+    REPORT_INTERVAL = ENERGY_REPORT_INTERVAL
+#endif
+  };
+
+  energy_report_t counts;
+  uint32_t radioOnSince;
+  uint32_t ledOn, ledOnSince[3]; /* led on time, kept apart as Leds is async */
+  uint8_t ledState; /* leds currently on, as in Leds.get() */
+  bool radioOn, reporting, reportBusy;
+  message_t reportMsg;
+
+  uint32_t now() {
+    return call LocalTime.get();
+  }
+
+  /* Total radio and led on time up to now */
+  uint32_t radioOnTime() {
+    return counts.radioOn + (radioOn ? now() - radioOnSince : 0);
+  }
+
+  uint32_t ledOnTime() {
+    uint32_t total;
+    uint8_t i;
+
+    atomic
+      {
+	total = ledOn;
+	for (i = 0; i < 3; i++)
+	  if (ledState & (1 << i))
+	    total += now() - ledOnSince[i];
+      }
+    return total;
+  }
+
+  /* A led changed; charge the ones that were turned off */
+  void ledsChanged() {
+    uint8_t i, state = call SubLeds.get();
+
+    atomic
+      {
+	for (i = 0; i < 3; i++)
+	  {
+	    uint8_t bit = 1 << i;
+
+	    if ((state & bit) && !(ledState & bit))
+	      ledOnSince[i] = now();
+	    else if (!(state & bit) && (ledState & bit))
+	      ledOn += now() - ledOnSince[i];
+	  }
+	ledState = state & 7;
+      }
+  }
+
+  /********* Reports **********/
+
+  event void ReportTimer.fired() {
+    counts.nodeId = TOS_NODE_ID;
+    counts.seqno++;
+    counts.elapsed = now();
+#ifdef TOSSIM
+    dbg("AntiTheft", "energy %llu %lu %lu %hu %hu %hu %lu\n", sim_time(),
+	(unsigned long)counts.elapsed, (unsigned long)radioOnTime(),
+	(uint16_t)counts.txPackets, (uint16_t)counts.rxPackets,
+	(uint16_t)counts.adcReads, (unsigned long)ledOnTime());
+#else
+    if (!reportBusy && radioOn)
+      {
+	energy_report_t *report =
+	  call ReportSend.getPayload(&reportMsg, sizeof(energy_report_t));
+
+	if (report != NULL)
+	  {
+	    *report = counts;
+	    report->radioOn = radioOnTime();
+	    report->ledOn = ledOnTime();
+	    if (call ReportSend.send(AM_BROADCAST_ADDR, &reportMsg, sizeof *report) == SUCCESS)
+	      reportBusy = TRUE;
+	  }
+      }
+#endif
+  }
+
+  event void ReportSend.sendDone(message_t *msg, error_t error) {
+    reportBusy = FALSE;
+  }
+
+  /********* Radio **********/
+
+  command error_t RadioControl.start() {
+    if (!reporting)
+      {
+	reporting = TRUE;
+	call ReportTimer.startPeriodic(REPORT_INTERVAL);
+      }
+    return call SubRadioControl.start();
+  }
+
+  command error_t RadioControl.stop() {
+    return call SubRadioControl.stop();
+  }
+
+  event void SubRadioControl.startDone(error_t error) {
+    if (error == SUCCESS && !radioOn)
+      {
+	radioOn = TRUE;
+	radioOnSince = now();
+      }
+    signal RadioControl.startDone(error);
+  }
+
+  event void SubRadioControl.stopDone(error_t error) {
+    if (error == SUCCESS && radioOn)
+      {
+	radioOn = FALSE;
+	counts.radioOn += now() - radioOnSince;
+      }
+    signal RadioControl.stopDone(error);
+  }
+
+  /********* Alerts **********/
+
+#ifndef ALERT_TRANSPORT_CTP
+  command error_t TheftSend.send(am_addr_t addr, message_t *msg, uint8_t len) {
+    return call SubTheftSend.send(addr, msg, len);
+  }
+
+  command error_t TheftSend.cancel(message_t *msg) {
+    return call SubTheftSend.cancel(msg);
+  }
+
+  command uint8_t TheftSend.maxPayloadLength() {
+    return call SubTheftSend.maxPayloadLength();
+  }
+
+  command void *TheftSend.getPayload(message_t *msg, uint8_t len) {
+    return call SubTheftSend.getPayload(msg, len);
+  }
+
+  event void SubTheftSend.sendDone(message_t *msg, error_t error) {
+    if (error == SUCCESS)
+      counts.txPackets++;
+    signal TheftSend.sendDone(msg, error);
+  }
+
+  event message_t *SubTheftReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    counts.rxPackets++;
+    return signal TheftReceive.receive(msg, payload, len);
+  }
+#endif
+
+  /********* Battery **********/
+
+  command error_t BatteryLevel.read() {
+    return call SubBatteryLevel.read();
+  }
+
+  event void SubBatteryLevel.readDone(error_t result, uint16_t val) {
+    if (result == SUCCESS)
+      counts.adcReads++;
+    signal BatteryLevel.readDone(result, val);
+  }
+
+  /********* Leds **********/
+
+  async command void Leds.led0On() { call SubLeds.led0On(); ledsChanged(); }
+  async command void Leds.led0Off() { call SubLeds.led0Off(); ledsChanged(); }
+  async command void Leds.led0Toggle() { call SubLeds.led0Toggle(); ledsChanged(); }
+  async command void Leds.led1On() { call SubLeds.led1On(); ledsChanged(); }
+  async command void Leds.led1Off() { call SubLeds.led1Off(); ledsChanged(); }
+  async command void Leds.led1Toggle() { call SubLeds.led1Toggle(); ledsChanged(); }
+  async command void Leds.led2On() { call SubLeds.led2On(); ledsChanged(); }
+  async command void Leds.led2Off() { call SubLeds.led2Off(); ledsChanged(); }
+  async command void Leds.led2Toggle() { call SubLeds.led2Toggle(); ledsChanged(); }
+
+  async command uint8_t Leds.get() {
+    return call SubLeds.get();
+  }
+
+  async command void Leds.set(uint8_t val) {
+    call SubLeds.set(val);
+    ledsChanged();
+  }
+}
@@ -0,0 +1,29 @@
+/**
+ * A table too big for one dissemination item, disseminated as four
+ * pages of type t, keys KEY to KEY + 3 (the ..._PAGES constants of
+ * antitheft.h say how many pages a table has). Value[p] and Update[p]
+ * are page p's; the other pages stay as they are when one changes.
+ */
+generic configuration PagedItemsC(typedef t, uint16_t KEY)
+{
+  provides {
+    interface DisseminationValue<t> as Value[uint8_t page];
+    interface DisseminationUpdate<t> as Update[uint8_t page];
+  }
+}
+implementation
+{
+  components new DisseminatorC(t, KEY) as Page0,
+    new DisseminatorC(t, KEY + 1) as Page1,
+    new DisseminatorC(t, KEY + 2) as Page2,
+    new DisseminatorC(t, KEY + 3) as Page3;
+
+  Value[0] = Page0;
+  Value[1] = Page1;
+  Value[2] = Page2;
+  Value[3] = Page3;
+  Update[0] = Page0;
+  Update[1] = Page1;
+  Update[2] = Page2;
+  Update[3] = Page3;
+}
@@ -19,20 +19,98 @@
 #ifndef ANTITHEFT_H
 #define ANTITHEFT_H
 
+/* Tunables that can be changed at compile time (e.g., with
+   CFLAGS += -DANTITHEFT_ROOT_QUEUE_SIZE=16 in the Makefile) */
+#ifndef ANTITHEFT_ROOT_QUEUE_SIZE
+#define ANTITHEFT_ROOT_QUEUE_SIZE 8
+#endif
+#ifndef ANTITHEFT_MSG_POOL_SIZE
+#define ANTITHEFT_MSG_POOL_SIZE 4
+#endif
+#ifndef ANTITHEFT_PATH_DEPTH
+#define ANTITHEFT_PATH_DEPTH 6
+#endif
+#ifndef ANTITHEFT_DUP_CACHE_SIZE
+#define ANTITHEFT_DUP_CACHE_SIZE 0
+#endif
+#ifndef ANTITHEFT_AGGREGATION_WINDOW
+#define ANTITHEFT_AGGREGATION_WINDOW 0
+#endif
+#ifndef ANTITHEFT_LPL_INTERVAL
+#define ANTITHEFT_LPL_INTERVAL 512
+#endif
+
 enum {
   BROADCAST = 4,
 
   LOW_BATTERY = 1,
 
   AM_SETTINGS = 54,
+  AM_URGENT_SETTINGS = 55,
+  AM_PROFILES = 56,
   AM_THEFT = 99,
   AM_ALERT = 22,
-  DIS_SETTINGS = 42,
+  AM_ROOT_STATUS = 23,
+  AM_ENERGY = 24,
+  AM_COMMAND = 25,
+  AM_URGENT = 26,
+  /* Dissemination keys of the parts of the settings, so that changing
+     one does not disturb nodes using the others. Page p of the blacklist
+     (profiles) table has key DIS_BLACKLIST + p (DIS_PROFILES + p). */
+  DIS_SAMPLING = 43,
+  DIS_REPORTING = 44,
+  DIS_BLACKLIST = 45,
+  DIS_PROFILES = 49,
   COL_ALERTS = 11,
 
   DEFAULT_ALERT = BROADCAST,
   DEFAULT_DETECT = LOW_BATTERY,
-  DEFAULT_CHECK_INTERVAL = 1000
+  DEFAULT_CHECK_INTERVAL = 1000,
+
+  /* Largest dissemination item (bytes): DIP sends an item in one data
+     message with room for 16 bytes */
+  DISSEMINATION_ITEM_SIZE = 16,
+
+  /* The blacklist and profiles tables are split into pages of as many
+     entries as fit in one dissemination item; each page is an item of
+     its own (see PagedItemsC) */
+  BLACKLIST_PAGE_SIZE = 2,
+  BLACKLIST_PAGES = 4,
+  /* Nodes the blacklist table lists at once */
+  BLACKLIST_SIZE = BLACKLIST_PAGES * BLACKLIST_PAGE_SIZE,
+  PROFILE_PAGE_SIZE = 2,
+  PROFILE_PAGES = 4,
+  /* Ranges of node IDs the profiles table sets apart */
+  PROFILE_SIZE = PROFILE_PAGES * PROFILE_PAGE_SIZE,
+
+  /* Commands for a single node (command_t types) */
+  COMMAND_BLACKLIST = 1,
+  /* Hops a command can be routed over (route1..route6) */
+  COMMAND_MAX_HOPS = 6,
+  /* Link-layer retransmissions of a command at each hop */
+  COMMAND_RETRIES = 3,
+  /* Time (ms) the PC waits for a command's acknowledgement before it
+     falls back to disseminating the settings */
+  COMMAND_TIMEOUT = 5000,
+
+  /* Number of alerts the root can buffer while the serial port is busy */
+  ROOT_QUEUE_SIZE = ANTITHEFT_ROOT_QUEUE_SIZE,
+  /* Number of message buffers a node shares between the alerts it
+     originates and the alerts it forwards */
+  MSG_POOL_SIZE = ANTITHEFT_MSG_POOL_SIZE,
+  /* Hops of an alert's path a node checks for loops and records (1-6) */
+  PATH_DEPTH = ANTITHEFT_PATH_DEPTH,
+  /* Recently forwarded alerts a node remembers to drop copies (0: none) */
+  DUP_CACHE_SIZE = ANTITHEFT_DUP_CACHE_SIZE,
+  /* Time (ms) a node holds queued alerts to merge those of one origin
+     (0: send at once) */
+  AGGREGATION_WINDOW = ANTITHEFT_AGGREGATION_WINDOW,
+  /* Low-power listening wakeup interval of nodes and root (ms) */
+  LPL_INTERVAL = ANTITHEFT_LPL_INTERVAL,
+  /* Interval at which the root reports its status to the PC */
+  ROOT_STATUS_INTERVAL = 5000,
+  /* Interval at which ENERGY_ACCOUNTING nodes report their energy use */
+  ENERGY_REPORT_INTERVAL = 60000
 };
 
 typedef nx_struct settings {
@@ -40,12 +118,84 @@ typedef nx_struct settings {
   nx_uint16_t checkInterval; //interval for which the nodes check to send packets
   nx_uint16_t targetId; //node we are targeting to be blacklisted
   nx_uint16_t duration; //duration for the target node to be blacklisted
+  nx_uint16_t version; //changed by the PC on every settings push, echoed back in alerts
 } settings_t;
 
+/* The root disseminates the parts of a settings push that changed as
+   separate items, each stamped with the push's version: what nodes
+   check (sampling_t), how they report (reporting_t) and who is
+   blacklisted (blacklist_t). A node echoes the newest version it has
+   received in its alerts. */
+typedef nx_struct sampling {
+  nx_uint8_t detect;
+  nx_uint16_t checkInterval;
+  nx_uint16_t version;
+} sampling_t;
+
+typedef nx_struct reporting {
+  nx_uint8_t alert;
+  nx_uint16_t version;
+} reporting_t;
+
+/* Every dissemination item must fit in DISSEMINATION_ITEM_SIZE bytes
+   (DIP would not carry it); DIP builds check this at compile time. */
+#ifdef DISSEMINATION_DIP
+typedef char sampling_fits_dip[sizeof(sampling_t) <= DISSEMINATION_ITEM_SIZE ? 1 : -1];
+typedef char reporting_fits_dip[sizeof(reporting_t) <= DISSEMINATION_ITEM_SIZE ? 1 : -1];
+#endif
+
+/* One page of the blacklist table, which lists the last BLACKLIST_SIZE
+   nodes blacklisted: who, for how long (ms), and the version of the
+   push that listed them. A node blacklists itself when it finds itself
+   listed by a version newer (in serial number arithmetic) than the last
+   one it acted on, if any; it keeps that version across reboots.
+
+   A push the PC sends as AM_URGENT_SETTINGS rather than AM_SETTINGS is
+   urgent: besides disseminating it, the root floods the page it listed
+   the node in as an AM_URGENT broadcast that every node repeats once on
+   receipt. */
+typedef nx_struct blacklist {
+  nx_uint8_t page;
+  nx_uint16_t target[BLACKLIST_PAGE_SIZE];
+  nx_uint16_t duration[BLACKLIST_PAGE_SIZE];
+  nx_uint16_t version[BLACKLIST_PAGE_SIZE];
+} blacklist_t;
+
+#ifdef DISSEMINATION_DIP
+typedef char blacklist_fits_dip[sizeof(blacklist_t) <= DISSEMINATION_ITEM_SIZE ? 1 : -1];
+#endif
+
+/* One page of the profiles table, which sets sampling and reporting
+   for ranges of node IDs, so that e.g. relays near the root check less
+   often than edge nodes. The table's entries are in increasing order of
+   first ID and run on from page to page: the first count entries of
+   each page are used, and a page that is not full ends the table, as
+   does one whose version differs from page 0's. Entry i covers
+   node IDs first[i] up to the next entry's first ID. A node below the
+   first entry, or whose entry's interval (alert) is 0, uses the
+   network-wide sampling_t (reporting_t). The PC sends the pages in
+   order as AM_PROFILES, and the root disseminates each as it is. */
+typedef nx_struct profiles {
+  nx_uint8_t page;
+  nx_uint8_t count;
+  nx_uint16_t first[PROFILE_PAGE_SIZE];
+  nx_uint16_t interval[PROFILE_PAGE_SIZE];
+  nx_uint8_t alert[PROFILE_PAGE_SIZE];
+  nx_uint16_t version;
+} profiles_t;
+
+#ifdef DISSEMINATION_DIP
+typedef char profiles_fits_dip[sizeof(profiles_t) <= DISSEMINATION_ITEM_SIZE ? 1 : -1];
+#endif
+
+/* PagedItemsC disseminates the pages of both tables, four of each */
+typedef char blacklist_pages_wired[BLACKLIST_PAGES == 4 ? 1 : -1];
+typedef char profile_pages_wired[PROFILE_PAGES == 4 ? 1 : -1];
+
 typedef nx_struct alert {
   nx_uint16_t stolenId;
   nx_uint16_t voltageData; //voltage reading from node
-  nx_uint16_t packetId; //unique ID of each reading so we can separate the individual packets at a later date
+  nx_uint16_t packetId; //per-node sequence number of each reading, so (stolenId, packetId) identifies an alert
   nx_uint16_t path1; //last node routed through (last hop)
   nx_uint16_t path2; //2nd to last node routed through (2nd to last hop) 
   nx_uint16_t path3; //..
@@ -53,6 +203,56 @@ typedef nx_struct alert {
   nx_uint16_t path5; //..
   nx_uint16_t path6; //6th to last node routed through
   nx_uint16_t ignoredId; //any node(s) that the sending node has blacklisted
+  nx_uint16_t settingsVersion; //version of the settings the sending node is running
 } alert_t;
 
+/* Periodic root health report. All counts cover the last reporting
+   interval only, so they can be read directly as rates. */
+typedef nx_struct root_status {
+  nx_uint16_t seqno; //incremented on every report, so the PC can spot lost reports
+  nx_uint16_t interval; //length of the reporting interval (ms)
+  nx_uint16_t received; //alert frames received over the radio
+  nx_uint16_t forwarded; //alert frames successfully sent to the PC
+  nx_uint16_t dropped; //alert frames dropped because the queue was full or the frame was malformed
+  nx_uint16_t sendFailed; //serial sends that were refused or completed with an error
+  nx_uint16_t uartBusy; //time (ms) the serial port spent sending alerts
+  nx_uint8_t queueLen; //alerts waiting for the serial port when the report was built
+  nx_uint8_t maxQueue; //largest queue length seen during the interval
+} root_status_t;
+
+/* A command for a single node, sent by the PC through the root and
+   source routed to the node as unicasts along the reverse of the path
+   recorded in the node's last alert: route1 is the root's neighbour and
+   the target is route[hops - 1]. The target acts on it and returns it
+   along the same route with ack set, and the root passes it to the PC. */
+typedef nx_struct command {
+  nx_uint16_t seqno; //chosen by the PC, to match acknowledgements
+  nx_uint16_t rootId; //filled in by the root, where the acknowledgement goes
+  nx_uint8_t type; //COMMAND_BLACKLIST
+  nx_uint8_t ack; //0 on the way to the target, 1 on the way back
+  nx_uint8_t hops; //route entries in use (1..COMMAND_MAX_HOPS)
+  nx_uint8_t hop; //index of the route entry this copy is addressed to
+  nx_uint16_t duration; //blacklist duration (ms)
+  nx_uint16_t route1; //root's neighbour
+  nx_uint16_t route2; //..
+  nx_uint16_t route3; //..
+  nx_uint16_t route4; //..
+  nx_uint16_t route5; //..
+  nx_uint16_t route6; //..
+} command_t;
+
+/* Energy use of a node built with ENERGY_ACCOUNTING, broadcast to its
+   neighbours every ENERGY_REPORT_INTERVAL. Everything counts from boot,
+   times are in ms. */
+typedef nx_struct energy_report {
+  nx_uint16_t nodeId;
+  nx_uint16_t seqno; //incremented on every report
+  nx_uint32_t elapsed; //time since boot
+  nx_uint32_t radioOn; //time the radio was on
+  nx_uint16_t txPackets; //alerts sent (originated or forwarded)
+  nx_uint16_t rxPackets; //alerts received
+  nx_uint16_t adcReads; //battery readings
+  nx_uint32_t ledOn; //total on time of the three leds
+} energy_report_t;
+
 #endif
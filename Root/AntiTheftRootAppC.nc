@@ -14,8 +14,9 @@
  */
 /**
  * Top-level configuration for root-node code for the AntiTheft demo app.
- * Instantiates the dissemination and collection services, and does all
- * the necessary wiring.
+ * Instantiates the dissemination service and the alert receiver (flooded
+ * alerts, or collection with ALERT_TRANSPORT=ctp), and does all the
+ * necessary wiring.
  *
  * @author David Gay
  */
@@ -28,7 +29,9 @@ implementation
      There is no standard name for the actual radio component, so we use
      #ifdef to get the right one for the current platform. */
   components AntiTheftRootC, MainC, LedsC, ActiveMessageC, SerialActiveMessageC;
-#if defined(PLATFORM_MICA2)
+#if defined(TOSSIM)
+#error "Build the TOSSIM simulation of the AntiTheft application in the sim directory"
+#elif defined(PLATFORM_MICA2)
   components CC1000CsmaRadioC as Radio;
 #elif defined(PLATFORM_MICAZ)
   components CC2420ActiveMessageC as Radio;
@@ -46,22 +49,73 @@ implementation
 
   components DisseminationC;
   AntiTheftRootC.DisseminationControl -> DisseminationC;
-  /* Next, instantiate and wire a disseminator (to send settings) and a
-     serial receiver (to receive settings from the PC) */
-  components new DisseminatorC(settings_t, DIS_SETTINGS),
-    new SerialAMReceiverC(AM_SETTINGS) as SettingsReceiver;
+  /* Next, instantiate and wire the disseminators (one per part of the
+     settings, and one per page of the tables) and a serial receiver (to
+     receive settings from the PC) */
+  components new DisseminatorC(sampling_t, DIS_SAMPLING) as SamplingC,
+    new DisseminatorC(reporting_t, DIS_REPORTING) as ReportingC,
+    new PagedItemsC(blacklist_t, DIS_BLACKLIST) as BlacklistC,
+    new PagedItemsC(profiles_t, DIS_PROFILES) as ProfilesC,
+    new SerialAMReceiverC(AM_SETTINGS) as SettingsReceiver,
+    new SerialAMReceiverC(AM_PROFILES) as ProfilesReceiver;
 
   AntiTheftRootC.SettingsReceive -> SettingsReceiver;
-  AntiTheftRootC.SettingsUpdate -> DisseminatorC;
+  AntiTheftRootC.SamplingUpdate -> SamplingC;
+  AntiTheftRootC.ReportingUpdate -> ReportingC;
+  AntiTheftRootC.BlacklistUpdate -> BlacklistC.Update;
+  AntiTheftRootC.ProfilesReceive -> ProfilesReceiver;
+  AntiTheftRootC.ProfilesUpdate -> ProfilesC.Update;
 
-  /* Finally, instantiate and wire a collector (to receive theft alerts) and
-     a serial sender (to send the alerts to the PC) */
-  components CollectionC, new SerialAMSenderC(AM_ALERT) as AlertsForwarder;
+  /* Urgent settings from the PC, whose blacklist page is also flooded */
+  components new SerialAMReceiverC(AM_URGENT_SETTINGS) as UrgentSettingsReceiver,
+    new AMSenderC(AM_URGENT) as UrgentSender;
+
+  AntiTheftRootC.UrgentSettingsReceive -> UrgentSettingsReceiver;
+  AntiTheftRootC.UrgentSend -> UrgentSender;
+
+  /* Finally, instantiate and wire a receiver for theft alerts (a
+     collector with ALERT_TRANSPORT=ctp) and a serial sender (to send the
+     alerts to the PC) */
+  components new SerialAMSenderC(AM_ALERT) as AlertsForwarder;
 
-  AntiTheftRootC.CollectionControl -> CollectionC;
-  AntiTheftRootC.RootControl -> CollectionC;
   AntiTheftRootC.AlertsForward -> AlertsForwarder;
 
+#ifdef ALERT_TRANSPORT_CTP
+  components CollectionC;
+
+  AntiTheftRootC.CollectionControl -> CollectionC;
+  AntiTheftRootC.RootControl -> CollectionC;
+  AntiTheftRootC.TheftReceive -> CollectionC.Receive[COL_ALERTS];
+#else
   components new AMReceiverC(AM_THEFT) as ReceiveTheft;
   AntiTheftRootC.TheftReceive -> ReceiveTheft;
+#endif
+
+  /* Commands for single nodes: received from the PC and source routed
+     over the radio; their acknowledgements go back to the PC */
+  components new SerialAMReceiverC(AM_COMMAND) as CommandReceiver,
+    new AMSenderC(AM_COMMAND) as SendCommand,
+    new AMReceiverC(AM_COMMAND) as ReceiveCommandAck,
+    new SerialAMSenderC(AM_COMMAND) as CommandForwarder;
+
+  AntiTheftRootC.CommandReceive -> CommandReceiver;
+  AntiTheftRootC.CommandSend -> SendCommand;
+  AntiTheftRootC.CommandAcks -> ActiveMessageC;
+  AntiTheftRootC.CommandAckReceive -> ReceiveCommandAck;
+  AntiTheftRootC.CommandForward -> CommandForwarder;
+
+  /* Buffers for alerts waiting for the serial port */
+  components new PoolC(message_t, ROOT_QUEUE_SIZE) as AlertPool,
+    new QueueC(message_t *, ROOT_QUEUE_SIZE) as AlertQueue;
+
+  AntiTheftRootC.AlertPool -> AlertPool;
+  AntiTheftRootC.AlertQueue -> AlertQueue;
+
+  /* Periodic health reports to the PC */
+  components new SerialAMSenderC(AM_ROOT_STATUS) as StatusForwarder,
+    new TimerMilliC() as StatusTimer, LocalTimeMilliC;
+
+  AntiTheftRootC.StatusSend -> StatusForwarder;
+  AntiTheftRootC.StatusTimer -> StatusTimer;
+  AntiTheftRootC.LocalTime -> LocalTimeMilliC;
 }
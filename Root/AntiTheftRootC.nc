@@ -14,9 +14,15 @@
  */
 /**
  * Root node code for the antitheft demo app, just acts as a bridge with the PC:
- * - disseminates settings received from the PC
- * - acts as a root forthe theft alert collection tree
- * - forwards theft alerts received from the collection tree to the PC
+ * - disseminates the parts of the settings received from the PC that
+ *   changed, and floods the blacklist page of urgent ones
+ * - disseminates the per-node sampling profiles received from the PC
+ * - acts as a root forthe theft alert collection tree (ALERT_TRANSPORT=ctp)
+ * - forwards theft alerts received by flooding or collection to the PC
+ * - source routes commands for single nodes from the PC, and passes
+ *   their acknowledgements back
+ * - periodically reports its own health (traffic counts, queue depth and
+ *   serial port load) to the PC
  *
  * @author David Gay
  */
@@ -28,24 +34,61 @@ module AntiTheftRootC
     interface SplitControl as SerialControl;
     interface SplitControl as RadioControl;
     interface LowPowerListening;
-    interface DisseminationUpdate<settings_t> as SettingsUpdate;
+    interface DisseminationUpdate<sampling_t> as SamplingUpdate;
+    interface DisseminationUpdate<reporting_t> as ReportingUpdate;
+    interface DisseminationUpdate<blacklist_t> as BlacklistUpdate[uint8_t page];
+    interface DisseminationUpdate<profiles_t> as ProfilesUpdate[uint8_t page];
     interface Receive as SettingsReceive;
-    interface StdControl as CollectionControl;
+    interface Receive as UrgentSettingsReceive;
+    interface AMSend as UrgentSend;
+    interface Receive as ProfilesReceive;
     interface StdControl as DisseminationControl;
+#ifdef ALERT_TRANSPORT_CTP
+    interface StdControl as CollectionControl;
     interface RootControl;
+#endif
     interface AMSend as AlertsForward;
     interface Receive as TheftReceive;
+    interface Pool<message_t> as AlertPool;
+    interface Queue<message_t *> as AlertQueue;
+    interface AMSend as StatusSend;
+    interface Timer<TMilli> as StatusTimer;
+    interface LocalTime<TMilli>;
+    interface Receive as CommandReceive;
+    interface AMSend as CommandSend;
+    interface PacketAcknowledgements as CommandAcks;
+    interface Receive as CommandAckReceive;
+    interface AMSend as CommandForward;
 
     interface Leds;
   }
 }
 implementation
 {
+  /* What the nodes were last told; they boot with the defaults */
+  sampling_t sampling;
+  reporting_t reporting;
+  blacklist_t blacklist[BLACKLIST_PAGES];
+  profiles_t profiles[PROFILE_PAGES];
+
+  message_t urgentMsg; /* The blacklist page of the last urgent push */
+  bool urgentBusy;
+
   /* Start the radio and serial ports when booting */
   event void Boot.booted()
   {
+    uint8_t page;
+
+    /* What the nodes boot with */
+    sampling.detect = DEFAULT_DETECT;
+    sampling.checkInterval = DEFAULT_CHECK_INTERVAL;
+    reporting.alert = DEFAULT_ALERT;
+    for (page = 0; page < BLACKLIST_PAGES; page++)
+      blacklist[page].page = page;
+
     call SerialControl.start();
     call RadioControl.start();
+    call StatusTimer.startPeriodic(ROOT_STATUS_INTERVAL);
   }
 
   event void SerialControl.startDone(error_t error) { }
@@ -57,56 +100,333 @@ implementation
        tree */
     if (error == SUCCESS)
       {
-	call LowPowerListening.setLocalWakeupInterval(512);
+	call LowPowerListening.setLocalWakeupInterval(LPL_INTERVAL);
 	call DisseminationControl.start();
+#ifdef ALERT_TRANSPORT_CTP
 	call CollectionControl.start();
 	call RootControl.setRoot();
+#endif
       }
   }
   event void RadioControl.stopDone(error_t error) { }
 
+  /* List target in the blacklist table, in its old entry if it has one,
+     otherwise in a free entry or in place of the oldest. Entry i is
+     entry i % BLACKLIST_PAGE_SIZE of page i / BLACKLIST_PAGE_SIZE.
+     Returns the page changed. */
+  uint8_t addToBlacklist(uint16_t target, uint16_t duration, uint16_t version) {
+    blacklist_t *page, *slotPage = &blacklist[0];
+    uint8_t i, slot = 0;
+
+    for (i = 0; i < BLACKLIST_SIZE; i++)
+      {
+	page = &blacklist[i / BLACKLIST_PAGE_SIZE];
+	if (page->target[i % BLACKLIST_PAGE_SIZE] == target)
+	  {
+	    slotPage = page;
+	    slot = i % BLACKLIST_PAGE_SIZE;
+	    break;
+	  }
+	else if (slotPage->target[slot] != 0 &&
+		 (page->target[i % BLACKLIST_PAGE_SIZE] == 0 ||
+		  (int16_t)(page->version[i % BLACKLIST_PAGE_SIZE] - slotPage->version[slot]) < 0))
+	  {
+	    slotPage = page;
+	    slot = i % BLACKLIST_PAGE_SIZE;
+	  }
+      }
+
+    slotPage->target[slot] = target;
+    slotPage->duration[slot] = duration;
+    slotPage->version[slot] = version;
+    return slotPage->page;
+  }
+
+  /* Broadcast a blacklist page for the nodes to act on before
+     dissemination reaches them. If the last flood is still going out,
+     this push's page only goes out by dissemination. */
+  void floodBlacklist(uint8_t page) {
+    blacklist_t *table = call UrgentSend.getPayload(&urgentMsg, sizeof(blacklist_t));
+
+    if (urgentBusy || table == NULL)
+      return;
+    *table = blacklist[page];
+    if (call UrgentSend.send(AM_BROADCAST_ADDR, &urgentMsg, sizeof *table) == SUCCESS)
+      urgentBusy = TRUE;
+  }
+
+  event void UrgentSend.sendDone(message_t *msg, error_t error) {
+    urgentBusy = FALSE;
+  }
+
   /* When we receive new settings from the serial port, we disseminate
-     them by calling the change command */
+     the parts that changed, so that e.g. a blacklist does not restart
+     every node's check timer. A push that changes nothing still sends
+     its version out with the reporting policy, so the PC sees it
+     converge. targetId 0 blacklists nobody. An urgent push also floods
+     the blacklist page it adds to. */
+  void applySettings(settings_t *newSettings, bool urgent)
+  {
+    bool changed = FALSE;
+    uint8_t page;
+
+    call Leds.led2Toggle();
+    if (newSettings->detect != sampling.detect ||
+	newSettings->checkInterval != sampling.checkInterval)
+      {
+	sampling.detect = newSettings->detect;
+	sampling.checkInterval = newSettings->checkInterval;
+	sampling.version = newSettings->version;
+	call SamplingUpdate.change(&sampling);
+	changed = TRUE;
+      }
+    if (newSettings->targetId != 0)
+      {
+	page = addToBlacklist(newSettings->targetId, newSettings->duration, newSettings->version);
+	call BlacklistUpdate.change[page](&blacklist[page]);
+	if (urgent)
+	  floodBlacklist(page);
+	changed = TRUE;
+      }
+    if (newSettings->alert != reporting.alert || !changed)
+      {
+	reporting.alert = newSettings->alert;
+	reporting.version = newSettings->version;
+	call ReportingUpdate.change(&reporting);
+      }
+  }
+
   event message_t *SettingsReceive.receive(message_t* msg, void* payload, uint8_t len)
   {
-    settings_t *newSettings = payload;
+    if (len == sizeof(settings_t))
+      applySettings(payload, FALSE);
+    return msg;
+  }
+
+  event message_t *UrgentSettingsReceive.receive(message_t* msg, void* payload, uint8_t len)
+  {
+    if (len == sizeof(settings_t))
+      applySettings(payload, TRUE);
+    return msg;
+  }
 
-    if (len == sizeof(*newSettings))
+  /* A profiles page from the PC is disseminated as it is, provided the
+     table's entries stay in increasing order of first ID, as the nodes'
+     binary search expects: within the page, and after the last entry of
+     the previous page, which must be full and of the same version. The
+     PC sends the pages of a table in order. */
+  event message_t *ProfilesReceive.receive(message_t* msg, void* payload, uint8_t len)
+  {
+    profiles_t *page = payload, *previous;
+    uint8_t i;
+
+    if (len != sizeof(*page) || page->page >= PROFILE_PAGES ||
+	page->count > PROFILE_PAGE_SIZE)
+      return msg;
+    for (i = 1; i < page->count; i++)
+      if (page->first[i] <= page->first[i - 1])
+	return msg;
+    if (page->page > 0)
       {
-	call Leds.led2Toggle();
-	call SettingsUpdate.change(newSettings);
+	previous = &profiles[page->page - 1];
+	if (previous->version != page->version || previous->count != PROFILE_PAGE_SIZE ||
+	    (page->count > 0 && page->first[0] <= previous->first[PROFILE_PAGE_SIZE - 1]))
+	  return msg;
       }
+
+    call Leds.led2Toggle();
+    profiles[page->page] = *page;
+    call ProfilesUpdate.change[page->page](page);
     return msg;
   }
 
-  message_t fwdMsg;
+  default command void BlacklistUpdate.change[uint8_t page](blacklist_t *newVal) { }
+  default command void ProfilesUpdate.change[uint8_t page](profiles_t *newVal) { }
+
+  /* Alerts waiting for the serial port. Received radio buffers are queued
+     as is and replaced by a buffer from AlertPool, so a burst of alerts
+     does not get dropped just because the serial port is still busy with
+     the previous one. */
   bool fwdBusy; /* Indicates whether or not the base node is forwarding a packet */
+  uint32_t fwdStart; /* When the current serial send started */
+
+  /* Health counters for the current reporting interval */
+  uint16_t statusSeqno, received, forwarded, dropped, sendFailed;
+  uint32_t uartBusy;
+  uint8_t maxQueue;
+
+  message_t statusMsg;
+  bool statusBusy;
+
+  void noteQueueLength() {
+    uint8_t len = call AlertQueue.size();
+
+    if (len > maxQueue)
+      maxQueue = len;
+  }
+
+  /* Send the alert at the head of the queue to the PC */
+  task void forwardTask() {
+    message_t *msg;
+
+    if (fwdBusy || call AlertQueue.empty())
+      return;
+
+    msg = call AlertQueue.head();
+    fwdStart = call LocalTime.get();
+    if (call AlertsForward.send(AM_BROADCAST_ADDR, msg, sizeof(alert_t)) == SUCCESS)
+      fwdBusy = TRUE;
+    else
+      {
+	/* Give up on this alert rather than retrying it forever */
+	sendFailed++;
+	call AlertPool.put(call AlertQueue.dequeue());
+	post forwardTask();
+      }
+  }
 
   /* The node is done sending the message, so it is no longer busy. */
   event void AlertsForward.sendDone(message_t *msg, error_t error) {
-    if (msg == &fwdMsg)
-      fwdBusy = FALSE;
+    if (msg != call AlertQueue.head())
+      return;
+
+    uartBusy += call LocalTime.get() - fwdStart;
+    if (error == SUCCESS)
+      forwarded++;
+    else
+      sendFailed++;
+    call AlertPool.put(call AlertQueue.dequeue());
+    fwdBusy = FALSE;
+    post forwardTask();
   }
 
-  /* The root node has received a blacklist packet from a node. Forward it
-     to the serial port. */
+  /* The root node has received a blacklist packet from a node. Queue it
+     for the serial port, handing the radio stack a fresh buffer. */
   event message_t *TheftReceive.receive(message_t* msg, void* payload, uint8_t len)
   {
-    alert_t *newAlert = payload;
+    message_t *newMsg;
 
     call Leds.led0Toggle();
+    received++;
 
-    if (len == sizeof(*newAlert) && !fwdBusy)
+    if (len != sizeof(alert_t) || call AlertPool.empty())
       {
-	/* Copy payload (newAlert) from collection system to our serial
-	   message buffer (fwdAlert), then send our serial message */
-	alert_t *fwdAlert = call AlertsForward.getPayload(&fwdMsg, sizeof(alert_t));
-	if (fwdAlert != NULL) {
-	  *fwdAlert = *newAlert;
-	  if (call AlertsForward.send(AM_BROADCAST_ADDR, &fwdMsg, sizeof *fwdAlert) == SUCCESS)
-	    fwdBusy = TRUE;
-	}
+	dropped++;
+	return msg;
       }
+
+    /* The alert follows the collection header in a CTP packet; move it
+       to where the serial port sends it from */
+    memmove(call AlertsForward.getPayload(msg, sizeof(alert_t)), payload, sizeof(alert_t));
+    newMsg = call AlertPool.get();
+    call AlertQueue.enqueue(msg);
+    noteQueueLength();
+    post forwardTask();
+
+    return newMsg;
+  }
+
+  /* Commands for single nodes. The PC gives the route to the target;
+     the root sends the command to its first hop and passes the target's
+     acknowledgement back to the PC. */
+  message_t commandMsg, commandAckMsg;
+  bool commandBusy, commandAckBusy;
+  uint8_t commandRetries;
+
+  void sendCommand() {
+    command_t *cmd = call CommandSend.getPayload(&commandMsg, sizeof(command_t));
+
+    call CommandAcks.requestAck(&commandMsg);
+    if (call CommandSend.send(cmd->route1, &commandMsg, sizeof(command_t)) == SUCCESS)
+      commandBusy = TRUE;
+  }
+
+  event message_t *CommandReceive.receive(message_t* msg, void* payload, uint8_t len)
+  {
+    command_t *newCmd = payload, *cmd;
+
+    if (len != sizeof(*newCmd) || commandBusy ||
+	newCmd->hops == 0 || newCmd->hops > COMMAND_MAX_HOPS)
+      return msg;
+
+    cmd = call CommandSend.getPayload(&commandMsg, sizeof(command_t));
+    if (cmd == NULL)
+      return msg;
+    *cmd = *newCmd;
+    cmd->rootId = TOS_NODE_ID;
+    cmd->ack = FALSE;
+    cmd->hop = 0;
+
+    call Leds.led2Toggle();
+    commandRetries = 0;
+    sendCommand();
     return msg;
   }
+
+  event void CommandSend.sendDone(message_t *msg, error_t error) {
+    if (msg != &commandMsg)
+      return;
+
+    commandBusy = FALSE;
+    if ((error != SUCCESS || !call CommandAcks.wasAcked(msg)) &&
+	commandRetries++ < COMMAND_RETRIES)
+      sendCommand();
+  }
+
+  /* An acknowledgement made it back: tell the PC */
+  event message_t *CommandAckReceive.receive(message_t* msg, void* payload, uint8_t len)
+  {
+    command_t *ack = payload, *fwd;
+
+    if (len != sizeof(*ack) || !ack->ack || commandAckBusy)
+      return msg;
+
+    fwd = call CommandForward.getPayload(&commandAckMsg, sizeof(command_t));
+    if (fwd == NULL)
+      return msg;
+    *fwd = *ack;
+    if (call CommandForward.send(AM_BROADCAST_ADDR, &commandAckMsg, sizeof *fwd) == SUCCESS)
+      commandAckBusy = TRUE;
+    return msg;
+  }
+
+  event void CommandForward.sendDone(message_t *msg, error_t error) {
+    if (msg == &commandAckMsg)
+      commandAckBusy = FALSE;
+  }
+
+  /* Every ROOT_STATUS_INTERVAL, tell the PC how well we are keeping up
+     and start a new reporting interval. */
+  event void StatusTimer.fired() {
+    root_status_t *status;
+
+    if (statusBusy)
+      return;
+
+    status = call StatusSend.getPayload(&statusMsg, sizeof(root_status_t));
+    if (status == NULL)
+      return;
+
+    status->seqno = statusSeqno++;
+    status->interval = ROOT_STATUS_INTERVAL;
+    status->received = received;
+    status->forwarded = forwarded;
+    status->dropped = dropped;
+    status->sendFailed = sendFailed;
+    status->uartBusy = uartBusy;
+    status->queueLen = call AlertQueue.size();
+    status->maxQueue = maxQueue;
+
+    if (call StatusSend.send(AM_BROADCAST_ADDR, &statusMsg, sizeof *status) == SUCCESS)
+      statusBusy = TRUE;
+
+    received = forwarded = dropped = sendFailed = 0;
+    uartBusy = 0;
+    maxQueue = call AlertQueue.size();
+  }
+
+  event void StatusSend.sendDone(message_t *msg, error_t error) {
+    if (msg == &statusMsg)
+      statusBusy = FALSE;
+  }
 }
@@ -0,0 +1,607 @@
+/**
+ * Headless ingestion daemon for the AntiTheft root. Reads the root's
+ * serial stream (directly or through a SerialForwarder) and appends every
+ * theft alert, and optionally every root status report, to CSV files.
+ *
+ * Frames are decoded in place from the source's receive buffer and
+ * formatted into a large output buffer, so ingestion costs no allocation
+ * per alert and keeps up with whatever rate the serial port can deliver.
+ *
+ * Usage: alertd [-c source] [-o alerts.csv] [-s status.csv] [-a archive]
+ *               [-g topology.dot] [-b analysis.csv] [-r reputation.csv]
+ *               [-B] [-i interval] [-T threshold] [-D duration] [-p depth]
+ *   source defaults to $MOTECOM, then sf@localhost:9002
+ *   alerts go to stdout unless -o is given
+ *   -a also appends alerts to a binary archive (see archive.h), which
+ *   alertscan can query. Alerts that cannot be written are kept and
+ *   retried until the buffer fills; write errors go to stderr
+ *   -g maintains the link graph reconstructed from alert paths and
+ *   rewrites it as a Graphviz file every REPORT_INTERVAL ms
+ *   -b likewise rewrites the relay load, centrality and cut-node
+ *   analysis of that graph (see analysis.h)
+ *   -r likewise rewrites each node's forwarding reputation (see
+ *   reputation.h); recommended blacklists are logged to stderr
+ *   -B issues the recommended blacklists automatically, one per
+ *   REPORT_INTERVAL and never for a node whose blacklisting would cut
+ *   others off; -i sets the check interval sent with them. A blacklist
+ *   is sent to its target as a command along the route of the node's
+ *   latest alert, and pushed as urgent settings instead (disseminated,
+ *   and flooded by the root) if no route is known or the command is not
+ *   acknowledged within COMMAND_TIMEOUT; the report written on exit
+ *   recommends and sends nothing
+ *   -T, -D set the reputation threshold and the blacklist duration (ms)
+ *   of a node just below it, e.g. as computed by forwardsolve
+ *   -p is the PATH_DEPTH the nodes were built with (default 6)
+ */
+#include "packetsource.h"
+#include "antitheft_codec.h"
+#include "archive.h"
+#include "topology.h"
+#include "analysis.h"
+#include "reputation.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace antitheft;
+
+namespace {
+
+enum {
+  /* Write output once this much is buffered, and every FLUSH_INTERVAL ms */
+  OUTPUT_BUFFER = 64 * 1024,
+  FLUSH_INTERVAL = 1000,
+
+  /* Interval for rewriting derived reports, and for automatic blacklists */
+  REPORT_INTERVAL = 10000
+};
+
+volatile sig_atomic_t stopping;
+
+void stop(int)
+{
+  stopping = 1;
+}
+
+/* SIGALRM only needs to interrupt the read so buffered output is flushed */
+void wakeup(int)
+{
+}
+
+uint64_t nowMs()
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/* A CSV file written through a large buffer. Fields are formatted by
+   hand rather than with printf, as that dominates the cost of ingesting
+   an alert. */
+class CsvWriter
+{
+ public:
+  CsvWriter(FILE *out) : out(out), len(0), lineStart(0) { }
+  ~CsvWriter() { flush(); }
+
+  void field(uint64_t v)
+  {
+    char digits[20];
+    int n = 0;
+
+    if (len != lineStart)
+      buf[len++] = ',';
+    do
+      digits[n++] = '0' + v % 10;
+    while (v /= 10);
+    while (n)
+      buf[len++] = digits[--n];
+  }
+
+  void header(const char *names)
+  {
+    size_t n = strlen(names);
+
+    memcpy(buf + len, names, n);
+    len += n;
+    endRecord();
+  }
+
+  void endRecord()
+  {
+    buf[len++] = '\n';
+    lineStart = len;
+    if (len > OUTPUT_BUFFER - MAX_RECORD)
+      flush();
+  }
+
+  void flush()
+  {
+    if (len)
+      fwrite(buf, 1, len, out);
+    fflush(out);
+    len = lineStart = 0;
+  }
+
+ private:
+  enum { MAX_RECORD = 512 };
+
+  FILE *out;
+  char buf[OUTPUT_BUFFER];
+  size_t len, lineStart;
+};
+
+void writeAlert(CsvWriter &csv, uint64_t time, uint16_t root, const uint8_t *payload)
+{
+  AlertMsg a = AlertMsg::decode(payload);
+
+  csv.field(time);
+  csv.field(root);
+  csv.field(a.stolenId);
+  csv.field(a.voltageData);
+  csv.field(a.packetId);
+  csv.field(a.path1);
+  csv.field(a.path2);
+  csv.field(a.path3);
+  csv.field(a.path4);
+  csv.field(a.path5);
+  csv.field(a.path6);
+  csv.field(a.ignoredId);
+  csv.field(a.settingsVersion);
+  csv.endRecord();
+}
+
+void writeStatus(CsvWriter &csv, uint64_t time, const uint8_t *payload)
+{
+  RootStatusMsg s = RootStatusMsg::decode(payload);
+
+  csv.field(time);
+  csv.field(s.seqno);
+  csv.field(s.interval);
+  csv.field(s.received);
+  csv.field(s.forwarded);
+  csv.field(s.dropped);
+  csv.field(s.sendFailed);
+  csv.field(s.uartBusy);
+  csv.field(s.queueLen);
+  csv.field(s.maxQueue);
+  csv.endRecord();
+}
+
+FILE *openOutput(const char *name)
+{
+  FILE *f = fopen(name, "a");
+
+  if (!f)
+    {
+      perror(name);
+      exit(1);
+    }
+  return f;
+}
+
+/* Replace file with the output of write, atomically so that viewers
+   never see a half-written file */
+template <class F>
+void replaceFile(const char *file, F write)
+{
+  std::string tmp = std::string(file) + ".tmp";
+  FILE *out = fopen(tmp.c_str(), "w");
+
+  if (!out)
+    {
+      perror(tmp.c_str());
+      return;
+    }
+  write(out);
+  if (fclose(out) == 0)
+    rename(tmp.c_str(), file);
+}
+
+/* Everything alertd derives from the alert paths: topology, bottleneck
+   analysis and forwarding reputation, with the files they are reported
+   in and the optional automatic blacklisting of defecting nodes */
+class PathAnalyses
+{
+ public:
+  const char *topologyFile, *analysisFile, *reputationFile;
+  bool autoBlacklist;
+  uint16_t checkInterval;	/* for the settings of automatic blacklists */
+
+  PathAnalyses() : topologyFile(NULL), analysisFile(NULL), reputationFile(NULL),
+		   autoBlacklist(false), checkInterval(DEFAULT_CHECK_INTERVAL),
+		   reputation(topology), lastReport(0),
+		   settingsVersion(time(NULL) & 0xffff), commandSeqno(settingsVersion),
+		   commandPending(false) { }
+
+  bool needTopology() const
+  {
+    return topologyFile || analysisFile || reputationFile || autoBlacklist;
+  }
+
+  /* Cut nodes are needed to avoid blacklists that partition the network */
+  bool needAnalysis() const { return analysisFile || autoBlacklist; }
+
+  bool needReputation() const { return reputationFile || autoBlacklist; }
+
+  void setPolicy(double threshold, uint16_t duration)
+  {
+    reputation.setPolicy(threshold, duration);
+  }
+
+  void setPathDepth(int depth)
+  {
+    topology.setPathDepth(depth);
+    analysis.setPathDepth(depth);
+  }
+
+  void addAlert(const AlertRecord &record)
+  {
+    if (needTopology())
+      topology.addAlert(record);
+    if (needAnalysis())
+      analysis.addAlert(record);
+    if (needReputation())
+      reputation.addAlert(record);
+    if (autoBlacklist)
+      learnRoutes(record);
+  }
+
+  /* A command acknowledgement from the root */
+  void commandAck(const uint8_t *payload)
+  {
+    CommandMsg ack = CommandMsg::decode(payload);
+
+    if (commandPending && ack.ack && ack.seqno == pending.seqno)
+      {
+	commandPending = false;
+	fprintf(stderr, "alertd: node %u acknowledged blacklist command %u\n",
+		pending.node, pending.seqno);
+      }
+  }
+
+  /* Called every FLUSH_INTERVAL; does its work every REPORT_INTERVAL */
+  void tick(uint64_t now, PacketSource *source)
+  {
+    if (commandPending && now - pending.sent >= COMMAND_TIMEOUT)
+      {
+	commandPending = false;
+	fprintf(stderr, "alertd: blacklist command %u not acknowledged, "
+		"disseminating it\n", pending.seqno);
+	sendSettings(source, pending.node, pending.duration);
+      }
+    if (!needTopology() || now - lastReport < REPORT_INTERVAL)
+      return;
+    lastReport = now;
+    report(now, source);
+  }
+
+  void report(uint64_t now, PacketSource *source)
+  {
+    writeGraphs();
+    if (needReputation())
+      recommend(now, source);
+  }
+
+  /* The report at exit only rewrites the files: a blacklist sent now
+     could never be acknowledged or retried, and would outlive alertd */
+  void finalReport(uint64_t now)
+  {
+    writeGraphs();
+    if (reputationFile)
+      {
+	reputation.expire(now);
+	replaceFile(reputationFile, [this](FILE *out) { reputation.writeCsv(out); });
+      }
+  }
+
+ private:
+  Topology topology;
+  NetworkAnalysis analysis;
+  Reputation reputation;
+  uint64_t lastReport;
+  uint16_t settingsVersion;
+  std::set<uint16_t> recommended;
+
+  void writeGraphs()
+  {
+    if (topologyFile)
+      replaceFile(topologyFile, [this](FILE *out) { topology.writeDot(out); });
+    if (needAnalysis())
+      analysis.refresh(topology);
+    if (analysisFile)
+      replaceFile(analysisFile, [this](FILE *out) { analysis.writeCsv(out); });
+  }
+
+  /* Route to each node on an alert path, starting with the root's
+     neighbour, and the blacklist command awaiting acknowledgement */
+  std::map<uint16_t, std::vector<uint16_t> > routes;
+  uint16_t commandSeqno;
+  bool commandPending;
+  struct
+  {
+    uint16_t seqno, node, duration;
+    uint64_t sent;
+  } pending;
+
+  void learnRoutes(const AlertRecord &record)
+  {
+    for (int i = 0; i < topology.pathDepth(); i++)
+      {
+	if (record.path[i] == ARCHIVE_NO_NODE || record.path[i] == record.root)
+	  break;
+	routes[record.path[i]].assign(record.path, record.path + i + 1);
+      }
+  }
+
+  void recommend(uint64_t now, PacketSource *source)
+  {
+    std::vector<Recommendation> recs;
+    std::set<uint16_t> current;
+
+    reputation.expire(now);
+    recs = reputation.recommend(now, needAnalysis() ? &analysis : NULL);
+    for (size_t i = 0; i < recs.size(); i++)
+      {
+	current.insert(recs[i].node);
+	if (!recommended.count(recs[i].node))
+	  fprintf(stderr, "alertd: recommend blacklisting node %u for %u ms "
+		  "(score %.2f, would cut off %lu nodes)\n", recs[i].node,
+		  recs[i].duration, recs[i].score, (unsigned long)recs[i].cutsOff);
+      }
+    recommended.swap(current);
+
+    /* At most one automatic blacklist per report: the blacklist table
+       only lists the last BLACKLIST_SIZE nodes, and every push restarts
+       the dissemination of a page of it */
+    for (size_t i = 0; autoBlacklist && i < recs.size(); i++)
+      if (recs[i].cutsOff == 0)
+	{
+	  if (!commandPending && sendBlacklist(source, recs[i].node, recs[i].duration, now))
+	    reputation.blacklisted(recs[i].node, now + recs[i].duration);
+	  break;
+	}
+
+    if (reputationFile)
+      replaceFile(reputationFile, [this](FILE *out) { reputation.writeCsv(out); });
+  }
+
+  /* Blacklist node by command if we know a route to it, otherwise by
+     disseminating settings that target it */
+  bool sendBlacklist(PacketSource *source, uint16_t node, uint16_t duration, uint64_t now)
+  {
+    std::map<uint16_t, std::vector<uint16_t> >::const_iterator route = routes.find(node);
+
+    if (route == routes.end())
+      return sendSettings(source, node, duration);
+
+    CommandMsg command;
+    uint8_t payload[CommandMsg::SIZE], packet[PACKET_MTU];
+    uint16_t hops[6] = { 0, 0, 0, 0, 0, 0 };
+
+    std::copy(route->second.begin(), route->second.end(), hops);
+    command.seqno = ++commandSeqno;
+    command.rootId = 0;		/* filled in by the root */
+    command.type = COMMAND_BLACKLIST;
+    command.ack = 0;
+    command.hops = route->second.size();
+    command.hop = 0;
+    command.duration = duration;
+    command.route1 = hops[0];
+    command.route2 = hops[1];
+    command.route3 = hops[2];
+    command.route4 = hops[3];
+    command.route5 = hops[4];
+    command.route6 = hops[5];
+    command.encode(payload);
+
+    if (!source->writePacket(packet, buildAmPacket(packet, 0xffff, 0, CommandMsg::AM_TYPE,
+						   payload, sizeof payload)))
+      return false;
+    commandPending = true;
+    pending.seqno = command.seqno;
+    pending.node = node;
+    pending.duration = duration;
+    pending.sent = now;
+    fprintf(stderr, "alertd: blacklisted node %u for %u ms (command %u over %u hops)\n",
+	    node, duration, command.seqno, command.hops);
+    return true;
+  }
+
+  /* Blacklists are urgent: the root floods them ahead of dissemination */
+  bool sendSettings(PacketSource *source, uint16_t node, uint16_t duration)
+  {
+    SettingsMsg settings;
+    uint8_t payload[SettingsMsg::SIZE], packet[PACKET_MTU];
+
+    settings.alert = DEFAULT_ALERT;
+    settings.detect = DEFAULT_DETECT;
+    settings.checkInterval = checkInterval;
+    settings.targetId = node;
+    settings.duration = duration;
+    settings.version = ++settingsVersion;
+    settings.encode(payload);
+
+    if (!source->writePacket(packet, buildAmPacket(packet, 0xffff, 0, AM_URGENT_SETTINGS,
+						   payload, sizeof payload)))
+      return false;
+    fprintf(stderr, "alertd: blacklisted node %u for %u ms (settings version %u)\n",
+	    node, duration, settingsVersion);
+    return true;
+  }
+};
+
+void usage()
+{
+  fprintf(stderr, "Usage: alertd [-c source] [-o alerts.csv] [-s status.csv] "
+	  "[-a archive]\n              [-g topology.dot] [-b analysis.csv] "
+	  "[-r reputation.csv] [-B] [-i interval]\n"
+	  "              [-T threshold] [-D duration] [-p depth]\n");
+  exit(2);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  const char *spec = getenv("MOTECOM");
+  FILE *alertFile = stdout, *statusFile = NULL;
+  unsigned long alerts = 0, reports = 0, ignored = 0, unarchived = 0;
+  std::string error;
+  PacketSource *source;
+  ArchiveWriter archive;
+  bool archiving = false, archiveFailing = false;
+  double threshold = REPUTATION_THRESHOLD;
+  uint16_t duration = REPUTATION_BASE_DURATION;
+  int depth = PATH_DEPTH;
+  PathAnalyses paths;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "c:o:s:a:g:b:r:Bi:T:D:p:")) != -1)
+    switch (opt)
+      {
+      case 'c': spec = optarg; break;
+      case 'o': alertFile = openOutput(optarg); break;
+      case 's': statusFile = openOutput(optarg); break;
+      case 'a':
+	if (!archive.open(optarg, error))
+	  {
+	    fprintf(stderr, "alertd: %s\n", error.c_str());
+	    return 1;
+	  }
+	archiving = true;
+	break;
+      case 'g': paths.topologyFile = optarg; break;
+      case 'b': paths.analysisFile = optarg; break;
+      case 'r': paths.reputationFile = optarg; break;
+      case 'B': paths.autoBlacklist = true; break;
+      case 'i': paths.checkInterval = atoi(optarg); break;
+      case 'T': threshold = atof(optarg); break;
+      case 'D': duration = atoi(optarg); break;
+      case 'p': depth = atoi(optarg); break;
+      default: usage();
+      }
+  if (optind != argc || threshold <= 0 || threshold >= 1 || duration == 0 ||
+      depth < 1 || depth > 6)
+    usage();
+  paths.setPolicy(threshold, duration);
+  paths.setPathDepth(depth);
+  if (!spec)
+    spec = "sf@localhost:9002";
+
+  source = openPacketSource(spec, error);
+  if (!source)
+    {
+      fprintf(stderr, "alertd: %s\n", error.c_str());
+      return 1;
+    }
+
+  /* No SA_RESTART, so signals interrupt the blocking read */
+  struct sigaction sa;
+  memset(&sa, 0, sizeof sa);
+  sa.sa_handler = stop;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sa.sa_handler = wakeup;
+  sigaction(SIGALRM, &sa, NULL);
+
+  struct itimerval flushTimer;
+  flushTimer.it_interval.tv_sec = FLUSH_INTERVAL / 1000;
+  flushTimer.it_interval.tv_usec = FLUSH_INTERVAL % 1000 * 1000;
+  flushTimer.it_value = flushTimer.it_interval;
+  setitimer(ITIMER_REAL, &flushTimer, NULL);
+
+  CsvWriter *alertCsv = new CsvWriter(alertFile), *statusCsv = NULL;
+  if (ftell(alertFile) <= 0)
+    alertCsv->header("time,root,stolenId,voltageData,packetId,path1,path2,path3,"
+		     "path4,path5,path6,ignoredId,settingsVersion");
+  if (statusFile)
+    {
+      statusCsv = new CsvWriter(statusFile);
+      if (ftell(statusFile) <= 0)
+	statusCsv->header("time,seqno,interval,received,forwarded,dropped,"
+			  "sendFailed,uartBusy,queueLen,maxQueue");
+    }
+
+  while (!stopping)
+    {
+      const uint8_t *packet, *payload;
+      uint8_t len;
+      int n = source->readPacket(packet);
+
+      if (n < 0 && errno == EINTR)
+	{
+	  alertCsv->flush();
+	  if (statusCsv)
+	    statusCsv->flush();
+	  if (archiving)
+	    {
+	      bool flushed = archive.flush();
+
+	      if (!flushed && !archiveFailing)
+		fprintf(stderr, "alertd: %s, retrying\n", archive.error().c_str());
+	      else if (flushed && archiveFailing)
+		fprintf(stderr, "alertd: archive written again\n");
+	      archiveFailing = !flushed;
+	    }
+	  paths.tick(nowMs(), source);
+	  continue;
+	}
+      if (n < 0)
+	{
+	  fprintf(stderr, "alertd: %s: connection lost\n", spec);
+	  break;
+	}
+
+      payload = amPayload(packet, n, len);
+      if (payload && amType(packet) == AlertMsg::AM_TYPE && len == AlertMsg::SIZE)
+	{
+	  uint64_t now = nowMs();
+	  AlertRecord record = AlertRecord::fromMsg(now, amSource(packet),
+						    AlertMsg::decode(payload));
+
+	  writeAlert(*alertCsv, now, amSource(packet), payload);
+	  if (archiving && !archive.append(record))
+	    unarchived++;
+	  paths.addAlert(record);
+	  alerts++;
+	}
+      else if (payload && amType(packet) == RootStatusMsg::AM_TYPE &&
+	       len == RootStatusMsg::SIZE)
+	{
+	  if (statusCsv)
+	    writeStatus(*statusCsv, nowMs(), payload);
+	  reports++;
+	}
+      else if (payload && amType(packet) == CommandMsg::AM_TYPE && len == CommandMsg::SIZE)
+	paths.commandAck(payload);
+      else
+	ignored++;
+    }
+
+  delete alertCsv;
+  delete statusCsv;
+  if (archiving && !archive.flush())
+    fprintf(stderr, "alertd: %s, buffered alerts lost\n", archive.error().c_str());
+  archive.close();
+  if (paths.needTopology())
+    paths.finalReport(nowMs());
+  fprintf(stderr, "alertd: %lu alerts, %lu status reports, %lu other packets, "
+	  "%lu bad frames\n", alerts, reports, ignored, source->badFrames);
+  if (unarchived)
+    fprintf(stderr, "alertd: %lu alerts dropped from the archive\n", unarchived);
+  delete source;
+
+  return 0;
+}
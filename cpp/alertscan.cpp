@@ -0,0 +1,105 @@
+/**
+ * Query an alert archive written by alertd -a.
+ *
+ * Usage: alertscan [-f from] [-t to] [-n node] [-p depth] [-c | -g | -l | -b] archive
+ *   -f, -t  only alerts received in [from, to] (ms since the epoch)
+ *   -n      only alerts originated or relayed by node
+ *   -p      PATH_DEPTH the nodes were built with (default 6), to tell
+ *           short paths from ones whose origin was shifted out
+ *   -c      print the number of matching alerts instead of the alerts
+ *   -g, -l  print the links used by the matching alerts, as a Graphviz
+ *           digraph (-g) or a CSV link list (-l), instead of the alerts
+ *   -b      print the per-node relay load, centrality and cut-node
+ *           analysis of the links used by the matching alerts
+ */
+#include "archive.h"
+#include "topology.h"
+#include "analysis.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+void usage()
+{
+  fprintf(stderr, "Usage: alertscan [-f from] [-t to] [-n node] [-p depth] "
+	  "[-c | -g | -l | -b] archive\n");
+  exit(2);
+}
+
+void printRecord(const AlertRecord &r)
+{
+  printf("%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+	 (unsigned long long)r.time, r.root, r.origin, r.voltage, r.seq,
+	 r.path[0], r.path[1], r.path[2], r.path[3], r.path[4], r.path[5],
+	 r.ignoredId, r.settingsVersion);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  uint64_t from = 0, to = UINT64_MAX;
+  int node = -1, depth = antitheft::PATH_DEPTH, opt;
+  bool countOnly = false;
+  char links = 0;
+  Topology topology;
+  NetworkAnalysis analysis;
+  ArchiveReader archive;
+  std::string error;
+  size_t found;
+
+  while ((opt = getopt(argc, argv, "f:t:n:p:cglb")) != -1)
+    switch (opt)
+      {
+      case 'f': from = strtoull(optarg, NULL, 0); break;
+      case 't': to = strtoull(optarg, NULL, 0); break;
+      case 'n': node = atoi(optarg); break;
+      case 'p': depth = atoi(optarg); break;
+      case 'c': countOnly = true; break;
+      case 'g': case 'l': case 'b': links = opt; break;
+      default: usage();
+      }
+  if (optind != argc - 1 || depth < 1 || depth > 6)
+    usage();
+  topology.setPathDepth(depth);
+  analysis.setPathDepth(depth);
+
+  if (!archive.open(argv[optind], error))
+    {
+      fprintf(stderr, "alertscan: %s\n", error.c_str());
+      return 1;
+    }
+
+  if (links)
+    {
+      archive.scan(from, to, node, [&](const AlertRecord &r) {
+	  topology.addAlert(r);
+	  analysis.addAlert(r);
+	});
+      if (links == 'g')
+	topology.writeDot(stdout);
+      else if (links == 'l')
+	topology.writeCsv(stdout);
+      else
+	{
+	  analysis.refresh(topology);
+	  analysis.writeCsv(stdout);
+	}
+    }
+  else if (countOnly)
+    {
+      found = archive.scan(from, to, node, [](const AlertRecord &) { });
+      printf("%lu\n", (unsigned long)found);
+    }
+  else
+    {
+      printf("time,root,stolenId,voltageData,packetId,path1,path2,path3,"
+	     "path4,path5,path6,ignoredId,settingsVersion\n");
+      archive.scan(from, to, node, printRecord);
+    }
+
+  return 0;
+}
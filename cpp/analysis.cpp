@@ -0,0 +1,165 @@
+/**
+ * Relay load, betweenness centrality and cut-node analysis.
+ */
+#include "analysis.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace {
+
+/* Brandes' betweenness centrality, one BFS per source */
+std::vector<double> betweenness(const Graph &g, unsigned threads)
+{
+  std::vector<std::vector<double> > partial(threads, std::vector<double>(g.size()));
+
+  parallelFor(g.size(), threads, [&g, &partial](size_t s, unsigned t) {
+      std::vector<int> dist(g.size(), -1);
+      std::vector<double> sigma(g.size()), delta(g.size());
+      std::vector<uint32_t> order;
+
+      dist[s] = 0;
+      sigma[s] = 1;
+      order.push_back(s);
+      for (size_t head = 0; head < order.size(); head++)
+	{
+	  uint32_t v = order[head];
+
+	  for (uint32_t e = g.outStart[v]; e < g.outStart[v + 1]; e++)
+	    {
+	      uint32_t w = g.out[e];
+
+	      if (dist[w] < 0)
+		{
+		  dist[w] = dist[v] + 1;
+		  order.push_back(w);
+		}
+	      if (dist[w] == dist[v] + 1)
+		sigma[w] += sigma[v];
+	    }
+	}
+
+      /* Accumulate dependencies in reverse BFS order */
+      for (size_t i = order.size(); i-- > 1; )
+	{
+	  uint32_t v = order[i];
+
+	  for (uint32_t e = g.outStart[v]; e < g.outStart[v + 1]; e++)
+	    {
+	      uint32_t w = g.out[e];
+
+	      if (dist[w] == dist[v] + 1)
+		delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+	    }
+	  partial[t][v] += delta[v];
+	}
+    });
+
+  std::vector<double> total(g.size());
+  for (size_t t = 0; t < partial.size(); t++)
+    for (size_t v = 0; v < g.size(); v++)
+      total[v] += partial[t][v];
+  return total;
+}
+
+/* Mark the nodes that can reach a root without going through skip */
+void reachRoots(const Graph &g, const std::vector<uint32_t> &roots, int64_t skip,
+		std::vector<char> &reached)
+{
+  std::vector<uint32_t> queue;
+
+  reached.assign(g.size(), 0);
+  for (size_t i = 0; i < roots.size(); i++)
+    if (roots[i] != skip)
+      {
+	reached[roots[i]] = 1;
+	queue.push_back(roots[i]);
+      }
+  for (size_t head = 0; head < queue.size(); head++)
+    {
+      uint32_t v = queue[head];
+
+      for (uint32_t e = g.inStart[v]; e < g.inStart[v + 1]; e++)
+	{
+	  uint32_t u = g.in[e];
+
+	  if (!reached[u] && u != skip)
+	    {
+	      reached[u] = 1;
+	      queue.push_back(u);
+	    }
+	}
+    }
+}
+
+}
+
+void NetworkAnalysis::addAlert(const AlertRecord &r)
+{
+  uint16_t hops[8];
+  int n = alertRoute(r, hops, depth);
+
+  roots.insert(r.root);
+  results[r.origin].originated++;
+  for (int i = 0; i < n - 1; i++)
+    if (hops[i] != r.origin)
+      results[hops[i]].relayed++;
+}
+
+bool NetworkAnalysis::refresh(const Topology &topology, unsigned threads)
+{
+  if (topology.generation() == analysedGeneration)
+    return false;
+  analysedGeneration = topology.generation();
+
+  threads = defaultThreads(threads);
+
+  Graph g = buildGraph(topology);
+  std::vector<double> central = betweenness(g, threads);
+
+  std::vector<uint32_t> rootIndex;
+  for (size_t v = 0; v < g.size(); v++)
+    if (roots.count(g.ids[v]))
+      rootIndex.push_back(v);
+
+  std::vector<char> connected;
+  reachRoots(g, rootIndex, -1, connected);
+
+  std::vector<std::vector<uint16_t> > cuts(g.size());
+  parallelFor(g.size(), threads, [&](size_t v, unsigned) {
+      std::vector<char> reached;
+
+      if (!connected[v] || roots.count(g.ids[v]))
+	return;
+      reachRoots(g, rootIndex, v, reached);
+      for (size_t u = 0; u < g.size(); u++)
+	if (u != v && connected[u] && !reached[u])
+	  cuts[v].push_back(g.ids[u]);
+    });
+
+  for (size_t v = 0; v < g.size(); v++)
+    {
+      NodeAnalysis &a = results[g.ids[v]];
+
+      a.betweenness = central[v];
+      a.cutOff.swap(cuts[v]);
+    }
+
+  return true;
+}
+
+void NetworkAnalysis::writeCsv(FILE *out) const
+{
+  fprintf(out, "node,originated,relayed,betweenness,cutOff\n");
+  for (std::map<uint16_t, NodeAnalysis>::const_iterator n = results.begin();
+       n != results.end(); ++n)
+    {
+      const NodeAnalysis &a = n->second;
+
+      fprintf(out, "%u,%llu,%llu,%.2f,", n->first, (unsigned long long)a.originated,
+	      (unsigned long long)a.relayed, a.betweenness);
+      for (size_t i = 0; i < a.cutOff.size(); i++)
+	fprintf(out, i ? " %u" : "%u", a.cutOff[i]);
+      fprintf(out, "\n");
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * Relay bottleneck analysis over the topology reconstructed from alert
+ * paths.
+ *
+ * For every node this reports
+ * - its relay load: alerts it originated and alerts it relayed, kept up
+ *   to date incrementally as alerts arrive;
+ * - its betweenness centrality in the observed link graph (Brandes'
+ *   algorithm, shortest paths by hop count);
+ * - the nodes that could no longer reach a root if it were blacklisted,
+ *   i.e. for which every observed route goes through it.
+ * The last two depend only on the graph structure, so refresh() only
+ * recomputes them when the topology gained links, spreading the work
+ * over all cores.
+ */
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "topology.h"
+
+struct NodeAnalysis
+{
+  uint64_t originated, relayed;
+  double betweenness;
+  std::vector<uint16_t> cutOff;	/* nodes left without a route if this one goes */
+};
+
+class NetworkAnalysis
+{
+ public:
+  NetworkAnalysis() : depth(antitheft::PATH_DEPTH), analysedGeneration(0) { }
+
+  /* Hops of the path the nodes record, as in Topology::setPathDepth */
+  void setPathDepth(int pathDepth) { depth = pathDepth; }
+
+  /* Account for an alert's relay load. The alert must also have been
+     added to the topology given to refresh. */
+  void addAlert(const AlertRecord &r);
+
+  /* Recompute centrality and cut nodes if topology changed since the
+     last refresh, using up to threads threads (0: one per core).
+     Returns true if anything was recomputed. */
+  bool refresh(const Topology &topology, unsigned threads = 0);
+
+  const std::map<uint16_t, NodeAnalysis> &nodes() const { return results; }
+
+  /* Write one CSV line per node */
+  void writeCsv(FILE *out) const;
+
+ private:
+  std::map<uint16_t, NodeAnalysis> results;
+  std::set<uint16_t> roots;
+  int depth;
+  uint64_t analysedGeneration;
+};
+
+#endif
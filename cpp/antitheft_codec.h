@@ -0,0 +1,1219 @@
+/**
+ * This file is automatically generated by mkcodec.py. DO NOT EDIT THIS FILE.
+ * C++ codec for the messages and constants of
+ * ../Nodes/antitheft.h.
+ */
+#ifndef ANTITHEFT_CODEC_H
+#define ANTITHEFT_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace antitheft {
+
+enum {
+  BROADCAST = 4,
+  LOW_BATTERY = 1,
+  AM_SETTINGS = 54,
+  AM_URGENT_SETTINGS = 55,
+  AM_PROFILES = 56,
+  AM_THEFT = 99,
+  AM_ALERT = 22,
+  AM_ROOT_STATUS = 23,
+  AM_ENERGY = 24,
+  AM_COMMAND = 25,
+  AM_URGENT = 26,
+  DIS_SAMPLING = 43,
+  DIS_REPORTING = 44,
+  DIS_BLACKLIST = 45,
+  DIS_PROFILES = 49,
+  COL_ALERTS = 11,
+  DEFAULT_ALERT = 4,
+  DEFAULT_DETECT = 1,
+  DEFAULT_CHECK_INTERVAL = 1000,
+  DISSEMINATION_ITEM_SIZE = 16,
+  BLACKLIST_PAGE_SIZE = 2,
+  BLACKLIST_PAGES = 4,
+  BLACKLIST_SIZE = 8,
+  PROFILE_PAGE_SIZE = 2,
+  PROFILE_PAGES = 4,
+  PROFILE_SIZE = 8,
+  COMMAND_BLACKLIST = 1,
+  COMMAND_MAX_HOPS = 6,
+  COMMAND_RETRIES = 3,
+  COMMAND_TIMEOUT = 5000,
+  ROOT_QUEUE_SIZE = 8,
+  MSG_POOL_SIZE = 4,
+  PATH_DEPTH = 6,
+  DUP_CACHE_SIZE = 0,
+  AGGREGATION_WINDOW = 0,
+  LPL_INTERVAL = 512,
+  ROOT_STATUS_INTERVAL = 5000,
+  ENERGY_REPORT_INTERVAL = 60000
+};
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static inline uint16_t fromBE16(uint16_t v) { return v; }
+static inline uint32_t fromBE32(uint32_t v) { return v; }
+#else
+static inline uint16_t fromBE16(uint16_t v) { return __builtin_bswap16(v); }
+static inline uint32_t fromBE32(uint32_t v) { return __builtin_bswap32(v); }
+#endif
+
+static inline uint8_t loadBE8(const uint8_t *p) { return *p; }
+static inline void storeBE8(uint8_t *p, uint8_t v) { *p = v; }
+static inline uint16_t loadBE16(const uint8_t *p)
+{
+  uint16_t v;
+
+  memcpy(&v, p, sizeof v);
+  return fromBE16(v);
+}
+static inline void storeBE16(uint8_t *p, uint16_t v)
+{
+  v = fromBE16(v);
+  memcpy(p, &v, sizeof v);
+}
+static inline uint32_t loadBE32(const uint8_t *p)
+{
+  uint32_t v;
+
+  memcpy(&v, p, sizeof v);
+  return fromBE32(v);
+}
+static inline void storeBE32(uint8_t *p, uint32_t v)
+{
+  v = fromBE32(v);
+  memcpy(p, &v, sizeof v);
+}
+
+/* nx_struct settings */
+struct SettingsMsg
+{
+  static const size_t SIZE = 10;
+  static const uint8_t AM_TYPE = AM_SETTINGS;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_alert = 0,
+    OFFSET_detect = 1,
+    OFFSET_checkInterval = 2,
+    OFFSET_targetId = 4,
+    OFFSET_duration = 6,
+    OFFSET_version = 8
+  };
+
+  uint8_t alert;
+  uint8_t detect;
+  uint16_t checkInterval;
+  uint16_t targetId;
+  uint16_t duration;
+  uint16_t version;
+
+  /* Access a field of an encoded message in place */
+  static uint8_t get_alert(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_alert); }
+  static void set_alert(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_alert, v); }
+  static uint8_t get_detect(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_detect); }
+  static void set_detect(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_detect, v); }
+  static uint16_t get_checkInterval(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_checkInterval); }
+  static void set_checkInterval(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_checkInterval, v); }
+  static uint16_t get_targetId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_targetId); }
+  static void set_targetId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_targetId, v); }
+  static uint16_t get_duration(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_duration); }
+  static void set_duration(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_duration, v); }
+  static uint16_t get_version(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_version); }
+  static void set_version(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_version, v); }
+
+  static SettingsMsg decode(const uint8_t *p)
+  {
+    SettingsMsg m;
+
+    m.alert = get_alert(p);
+    m.detect = get_detect(p);
+    m.checkInterval = get_checkInterval(p);
+    m.targetId = get_targetId(p);
+    m.duration = get_duration(p);
+    m.version = get_version(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_alert(p, alert);
+    set_detect(p, detect);
+    set_checkInterval(p, checkInterval);
+    set_targetId(p, targetId);
+    set_duration(p, duration);
+    set_version(p, version);
+  }
+};
+
+/* Columns of decoded settings messages */
+struct SettingsMsgBatch
+{
+  std::vector<uint8_t> alert;
+  std::vector<uint8_t> detect;
+  std::vector<uint16_t> checkInterval;
+  std::vector<uint16_t> targetId;
+  std::vector<uint16_t> duration;
+  std::vector<uint16_t> version;
+
+  size_t size() const { return alert.size(); }
+
+  void clear()
+  {
+    alert.clear();
+    detect.clear();
+    checkInterval.clear();
+    targetId.clear();
+    duration.clear();
+    version.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = SettingsMsg::SIZE)
+  {
+    size_t base = size();
+
+    alert.resize(base + n);
+    detect.resize(base + n);
+    checkInterval.resize(base + n);
+    targetId.resize(base + n);
+    duration.resize(base + n);
+    version.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      alert[base + i] = SettingsMsg::get_alert(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      detect[base + i] = SettingsMsg::get_detect(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      checkInterval[base + i] = SettingsMsg::get_checkInterval(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      targetId[base + i] = SettingsMsg::get_targetId(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      duration[base + i] = SettingsMsg::get_duration(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      version[base + i] = SettingsMsg::get_version(frames + i * stride);
+  }
+};
+
+/* nx_struct sampling */
+struct SamplingMsg
+{
+  static const size_t SIZE = 5;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_detect = 0,
+    OFFSET_checkInterval = 1,
+    OFFSET_version = 3
+  };
+
+  uint8_t detect;
+  uint16_t checkInterval;
+  uint16_t version;
+
+  /* Access a field of an encoded message in place */
+  static uint8_t get_detect(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_detect); }
+  static void set_detect(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_detect, v); }
+  static uint16_t get_checkInterval(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_checkInterval); }
+  static void set_checkInterval(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_checkInterval, v); }
+  static uint16_t get_version(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_version); }
+  static void set_version(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_version, v); }
+
+  static SamplingMsg decode(const uint8_t *p)
+  {
+    SamplingMsg m;
+
+    m.detect = get_detect(p);
+    m.checkInterval = get_checkInterval(p);
+    m.version = get_version(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_detect(p, detect);
+    set_checkInterval(p, checkInterval);
+    set_version(p, version);
+  }
+};
+
+/* Columns of decoded sampling messages */
+struct SamplingMsgBatch
+{
+  std::vector<uint8_t> detect;
+  std::vector<uint16_t> checkInterval;
+  std::vector<uint16_t> version;
+
+  size_t size() const { return detect.size(); }
+
+  void clear()
+  {
+    detect.clear();
+    checkInterval.clear();
+    version.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = SamplingMsg::SIZE)
+  {
+    size_t base = size();
+
+    detect.resize(base + n);
+    checkInterval.resize(base + n);
+    version.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      detect[base + i] = SamplingMsg::get_detect(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      checkInterval[base + i] = SamplingMsg::get_checkInterval(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      version[base + i] = SamplingMsg::get_version(frames + i * stride);
+  }
+};
+
+/* nx_struct reporting */
+struct ReportingMsg
+{
+  static const size_t SIZE = 3;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_alert = 0,
+    OFFSET_version = 1
+  };
+
+  uint8_t alert;
+  uint16_t version;
+
+  /* Access a field of an encoded message in place */
+  static uint8_t get_alert(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_alert); }
+  static void set_alert(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_alert, v); }
+  static uint16_t get_version(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_version); }
+  static void set_version(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_version, v); }
+
+  static ReportingMsg decode(const uint8_t *p)
+  {
+    ReportingMsg m;
+
+    m.alert = get_alert(p);
+    m.version = get_version(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_alert(p, alert);
+    set_version(p, version);
+  }
+};
+
+/* Columns of decoded reporting messages */
+struct ReportingMsgBatch
+{
+  std::vector<uint8_t> alert;
+  std::vector<uint16_t> version;
+
+  size_t size() const { return alert.size(); }
+
+  void clear()
+  {
+    alert.clear();
+    version.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = ReportingMsg::SIZE)
+  {
+    size_t base = size();
+
+    alert.resize(base + n);
+    version.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      alert[base + i] = ReportingMsg::get_alert(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      version[base + i] = ReportingMsg::get_version(frames + i * stride);
+  }
+};
+
+/* nx_struct blacklist */
+struct BlacklistMsg
+{
+  static const size_t SIZE = 13;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_page = 0,
+    OFFSET_target = 1,
+    OFFSET_duration = 5,
+    OFFSET_version = 9,
+    COUNT_target = 2,
+    COUNT_duration = 2,
+    COUNT_version = 2
+  };
+
+  uint8_t page;
+  uint16_t target[2];
+  uint16_t duration[2];
+  uint16_t version[2];
+
+  /* Access a field of an encoded message in place */
+  static uint8_t get_page(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_page); }
+  static void set_page(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_page, v); }
+  static uint16_t get_target(const uint8_t *p, size_t i) { return (uint16_t)loadBE16(p + OFFSET_target + i * 2); }
+  static void set_target(uint8_t *p, size_t i, uint16_t v) { storeBE16(p + OFFSET_target + i * 2, v); }
+  static uint16_t get_duration(const uint8_t *p, size_t i) { return (uint16_t)loadBE16(p + OFFSET_duration + i * 2); }
+  static void set_duration(uint8_t *p, size_t i, uint16_t v) { storeBE16(p + OFFSET_duration + i * 2, v); }
+  static uint16_t get_version(const uint8_t *p, size_t i) { return (uint16_t)loadBE16(p + OFFSET_version + i * 2); }
+  static void set_version(uint8_t *p, size_t i, uint16_t v) { storeBE16(p + OFFSET_version + i * 2, v); }
+
+  static BlacklistMsg decode(const uint8_t *p)
+  {
+    BlacklistMsg m;
+
+    m.page = get_page(p);
+    for (size_t i = 0; i < COUNT_target; i++)
+      m.target[i] = get_target(p, i);
+    for (size_t i = 0; i < COUNT_duration; i++)
+      m.duration[i] = get_duration(p, i);
+    for (size_t i = 0; i < COUNT_version; i++)
+      m.version[i] = get_version(p, i);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_page(p, page);
+    for (size_t i = 0; i < COUNT_target; i++)
+      set_target(p, i, target[i]);
+    for (size_t i = 0; i < COUNT_duration; i++)
+      set_duration(p, i, duration[i]);
+    for (size_t i = 0; i < COUNT_version; i++)
+      set_version(p, i, version[i]);
+  }
+};
+
+/* Columns of decoded blacklist messages */
+struct BlacklistMsgBatch
+{
+  std::vector<uint8_t> page;
+  std::vector<uint16_t> target0;
+  std::vector<uint16_t> target1;
+  std::vector<uint16_t> duration0;
+  std::vector<uint16_t> duration1;
+  std::vector<uint16_t> version0;
+  std::vector<uint16_t> version1;
+
+  size_t size() const { return page.size(); }
+
+  void clear()
+  {
+    page.clear();
+    target0.clear();
+    target1.clear();
+    duration0.clear();
+    duration1.clear();
+    version0.clear();
+    version1.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = BlacklistMsg::SIZE)
+  {
+    size_t base = size();
+
+    page.resize(base + n);
+    target0.resize(base + n);
+    target1.resize(base + n);
+    duration0.resize(base + n);
+    duration1.resize(base + n);
+    version0.resize(base + n);
+    version1.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      page[base + i] = BlacklistMsg::get_page(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      target0[base + i] = BlacklistMsg::get_target(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      target1[base + i] = BlacklistMsg::get_target(frames + i * stride, 1);
+    for (size_t i = 0; i < n; i++)
+      duration0[base + i] = BlacklistMsg::get_duration(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      duration1[base + i] = BlacklistMsg::get_duration(frames + i * stride, 1);
+    for (size_t i = 0; i < n; i++)
+      version0[base + i] = BlacklistMsg::get_version(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      version1[base + i] = BlacklistMsg::get_version(frames + i * stride, 1);
+  }
+};
+
+/* nx_struct profiles */
+struct ProfilesMsg
+{
+  static const size_t SIZE = 14;
+  static const uint8_t AM_TYPE = AM_PROFILES;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_page = 0,
+    OFFSET_count = 1,
+    OFFSET_first = 2,
+    OFFSET_interval = 6,
+    OFFSET_alert = 10,
+    OFFSET_version = 12,
+    COUNT_first = 2,
+    COUNT_interval = 2,
+    COUNT_alert = 2
+  };
+
+  uint8_t page;
+  uint8_t count;
+  uint16_t first[2];
+  uint16_t interval[2];
+  uint8_t alert[2];
+  uint16_t version;
+
+  /* Access a field of an encoded message in place */
+  static uint8_t get_page(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_page); }
+  static void set_page(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_page, v); }
+  static uint8_t get_count(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_count); }
+  static void set_count(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_count, v); }
+  static uint16_t get_first(const uint8_t *p, size_t i) { return (uint16_t)loadBE16(p + OFFSET_first + i * 2); }
+  static void set_first(uint8_t *p, size_t i, uint16_t v) { storeBE16(p + OFFSET_first + i * 2, v); }
+  static uint16_t get_interval(const uint8_t *p, size_t i) { return (uint16_t)loadBE16(p + OFFSET_interval + i * 2); }
+  static void set_interval(uint8_t *p, size_t i, uint16_t v) { storeBE16(p + OFFSET_interval + i * 2, v); }
+  static uint8_t get_alert(const uint8_t *p, size_t i) { return (uint8_t)loadBE8(p + OFFSET_alert + i * 1); }
+  static void set_alert(uint8_t *p, size_t i, uint8_t v) { storeBE8(p + OFFSET_alert + i * 1, v); }
+  static uint16_t get_version(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_version); }
+  static void set_version(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_version, v); }
+
+  static ProfilesMsg decode(const uint8_t *p)
+  {
+    ProfilesMsg m;
+
+    m.page = get_page(p);
+    m.count = get_count(p);
+    for (size_t i = 0; i < COUNT_first; i++)
+      m.first[i] = get_first(p, i);
+    for (size_t i = 0; i < COUNT_interval; i++)
+      m.interval[i] = get_interval(p, i);
+    for (size_t i = 0; i < COUNT_alert; i++)
+      m.alert[i] = get_alert(p, i);
+    m.version = get_version(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_page(p, page);
+    set_count(p, count);
+    for (size_t i = 0; i < COUNT_first; i++)
+      set_first(p, i, first[i]);
+    for (size_t i = 0; i < COUNT_interval; i++)
+      set_interval(p, i, interval[i]);
+    for (size_t i = 0; i < COUNT_alert; i++)
+      set_alert(p, i, alert[i]);
+    set_version(p, version);
+  }
+};
+
+/* Columns of decoded profiles messages */
+struct ProfilesMsgBatch
+{
+  std::vector<uint8_t> page;
+  std::vector<uint8_t> count;
+  std::vector<uint16_t> first0;
+  std::vector<uint16_t> first1;
+  std::vector<uint16_t> interval0;
+  std::vector<uint16_t> interval1;
+  std::vector<uint8_t> alert0;
+  std::vector<uint8_t> alert1;
+  std::vector<uint16_t> version;
+
+  size_t size() const { return page.size(); }
+
+  void clear()
+  {
+    page.clear();
+    count.clear();
+    first0.clear();
+    first1.clear();
+    interval0.clear();
+    interval1.clear();
+    alert0.clear();
+    alert1.clear();
+    version.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = ProfilesMsg::SIZE)
+  {
+    size_t base = size();
+
+    page.resize(base + n);
+    count.resize(base + n);
+    first0.resize(base + n);
+    first1.resize(base + n);
+    interval0.resize(base + n);
+    interval1.resize(base + n);
+    alert0.resize(base + n);
+    alert1.resize(base + n);
+    version.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      page[base + i] = ProfilesMsg::get_page(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      count[base + i] = ProfilesMsg::get_count(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      first0[base + i] = ProfilesMsg::get_first(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      first1[base + i] = ProfilesMsg::get_first(frames + i * stride, 1);
+    for (size_t i = 0; i < n; i++)
+      interval0[base + i] = ProfilesMsg::get_interval(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      interval1[base + i] = ProfilesMsg::get_interval(frames + i * stride, 1);
+    for (size_t i = 0; i < n; i++)
+      alert0[base + i] = ProfilesMsg::get_alert(frames + i * stride, 0);
+    for (size_t i = 0; i < n; i++)
+      alert1[base + i] = ProfilesMsg::get_alert(frames + i * stride, 1);
+    for (size_t i = 0; i < n; i++)
+      version[base + i] = ProfilesMsg::get_version(frames + i * stride);
+  }
+};
+
+/* nx_struct alert */
+struct AlertMsg
+{
+  static const size_t SIZE = 22;
+  static const uint8_t AM_TYPE = AM_ALERT;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_stolenId = 0,
+    OFFSET_voltageData = 2,
+    OFFSET_packetId = 4,
+    OFFSET_path1 = 6,
+    OFFSET_path2 = 8,
+    OFFSET_path3 = 10,
+    OFFSET_path4 = 12,
+    OFFSET_path5 = 14,
+    OFFSET_path6 = 16,
+    OFFSET_ignoredId = 18,
+    OFFSET_settingsVersion = 20
+  };
+
+  uint16_t stolenId;
+  uint16_t voltageData;
+  uint16_t packetId;
+  uint16_t path1;
+  uint16_t path2;
+  uint16_t path3;
+  uint16_t path4;
+  uint16_t path5;
+  uint16_t path6;
+  uint16_t ignoredId;
+  uint16_t settingsVersion;
+
+  /* Access a field of an encoded message in place */
+  static uint16_t get_stolenId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_stolenId); }
+  static void set_stolenId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_stolenId, v); }
+  static uint16_t get_voltageData(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_voltageData); }
+  static void set_voltageData(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_voltageData, v); }
+  static uint16_t get_packetId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_packetId); }
+  static void set_packetId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_packetId, v); }
+  static uint16_t get_path1(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path1); }
+  static void set_path1(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path1, v); }
+  static uint16_t get_path2(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path2); }
+  static void set_path2(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path2, v); }
+  static uint16_t get_path3(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path3); }
+  static void set_path3(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path3, v); }
+  static uint16_t get_path4(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path4); }
+  static void set_path4(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path4, v); }
+  static uint16_t get_path5(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path5); }
+  static void set_path5(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path5, v); }
+  static uint16_t get_path6(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_path6); }
+  static void set_path6(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_path6, v); }
+  static uint16_t get_ignoredId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_ignoredId); }
+  static void set_ignoredId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_ignoredId, v); }
+  static uint16_t get_settingsVersion(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_settingsVersion); }
+  static void set_settingsVersion(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_settingsVersion, v); }
+
+  static AlertMsg decode(const uint8_t *p)
+  {
+    AlertMsg m;
+
+    m.stolenId = get_stolenId(p);
+    m.voltageData = get_voltageData(p);
+    m.packetId = get_packetId(p);
+    m.path1 = get_path1(p);
+    m.path2 = get_path2(p);
+    m.path3 = get_path3(p);
+    m.path4 = get_path4(p);
+    m.path5 = get_path5(p);
+    m.path6 = get_path6(p);
+    m.ignoredId = get_ignoredId(p);
+    m.settingsVersion = get_settingsVersion(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_stolenId(p, stolenId);
+    set_voltageData(p, voltageData);
+    set_packetId(p, packetId);
+    set_path1(p, path1);
+    set_path2(p, path2);
+    set_path3(p, path3);
+    set_path4(p, path4);
+    set_path5(p, path5);
+    set_path6(p, path6);
+    set_ignoredId(p, ignoredId);
+    set_settingsVersion(p, settingsVersion);
+  }
+};
+
+/* Columns of decoded alert messages */
+struct AlertMsgBatch
+{
+  std::vector<uint16_t> stolenId;
+  std::vector<uint16_t> voltageData;
+  std::vector<uint16_t> packetId;
+  std::vector<uint16_t> path1;
+  std::vector<uint16_t> path2;
+  std::vector<uint16_t> path3;
+  std::vector<uint16_t> path4;
+  std::vector<uint16_t> path5;
+  std::vector<uint16_t> path6;
+  std::vector<uint16_t> ignoredId;
+  std::vector<uint16_t> settingsVersion;
+
+  size_t size() const { return stolenId.size(); }
+
+  void clear()
+  {
+    stolenId.clear();
+    voltageData.clear();
+    packetId.clear();
+    path1.clear();
+    path2.clear();
+    path3.clear();
+    path4.clear();
+    path5.clear();
+    path6.clear();
+    ignoredId.clear();
+    settingsVersion.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = AlertMsg::SIZE)
+  {
+    size_t base = size();
+
+    stolenId.resize(base + n);
+    voltageData.resize(base + n);
+    packetId.resize(base + n);
+    path1.resize(base + n);
+    path2.resize(base + n);
+    path3.resize(base + n);
+    path4.resize(base + n);
+    path5.resize(base + n);
+    path6.resize(base + n);
+    ignoredId.resize(base + n);
+    settingsVersion.resize(base + n);
+
+    /* Byte-swap a block of frames as a flat word array, then
+       transpose it into the columns */
+    const size_t BLOCK = 256;
+    uint16_t block[BLOCK * 11];
+
+    for (size_t first = 0; first < n; first += BLOCK)
+      {
+        size_t count = n - first < BLOCK ? n - first : BLOCK;
+
+        if (stride == AlertMsg::SIZE)
+          memcpy(block, frames + first * stride, count * AlertMsg::SIZE);
+        else
+          for (size_t i = 0; i < count; i++)
+            memcpy(block + i * 11, frames + (first + i) * stride, AlertMsg::SIZE);
+        for (size_t i = 0; i < count * 11; i++)
+          block[i] = fromBE16(block[i]);
+        for (size_t i = 0; i < count; i++)
+          {
+            const uint16_t *w = block + i * 11;
+
+            stolenId[base + first + i] = (uint16_t)w[0];
+            voltageData[base + first + i] = (uint16_t)w[1];
+            packetId[base + first + i] = (uint16_t)w[2];
+            path1[base + first + i] = (uint16_t)w[3];
+            path2[base + first + i] = (uint16_t)w[4];
+            path3[base + first + i] = (uint16_t)w[5];
+            path4[base + first + i] = (uint16_t)w[6];
+            path5[base + first + i] = (uint16_t)w[7];
+            path6[base + first + i] = (uint16_t)w[8];
+            ignoredId[base + first + i] = (uint16_t)w[9];
+            settingsVersion[base + first + i] = (uint16_t)w[10];
+          }
+      }
+  }
+};
+
+/* nx_struct root_status */
+struct RootStatusMsg
+{
+  static const size_t SIZE = 16;
+  static const uint8_t AM_TYPE = AM_ROOT_STATUS;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_seqno = 0,
+    OFFSET_interval = 2,
+    OFFSET_received = 4,
+    OFFSET_forwarded = 6,
+    OFFSET_dropped = 8,
+    OFFSET_sendFailed = 10,
+    OFFSET_uartBusy = 12,
+    OFFSET_queueLen = 14,
+    OFFSET_maxQueue = 15
+  };
+
+  uint16_t seqno;
+  uint16_t interval;
+  uint16_t received;
+  uint16_t forwarded;
+  uint16_t dropped;
+  uint16_t sendFailed;
+  uint16_t uartBusy;
+  uint8_t queueLen;
+  uint8_t maxQueue;
+
+  /* Access a field of an encoded message in place */
+  static uint16_t get_seqno(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_seqno); }
+  static void set_seqno(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_seqno, v); }
+  static uint16_t get_interval(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_interval); }
+  static void set_interval(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_interval, v); }
+  static uint16_t get_received(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_received); }
+  static void set_received(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_received, v); }
+  static uint16_t get_forwarded(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_forwarded); }
+  static void set_forwarded(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_forwarded, v); }
+  static uint16_t get_dropped(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_dropped); }
+  static void set_dropped(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_dropped, v); }
+  static uint16_t get_sendFailed(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_sendFailed); }
+  static void set_sendFailed(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_sendFailed, v); }
+  static uint16_t get_uartBusy(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_uartBusy); }
+  static void set_uartBusy(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_uartBusy, v); }
+  static uint8_t get_queueLen(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_queueLen); }
+  static void set_queueLen(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_queueLen, v); }
+  static uint8_t get_maxQueue(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_maxQueue); }
+  static void set_maxQueue(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_maxQueue, v); }
+
+  static RootStatusMsg decode(const uint8_t *p)
+  {
+    RootStatusMsg m;
+
+    m.seqno = get_seqno(p);
+    m.interval = get_interval(p);
+    m.received = get_received(p);
+    m.forwarded = get_forwarded(p);
+    m.dropped = get_dropped(p);
+    m.sendFailed = get_sendFailed(p);
+    m.uartBusy = get_uartBusy(p);
+    m.queueLen = get_queueLen(p);
+    m.maxQueue = get_maxQueue(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_seqno(p, seqno);
+    set_interval(p, interval);
+    set_received(p, received);
+    set_forwarded(p, forwarded);
+    set_dropped(p, dropped);
+    set_sendFailed(p, sendFailed);
+    set_uartBusy(p, uartBusy);
+    set_queueLen(p, queueLen);
+    set_maxQueue(p, maxQueue);
+  }
+};
+
+/* Columns of decoded root_status messages */
+struct RootStatusMsgBatch
+{
+  std::vector<uint16_t> seqno;
+  std::vector<uint16_t> interval;
+  std::vector<uint16_t> received;
+  std::vector<uint16_t> forwarded;
+  std::vector<uint16_t> dropped;
+  std::vector<uint16_t> sendFailed;
+  std::vector<uint16_t> uartBusy;
+  std::vector<uint8_t> queueLen;
+  std::vector<uint8_t> maxQueue;
+
+  size_t size() const { return seqno.size(); }
+
+  void clear()
+  {
+    seqno.clear();
+    interval.clear();
+    received.clear();
+    forwarded.clear();
+    dropped.clear();
+    sendFailed.clear();
+    uartBusy.clear();
+    queueLen.clear();
+    maxQueue.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = RootStatusMsg::SIZE)
+  {
+    size_t base = size();
+
+    seqno.resize(base + n);
+    interval.resize(base + n);
+    received.resize(base + n);
+    forwarded.resize(base + n);
+    dropped.resize(base + n);
+    sendFailed.resize(base + n);
+    uartBusy.resize(base + n);
+    queueLen.resize(base + n);
+    maxQueue.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      seqno[base + i] = RootStatusMsg::get_seqno(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      interval[base + i] = RootStatusMsg::get_interval(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      received[base + i] = RootStatusMsg::get_received(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      forwarded[base + i] = RootStatusMsg::get_forwarded(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      dropped[base + i] = RootStatusMsg::get_dropped(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      sendFailed[base + i] = RootStatusMsg::get_sendFailed(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      uartBusy[base + i] = RootStatusMsg::get_uartBusy(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      queueLen[base + i] = RootStatusMsg::get_queueLen(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      maxQueue[base + i] = RootStatusMsg::get_maxQueue(frames + i * stride);
+  }
+};
+
+/* nx_struct command */
+struct CommandMsg
+{
+  static const size_t SIZE = 22;
+  static const uint8_t AM_TYPE = AM_COMMAND;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_seqno = 0,
+    OFFSET_rootId = 2,
+    OFFSET_type = 4,
+    OFFSET_ack = 5,
+    OFFSET_hops = 6,
+    OFFSET_hop = 7,
+    OFFSET_duration = 8,
+    OFFSET_route1 = 10,
+    OFFSET_route2 = 12,
+    OFFSET_route3 = 14,
+    OFFSET_route4 = 16,
+    OFFSET_route5 = 18,
+    OFFSET_route6 = 20
+  };
+
+  uint16_t seqno;
+  uint16_t rootId;
+  uint8_t type;
+  uint8_t ack;
+  uint8_t hops;
+  uint8_t hop;
+  uint16_t duration;
+  uint16_t route1;
+  uint16_t route2;
+  uint16_t route3;
+  uint16_t route4;
+  uint16_t route5;
+  uint16_t route6;
+
+  /* Access a field of an encoded message in place */
+  static uint16_t get_seqno(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_seqno); }
+  static void set_seqno(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_seqno, v); }
+  static uint16_t get_rootId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_rootId); }
+  static void set_rootId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_rootId, v); }
+  static uint8_t get_type(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_type); }
+  static void set_type(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_type, v); }
+  static uint8_t get_ack(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_ack); }
+  static void set_ack(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_ack, v); }
+  static uint8_t get_hops(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_hops); }
+  static void set_hops(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_hops, v); }
+  static uint8_t get_hop(const uint8_t *p) { return (uint8_t)loadBE8(p + OFFSET_hop); }
+  static void set_hop(uint8_t *p, uint8_t v) { storeBE8(p + OFFSET_hop, v); }
+  static uint16_t get_duration(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_duration); }
+  static void set_duration(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_duration, v); }
+  static uint16_t get_route1(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route1); }
+  static void set_route1(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route1, v); }
+  static uint16_t get_route2(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route2); }
+  static void set_route2(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route2, v); }
+  static uint16_t get_route3(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route3); }
+  static void set_route3(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route3, v); }
+  static uint16_t get_route4(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route4); }
+  static void set_route4(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route4, v); }
+  static uint16_t get_route5(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route5); }
+  static void set_route5(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route5, v); }
+  static uint16_t get_route6(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_route6); }
+  static void set_route6(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_route6, v); }
+
+  static CommandMsg decode(const uint8_t *p)
+  {
+    CommandMsg m;
+
+    m.seqno = get_seqno(p);
+    m.rootId = get_rootId(p);
+    m.type = get_type(p);
+    m.ack = get_ack(p);
+    m.hops = get_hops(p);
+    m.hop = get_hop(p);
+    m.duration = get_duration(p);
+    m.route1 = get_route1(p);
+    m.route2 = get_route2(p);
+    m.route3 = get_route3(p);
+    m.route4 = get_route4(p);
+    m.route5 = get_route5(p);
+    m.route6 = get_route6(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_seqno(p, seqno);
+    set_rootId(p, rootId);
+    set_type(p, type);
+    set_ack(p, ack);
+    set_hops(p, hops);
+    set_hop(p, hop);
+    set_duration(p, duration);
+    set_route1(p, route1);
+    set_route2(p, route2);
+    set_route3(p, route3);
+    set_route4(p, route4);
+    set_route5(p, route5);
+    set_route6(p, route6);
+  }
+};
+
+/* Columns of decoded command messages */
+struct CommandMsgBatch
+{
+  std::vector<uint16_t> seqno;
+  std::vector<uint16_t> rootId;
+  std::vector<uint8_t> type;
+  std::vector<uint8_t> ack;
+  std::vector<uint8_t> hops;
+  std::vector<uint8_t> hop;
+  std::vector<uint16_t> duration;
+  std::vector<uint16_t> route1;
+  std::vector<uint16_t> route2;
+  std::vector<uint16_t> route3;
+  std::vector<uint16_t> route4;
+  std::vector<uint16_t> route5;
+  std::vector<uint16_t> route6;
+
+  size_t size() const { return seqno.size(); }
+
+  void clear()
+  {
+    seqno.clear();
+    rootId.clear();
+    type.clear();
+    ack.clear();
+    hops.clear();
+    hop.clear();
+    duration.clear();
+    route1.clear();
+    route2.clear();
+    route3.clear();
+    route4.clear();
+    route5.clear();
+    route6.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = CommandMsg::SIZE)
+  {
+    size_t base = size();
+
+    seqno.resize(base + n);
+    rootId.resize(base + n);
+    type.resize(base + n);
+    ack.resize(base + n);
+    hops.resize(base + n);
+    hop.resize(base + n);
+    duration.resize(base + n);
+    route1.resize(base + n);
+    route2.resize(base + n);
+    route3.resize(base + n);
+    route4.resize(base + n);
+    route5.resize(base + n);
+    route6.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      seqno[base + i] = CommandMsg::get_seqno(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      rootId[base + i] = CommandMsg::get_rootId(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      type[base + i] = CommandMsg::get_type(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      ack[base + i] = CommandMsg::get_ack(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      hops[base + i] = CommandMsg::get_hops(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      hop[base + i] = CommandMsg::get_hop(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      duration[base + i] = CommandMsg::get_duration(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route1[base + i] = CommandMsg::get_route1(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route2[base + i] = CommandMsg::get_route2(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route3[base + i] = CommandMsg::get_route3(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route4[base + i] = CommandMsg::get_route4(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route5[base + i] = CommandMsg::get_route5(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      route6[base + i] = CommandMsg::get_route6(frames + i * stride);
+  }
+};
+
+/* nx_struct energy_report */
+struct EnergyReportMsg
+{
+  static const size_t SIZE = 22;
+
+  /* Byte offset of each field, and element count of each array */
+  enum {
+    OFFSET_nodeId = 0,
+    OFFSET_seqno = 2,
+    OFFSET_elapsed = 4,
+    OFFSET_radioOn = 8,
+    OFFSET_txPackets = 12,
+    OFFSET_rxPackets = 14,
+    OFFSET_adcReads = 16,
+    OFFSET_ledOn = 18
+  };
+
+  uint16_t nodeId;
+  uint16_t seqno;
+  uint32_t elapsed;
+  uint32_t radioOn;
+  uint16_t txPackets;
+  uint16_t rxPackets;
+  uint16_t adcReads;
+  uint32_t ledOn;
+
+  /* Access a field of an encoded message in place */
+  static uint16_t get_nodeId(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_nodeId); }
+  static void set_nodeId(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_nodeId, v); }
+  static uint16_t get_seqno(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_seqno); }
+  static void set_seqno(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_seqno, v); }
+  static uint32_t get_elapsed(const uint8_t *p) { return (uint32_t)loadBE32(p + OFFSET_elapsed); }
+  static void set_elapsed(uint8_t *p, uint32_t v) { storeBE32(p + OFFSET_elapsed, v); }
+  static uint32_t get_radioOn(const uint8_t *p) { return (uint32_t)loadBE32(p + OFFSET_radioOn); }
+  static void set_radioOn(uint8_t *p, uint32_t v) { storeBE32(p + OFFSET_radioOn, v); }
+  static uint16_t get_txPackets(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_txPackets); }
+  static void set_txPackets(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_txPackets, v); }
+  static uint16_t get_rxPackets(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_rxPackets); }
+  static void set_rxPackets(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_rxPackets, v); }
+  static uint16_t get_adcReads(const uint8_t *p) { return (uint16_t)loadBE16(p + OFFSET_adcReads); }
+  static void set_adcReads(uint8_t *p, uint16_t v) { storeBE16(p + OFFSET_adcReads, v); }
+  static uint32_t get_ledOn(const uint8_t *p) { return (uint32_t)loadBE32(p + OFFSET_ledOn); }
+  static void set_ledOn(uint8_t *p, uint32_t v) { storeBE32(p + OFFSET_ledOn, v); }
+
+  static EnergyReportMsg decode(const uint8_t *p)
+  {
+    EnergyReportMsg m;
+
+    m.nodeId = get_nodeId(p);
+    m.seqno = get_seqno(p);
+    m.elapsed = get_elapsed(p);
+    m.radioOn = get_radioOn(p);
+    m.txPackets = get_txPackets(p);
+    m.rxPackets = get_rxPackets(p);
+    m.adcReads = get_adcReads(p);
+    m.ledOn = get_ledOn(p);
+    return m;
+  }
+
+  void encode(uint8_t *p) const
+  {
+    set_nodeId(p, nodeId);
+    set_seqno(p, seqno);
+    set_elapsed(p, elapsed);
+    set_radioOn(p, radioOn);
+    set_txPackets(p, txPackets);
+    set_rxPackets(p, rxPackets);
+    set_adcReads(p, adcReads);
+    set_ledOn(p, ledOn);
+  }
+};
+
+/* Columns of decoded energy_report messages */
+struct EnergyReportMsgBatch
+{
+  std::vector<uint16_t> nodeId;
+  std::vector<uint16_t> seqno;
+  std::vector<uint32_t> elapsed;
+  std::vector<uint32_t> radioOn;
+  std::vector<uint16_t> txPackets;
+  std::vector<uint16_t> rxPackets;
+  std::vector<uint16_t> adcReads;
+  std::vector<uint32_t> ledOn;
+
+  size_t size() const { return nodeId.size(); }
+
+  void clear()
+  {
+    nodeId.clear();
+    seqno.clear();
+    elapsed.clear();
+    radioOn.clear();
+    txPackets.clear();
+    rxPackets.clear();
+    adcReads.clear();
+    ledOn.clear();
+  }
+
+  /* Append n frames found every stride bytes from frames */
+  void decode(const uint8_t *frames, size_t n, size_t stride = EnergyReportMsg::SIZE)
+  {
+    size_t base = size();
+
+    nodeId.resize(base + n);
+    seqno.resize(base + n);
+    elapsed.resize(base + n);
+    radioOn.resize(base + n);
+    txPackets.resize(base + n);
+    rxPackets.resize(base + n);
+    adcReads.resize(base + n);
+    ledOn.resize(base + n);
+    for (size_t i = 0; i < n; i++)
+      nodeId[base + i] = EnergyReportMsg::get_nodeId(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      seqno[base + i] = EnergyReportMsg::get_seqno(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      elapsed[base + i] = EnergyReportMsg::get_elapsed(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      radioOn[base + i] = EnergyReportMsg::get_radioOn(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      txPackets[base + i] = EnergyReportMsg::get_txPackets(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      rxPackets[base + i] = EnergyReportMsg::get_rxPackets(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      adcReads[base + i] = EnergyReportMsg::get_adcReads(frames + i * stride);
+    for (size_t i = 0; i < n; i++)
+      ledOn[base + i] = EnergyReportMsg::get_ledOn(frames + i * stride);
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,310 @@
+/**
+ * Alert archive writer and memory-mapped reader. See archive.h for the
+ * file layout.
+ */
+#include "archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char ARCHIVE_MAGIC[8] = { 'A', 'T', 'A', 'R', 'C', 'H', 'V', '\0' };
+const uint32_t INDEX_MAGIC = 0x41544958; /* "ATIX" */
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+const size_t SEGMENT_BYTES =
+  ARCHIVE_SEGMENT_RECORDS * sizeof(AlertRecord) + sizeof(ArchiveIndex);
+
+static_assert(sizeof(AlertRecord) == 32, "AlertRecord layout changed");
+static_assert(sizeof(ArchiveHeader) == 32, "ArchiveHeader layout changed");
+static_assert(sizeof(ArchiveIndex) % 8 == 0, "ArchiveIndex breaks record alignment");
+
+bool validHeader(const ArchiveHeader &h)
+{
+  return !memcmp(h.magic, ARCHIVE_MAGIC, sizeof h.magic) &&
+    h.version == ARCHIVE_VERSION && h.byteOrder == BYTE_ORDER_MARK &&
+    h.recordSize == sizeof(AlertRecord) &&
+    h.segmentRecords == ARCHIVE_SEGMENT_RECORDS &&
+    h.indexSize == sizeof(ArchiveIndex);
+}
+
+/* Records held in an archive body of the given size */
+size_t recordCount(size_t body)
+{
+  size_t partial = body % SEGMENT_BYTES / sizeof(AlertRecord);
+
+  if (partial > ARCHIVE_SEGMENT_RECORDS)
+    partial = ARCHIVE_SEGMENT_RECORDS;
+  return body / SEGMENT_BYTES * ARCHIVE_SEGMENT_RECORDS + partial;
+}
+
+/* Returns the bytes written, len unless write failed (errno says why) */
+size_t writeAll(int fd, const char *buf, size_t len)
+{
+  size_t done = 0;
+
+  while (done < len)
+    {
+      ssize_t n = write(fd, buf + done, len - done);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n == 0)
+	errno = ENOSPC;
+      if (n <= 0)
+	break;
+      done += n;
+    }
+  return done;
+}
+
+}
+
+AlertRecord AlertRecord::fromMsg(uint64_t time, uint16_t root, const antitheft::AlertMsg &a)
+{
+  AlertRecord r;
+
+  r.time = time;
+  r.origin = a.stolenId;
+  r.seq = a.packetId;
+  r.voltage = a.voltageData;
+  r.root = root;
+  r.path[0] = a.path1;
+  r.path[1] = a.path2;
+  r.path[2] = a.path3;
+  r.path[3] = a.path4;
+  r.path[4] = a.path5;
+  r.path[5] = a.path6;
+  r.ignoredId = a.ignoredId;
+  r.settingsVersion = a.settingsVersion;
+
+  return r;
+}
+
+void ArchiveIndex::clear()
+{
+  memset(this, 0, sizeof *this);
+  magic = INDEX_MAGIC;
+  firstTime = UINT64_MAX;
+}
+
+void ArchiveIndex::add(const AlertRecord &r)
+{
+  if (r.time < firstTime)
+    firstTime = r.time;
+  if (r.time > lastTime)
+    lastTime = r.time;
+  nodeMask[r.origin % ARCHIVE_NODE_MASK_BITS / 64] |= 1ULL << r.origin % 64;
+  for (int i = 0; i < 6; i++)
+    if (r.path[i] != ARCHIVE_NO_NODE)
+      nodeMask[r.path[i] % ARCHIVE_NODE_MASK_BITS / 64] |= 1ULL << r.path[i] % 64;
+  count++;
+}
+
+bool ArchiveIndex::mayMatch(uint64_t from, uint64_t to, int node) const
+{
+  if (lastTime < from || firstTime > to)
+    return false;
+  return node < 0 ||
+    nodeMask[node % ARCHIVE_NODE_MASK_BITS / 64] & 1ULL << node % 64;
+}
+
+bool ArchiveWriter::open(const char *path, std::string &error)
+{
+  struct stat st;
+  ArchiveHeader h;
+  size_t records;
+  off_t end;
+
+  fd = ::open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || fstat(fd, &st) < 0)
+    {
+      error = std::string(path) + ": " + strerror(errno);
+      close();
+      return false;
+    }
+
+  if (st.st_size == 0)
+    {
+      memset(&h, 0, sizeof h);
+      memcpy(h.magic, ARCHIVE_MAGIC, sizeof h.magic);
+      h.version = ARCHIVE_VERSION;
+      h.recordSize = sizeof(AlertRecord);
+      h.segmentRecords = ARCHIVE_SEGMENT_RECORDS;
+      h.indexSize = sizeof(ArchiveIndex);
+      h.byteOrder = BYTE_ORDER_MARK;
+      if (writeAll(fd, (const char *)&h, sizeof h) != sizeof h)
+	{
+	  error = std::string(path) + ": " + strerror(errno);
+	  close();
+	  return false;
+	}
+      st.st_size = sizeof h;
+    }
+  else if (pread(fd, &h, sizeof h, 0) != sizeof h || !validHeader(h))
+    {
+      error = std::string(path) + ": not an alert archive for this host";
+      close();
+      return false;
+    }
+  this->path = path;
+
+  /* Drop anything past the last whole record of the current segment
+     (including a half-written index block), then rebuild the segment's
+     summary from the records already in it. */
+  records = recordCount(st.st_size - sizeof h);
+  segmentFill = records % ARCHIVE_SEGMENT_RECORDS;
+  if (segmentFill == 0 && records > 0 &&
+      (st.st_size - sizeof h) % SEGMENT_BYTES != 0)
+    segmentFill = ARCHIVE_SEGMENT_RECORDS;
+  end = sizeof h + (records - segmentFill) / ARCHIVE_SEGMENT_RECORDS * SEGMENT_BYTES +
+    segmentFill * sizeof(AlertRecord);
+  if (ftruncate(fd, end) < 0 || lseek(fd, end, SEEK_SET) < 0)
+    {
+      error = std::string(path) + ": " + strerror(errno);
+      close();
+      return false;
+    }
+
+  index.clear();
+  for (uint32_t i = 0; i < segmentFill; i++)
+    {
+      AlertRecord r;
+
+      if (pread(fd, &r, sizeof r, end - (segmentFill - i) * sizeof r) != sizeof r)
+	break;
+      index.add(r);
+    }
+
+  /* A full segment whose index block was lost gets it written now */
+  if (segmentFill == ARCHIVE_SEGMENT_RECORDS)
+    {
+      memcpy(buf, &index, sizeof index);
+      used = sizeof index;
+      segmentFill = 0;
+      index.clear();
+    }
+
+  return true;
+}
+
+bool ArchiveWriter::append(const AlertRecord &r)
+{
+  /* Leave room for this record and the index block it may complete */
+  if (used > sizeof buf - sizeof r - sizeof index)
+    flush();
+  if (used > sizeof buf - sizeof r - sizeof index)
+    return false;
+
+  memcpy(buf + used, &r, sizeof r);
+  used += sizeof r;
+  index.add(r);
+
+  if (++segmentFill == ARCHIVE_SEGMENT_RECORDS)
+    {
+      memcpy(buf + used, &index, sizeof index);
+      used += sizeof index;
+      segmentFill = 0;
+      index.clear();
+    }
+
+  return true;
+}
+
+bool ArchiveWriter::flush()
+{
+  size_t written;
+
+  if (fd < 0 || used == 0)
+    return used == 0;
+  written = writeAll(fd, buf, used);
+  if (written < used)
+    {
+      /* The file ends with what was written, so the rest follows it
+	 when the next flush succeeds */
+      lastError = path + ": " + strerror(errno);
+      memmove(buf, buf + written, used - written);
+      used -= written;
+      return false;
+    }
+  used = 0;
+  return true;
+}
+
+void ArchiveWriter::close()
+{
+  if (fd >= 0)
+    {
+      flush();
+      ::close(fd);
+    }
+  fd = -1;
+}
+
+bool ArchiveReader::open(const char *path, std::string &error)
+{
+  int fd = ::open(path, O_RDONLY);
+  struct stat st;
+
+  close();
+  if (fd < 0 || fstat(fd, &st) < 0)
+    {
+      error = std::string(path) + ": " + strerror(errno);
+      if (fd >= 0)
+	::close(fd);
+      return false;
+    }
+  if ((size_t)st.st_size < sizeof(ArchiveHeader))
+    {
+      error = std::string(path) + ": not an alert archive";
+      ::close(fd);
+      return false;
+    }
+
+  length = st.st_size;
+  base = (const char *)mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED)
+    {
+      error = std::string(path) + ": " + strerror(errno);
+      base = NULL;
+      return false;
+    }
+  if (!validHeader(*(const ArchiveHeader *)base))
+    {
+      error = std::string(path) + ": not an alert archive for this host";
+      close();
+      return false;
+    }
+  madvise((void *)base, length, MADV_SEQUENTIAL);
+  records = recordCount(length - sizeof(ArchiveHeader));
+
+  return true;
+}
+
+void ArchiveReader::close()
+{
+  if (base)
+    munmap((void *)base, length);
+  base = NULL;
+  length = records = 0;
+}
+
+const AlertRecord *ArchiveReader::segment(size_t s) const
+{
+  return (const AlertRecord *)(base + sizeof(ArchiveHeader) + s * SEGMENT_BYTES);
+}
+
+const ArchiveIndex *ArchiveReader::segmentIndex(size_t s) const
+{
+  size_t offset = sizeof(ArchiveHeader) + (s + 1) * SEGMENT_BYTES - sizeof(ArchiveIndex);
+  const ArchiveIndex *index = (const ArchiveIndex *)(base + offset);
+
+  if (offset + sizeof(ArchiveIndex) > length || index->magic != INDEX_MAGIC)
+    return NULL;
+  return index;
+}
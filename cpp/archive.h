@@ -0,0 +1,166 @@
+/**
+ * Append-only binary archive of theft alerts.
+ *
+ * The file is a header followed by segments. A segment holds
+ * ARCHIVE_SEGMENT_RECORDS fixed-size records followed by an index block
+ * summarising them (time range and the nodes that appear), so a reader
+ * can skip whole segments that cannot match a query. The last segment is
+ * usually incomplete and has no index block yet; readers scan it record
+ * by record. Records are stored in host byte order, which the header
+ * records.
+ */
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "antitheft_codec.h"
+
+enum {
+  ARCHIVE_VERSION = 1,
+  ARCHIVE_SEGMENT_RECORDS = 4096,
+  /* Bits in an index block's node mask: node n sets bit n % this */
+  ARCHIVE_NODE_MASK_BITS = 1024,
+  /* Path entries of alerts that do not hold a node */
+  ARCHIVE_NO_NODE = 999
+};
+
+/* One archived alert */
+struct AlertRecord
+{
+  uint64_t time;		/* host reception time, ms since the epoch */
+  uint16_t origin;		/* stolenId */
+  uint16_t seq;			/* packetId */
+  uint16_t voltage;
+  uint16_t root;		/* root that forwarded it to the PC */
+  uint16_t path[6];		/* path1 (last hop) .. path6 */
+  uint16_t ignoredId;
+  uint16_t settingsVersion;
+
+  /* True if node originated or relayed this alert */
+  bool involves(uint16_t node) const
+  {
+    if (origin == node)
+      return true;
+    for (int i = 0; i < 6; i++)
+      if (path[i] == node)
+	return true;
+    return false;
+  }
+
+  static AlertRecord fromMsg(uint64_t time, uint16_t root, const antitheft::AlertMsg &a);
+};
+
+struct ArchiveHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t segmentRecords;
+  uint32_t indexSize;
+  uint32_t byteOrder;		/* 0x01020304 as written by the archiver */
+  uint32_t reserved;
+};
+
+struct ArchiveIndex
+{
+  uint32_t magic;
+  uint32_t count;
+  uint64_t firstTime, lastTime;	/* smallest and largest record time */
+  uint64_t nodeMask[ARCHIVE_NODE_MASK_BITS / 64];
+
+  void clear();
+  void add(const AlertRecord &r);
+  bool mayMatch(uint64_t from, uint64_t to, int node) const;
+};
+
+class ArchiveWriter
+{
+ public:
+  ArchiveWriter() : fd(-1), used(0), segmentFill(0) { }
+  ~ArchiveWriter() { close(); }
+
+  /* Open or create the archive at path. An existing archive is appended
+     to; a partial record left by a crash is discarded. */
+  bool open(const char *path, std::string &error);
+
+  /* Buffer r, writing out the buffer first if it is full. Returns false
+     if r was dropped because the buffered records could not be written */
+  bool append(const AlertRecord &r);
+
+  /* Write buffered records to the file. Whatever could not be written
+     stays buffered for the next flush, and error() says why */
+  bool flush();
+  const std::string &error() const { return lastError; }
+
+  void close();
+
+ private:
+  enum { BUFFERED = 256 };
+
+  int fd;
+  std::string path, lastError;
+  char buf[BUFFERED * sizeof(AlertRecord) + sizeof(ArchiveIndex)];
+  size_t used;
+  uint32_t segmentFill;		/* records in the current segment */
+  ArchiveIndex index;		/* summary of the current segment */
+};
+
+class ArchiveReader
+{
+ public:
+  ArchiveReader() : base(NULL), length(0), records(0) { }
+  ~ArchiveReader() { close(); }
+
+  /* Map the archive at path */
+  bool open(const char *path, std::string &error);
+  void close();
+
+  /* Number of records in the archive */
+  size_t size() const { return records; }
+
+  /* Call match(record) for every record received in [from, to] that
+     involves node (any node if node < 0), in archive order. Returns the
+     number of matches. */
+  template <class F>
+  size_t scan(uint64_t from, uint64_t to, int node, F match) const;
+
+ private:
+  const char *base;
+  size_t length, records;
+
+  const AlertRecord *segment(size_t s) const;
+  const ArchiveIndex *segmentIndex(size_t s) const;
+};
+
+template <class F>
+size_t ArchiveReader::scan(uint64_t from, uint64_t to, int node, F match) const
+{
+  size_t found = 0;
+
+  for (size_t s = 0; s * ARCHIVE_SEGMENT_RECORDS < records; s++)
+    {
+      const ArchiveIndex *index = segmentIndex(s);
+      const AlertRecord *r = segment(s);
+      size_t count = records - s * ARCHIVE_SEGMENT_RECORDS;
+
+      if (count > ARCHIVE_SEGMENT_RECORDS)
+	count = ARCHIVE_SEGMENT_RECORDS;
+      if (index && !index->mayMatch(from, to, node))
+	continue;
+
+      for (size_t i = 0; i < count; i++)
+	if (r[i].time >= from && r[i].time <= to &&
+	    (node < 0 || r[i].involves(node)))
+	  {
+	    match(r[i]);
+	    found++;
+	  }
+    }
+
+  return found;
+}
+
+#endif
@@ -0,0 +1,495 @@
+/**
+ * Forwarding game simulation kernel.
+ */
+#include "forwardgame.h"
+#include "parallel.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+
+GameParams::GameParams()
+  : benefit(1), cost(0.002), alertRate(0.02), detection(0.5), threshold(0.5),
+    gain(0.05), duration(100), epoch(200), learning(0.2), rationality(10),
+    initial(0.5), loss(0)
+{
+}
+
+namespace {
+
+void generateGrid(Topology &t, unsigned width, unsigned height)
+{
+  for (unsigned y = 0; y < height; y++)
+    for (unsigned x = 0; x < width; x++)
+      {
+	uint16_t v = y * width + x;
+
+	if (x + 1 < width)
+	  {
+	    t.addLink(v + 1, v);
+	    if (v)
+	      t.addLink(v, v + 1);
+	  }
+	if (y + 1 < height)
+	  {
+	    t.addLink(v + width, v);
+	    if (v)
+	      t.addLink(v, v + width);
+	  }
+      }
+}
+
+void generateRandom(Topology &t, unsigned n, double radius, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> unit(0, 1);
+  std::vector<double> x(n), y(n);
+
+  for (unsigned v = 0; v < n; v++)
+    {
+      x[v] = unit(rng);
+      y[v] = unit(rng);
+    }
+  for (unsigned v = 0; v < n; v++)
+    for (unsigned w = v + 1; w < n; w++)
+      if (hypot(x[v] - x[w], y[v] - y[w]) <= radius)
+	{
+	  t.addLink(w, v);
+	  if (v)
+	    t.addLink(v, w);
+	}
+}
+
+/* The simulation state of one replica, one array per quantity */
+class Game
+{
+ public:
+  Game(const GameNetwork &net, const GameParams &p, uint64_t seed);
+  GameResult play(uint64_t epochs);
+
+ private:
+  const Graph &g;
+  const GameNetwork &net;
+  const GameParams &p;
+  std::mt19937_64 rng;
+  std::uniform_real_distribution<double> unit;
+  std::geometric_distribution<uint64_t> skip;
+  uint64_t unobserved;		/* decisions until the next observed one */
+
+  std::vector<double> forwardProb, payoffForward, payoffDrop, epochPayoff, score,
+    totalPayoff;
+  std::vector<uint8_t> forwarding, tried;	/* tried: bit 0 forward, bit 1 drop */
+  std::vector<uint64_t> blacklistedUntil;
+  std::vector<uint32_t> heard;			/* id of the last alert heard */
+  std::vector<uint32_t> queue;
+  uint32_t alertId;
+  uint64_t round;
+
+  /* Counters over the current measurement period */
+  uint64_t alerts, delivered, transmissions, blacklists, blacklistedRounds;
+
+  bool active(uint32_t v) const { return round >= blacklistedUntil[v]; }
+  void observe(uint32_t v, bool forwarded);
+  void flood(uint32_t origin);
+  void revise();
+};
+
+Game::Game(const GameNetwork &net, const GameParams &p, uint64_t seed)
+  : g(net.graph), net(net), p(p), rng(seed), unit(0, 1),
+    skip(std::min(std::max(p.detection, 1e-12), 1.0)), unobserved(skip(rng)),
+    forwardProb(g.size(), p.initial), payoffForward(g.size()), payoffDrop(g.size()),
+    epochPayoff(g.size()), score(g.size(), 1), totalPayoff(g.size()),
+    forwarding(g.size()), tried(g.size()), blacklistedUntil(g.size()),
+    heard(g.size()), alertId(0), round(0), alerts(0), delivered(0),
+    transmissions(0), blacklists(0), blacklistedRounds(0)
+{
+  queue.reserve(g.size());
+}
+
+void Game::observe(uint32_t v, bool forwarded)
+{
+  /* Observed decisions are a Bernoulli process too */
+  if (unobserved)
+    {
+      unobserved--;
+      return;
+    }
+  unobserved = skip(rng);
+
+  score[v] += p.gain * ((forwarded ? 1 : 0) - score[v]);
+  if (score[v] < p.threshold)
+    {
+      blacklistedUntil[v] = round + p.duration;
+      score[v] = 1;
+      blacklists++;
+    }
+}
+
+void Game::flood(uint32_t origin)
+{
+  bool reached = false;
+
+  alertId++;
+  alerts++;
+  heard[origin] = alertId;
+  epochPayoff[origin] -= p.cost;
+  transmissions++;
+  queue.clear();
+  queue.push_back(origin);
+
+  for (size_t head = 0; head < queue.size(); head++)
+    {
+      uint32_t u = queue[head];
+
+      for (uint32_t e = g.outStart[u]; e < g.outStart[u + 1]; e++)
+	{
+	  uint32_t w = g.out[e];
+
+	  if (heard[w] == alertId)
+	    continue;
+	  heard[w] = alertId;
+	  if (net.root[w])
+	    reached = true;
+	  else if (active(w))
+	    {
+	      if (forwarding[w])
+		{
+		  epochPayoff[w] -= p.cost;
+		  transmissions++;
+		  queue.push_back(w);
+		}
+	      observe(w, forwarding[w] && (p.loss <= 0 || unit(rng) >= p.loss));
+	    }
+	}
+    }
+
+  if (reached)
+    {
+      epochPayoff[origin] += p.benefit;
+      delivered++;
+    }
+}
+
+/* End of an epoch: fold each node's payoff into the estimate for the
+   action it played, and choose next epoch's action */
+void Game::revise()
+{
+  /* Payoffs are measured against the most a node can gain per round */
+  double scale = std::max(p.benefit * p.alertRate, 1e-12);
+
+  for (size_t v = 0; v < g.size(); v++)
+    {
+      double earned = epochPayoff[v] / p.epoch, diff;
+      uint8_t action = forwarding[v] ? 1 : 2;
+      double &estimate = forwarding[v] ? payoffForward[v] : payoffDrop[v];
+
+      if (net.root[v])
+	continue;
+      totalPayoff[v] += epochPayoff[v];
+      epochPayoff[v] = 0;
+
+      /* The first payoff seen for an action is taken as is */
+      estimate += (tried[v] & action ? p.learning : 1) * (earned - estimate);
+      tried[v] |= action;
+      if (tried[v] == 3)
+	{
+	  diff = p.rationality * (payoffForward[v] - payoffDrop[v]) / scale;
+	  forwardProb[v] = 1 / (1 + exp(-std::max(-50.0, std::min(50.0, diff))));
+	}
+      forwarding[v] = unit(rng) < forwardProb[v];
+    }
+}
+
+GameResult Game::play(uint64_t epochs)
+{
+  GameResult r;
+  uint64_t measureFrom = epochs - std::max<uint64_t>(epochs / 10, 1);
+  double rate = std::min(std::max(p.alertRate, 1e-12), 1.0);
+  std::geometric_distribution<uint64_t> gap(rate);
+  uint64_t next = gap(rng), slots = g.size();
+
+  for (size_t v = 0; v < g.size(); v++)
+    forwarding[v] = unit(rng) < forwardProb[v];
+
+  for (uint64_t e = 0; e < epochs; e++)
+    {
+      if (e == measureFrom)
+	{
+	  alerts = delivered = transmissions = blacklists = blacklistedRounds = 0;
+	  std::fill(totalPayoff.begin(), totalPayoff.end(), 0);
+	}
+
+      uint64_t epochStart = e * p.epoch, epochEnd = epochStart + p.epoch;
+
+      /* Alert origins form a Bernoulli process over (round, node) slots,
+	 so jump straight from one origin to the next */
+      for (; next < epochEnd * slots; next += 1 + gap(rng))
+	{
+	  uint32_t v = next % slots;
+
+	  round = next / slots;
+	  if (!net.root[v] && active(v))
+	    flood(v);
+	}
+      round = epochEnd;
+
+      for (size_t v = 0; v < g.size(); v++)
+	if (blacklistedUntil[v] > epochStart)
+	  blacklistedRounds += std::min(blacklistedUntil[v], epochEnd) -
+	    std::max(blacklistedUntil[v] - p.duration, epochStart);
+
+      revise();
+
+      double sum = 0;
+      for (size_t v = 0; v < g.size(); v++)
+	if (!net.root[v])
+	  sum += forwardProb[v];
+      r.trajectory.push_back(net.players ? sum / net.players : 0);
+    }
+
+  uint64_t measured = (epochs - measureFrom) * p.epoch;
+  double total = 0, finalCoop = 0;
+
+  for (uint64_t e = measureFrom; e < epochs; e++)
+    finalCoop += r.trajectory[e];
+  finalCoop /= epochs - measureFrom;
+
+  r.converged = 0;
+  for (uint64_t e = epochs; e-- > 0; )
+    if (fabs(r.trajectory[e] - finalCoop) > GAME_CONVERGED)
+      {
+	r.converged = (e + 1) * p.epoch;
+	break;
+      }
+
+  r.forwardProb = forwardProb;
+  r.nodePayoff.resize(g.size());
+  for (size_t v = 0; v < g.size(); v++)
+    {
+      r.nodePayoff[v] = totalPayoff[v] / measured;
+      total += totalPayoff[v];
+    }
+  r.cooperation = finalCoop;
+  r.delivery = alerts ? (double)delivered / alerts : 0;
+  r.payoff = net.players ? total / measured / net.players : 0;
+  r.blacklisted = net.players ? (double)blacklistedRounds / measured / net.players : 0;
+  r.alerts = alerts;
+  r.delivered = delivered;
+  r.transmissions = transmissions;
+  r.blacklists = blacklists;
+
+  return r;
+}
+
+}
+
+bool loadTopology(const std::string &spec, Topology &topology, std::string &error)
+{
+  unsigned a, b, seed = 1;
+  double radius;
+  int n;
+
+  if (sscanf(spec.c_str(), "grid:%ux%u%n", &a, &b, &n) == 2 && !spec[n])
+    {
+      if (a * b < 2 || a * b > 0xffff)
+	goto bad;
+      generateGrid(topology, a, b);
+      return true;
+    }
+  if (sscanf(spec.c_str(), "line:%u%n", &a, &n) == 1 && !spec[n])
+    {
+      if (a < 2 || a > 0xffff)
+	goto bad;
+      generateGrid(topology, a, 1);
+      return true;
+    }
+  if (spec.compare(0, 7, "random:") == 0)
+    {
+      int fields = sscanf(spec.c_str(), "random:%u:%lf:%u", &a, &radius, &seed);
+
+      if (fields < 1 || a < 2 || a > 0xffff)
+	goto bad;
+      if (fields < 2)
+	radius = sqrt(3.0 / a);	/* on average about 9 neighbours */
+      generateRandom(topology, a, radius, seed);
+      return true;
+    }
+
+  {
+    FILE *in = fopen(spec.c_str(), "r");
+    bool ok;
+
+    if (!in)
+      {
+	error = spec + ": " + strerror(errno);
+	return false;
+      }
+    ok = topology.readCsv(in, error);
+    fclose(in);
+    if (!ok)
+      error = spec + ": " + error;
+    return ok;
+  }
+
+ bad:
+  error = spec + ": bad topology size";
+  return false;
+}
+
+GameNetwork gameNetwork(const Topology &topology, const std::vector<uint16_t> &roots)
+{
+  GameNetwork net;
+
+  net.graph = buildGraph(topology);
+  net.root.assign(net.graph.size(), 0);
+  for (size_t i = 0; i < roots.size(); i++)
+    {
+      int64_t v = net.graph.indexOf(roots[i]);
+
+      if (v >= 0)
+	net.root[v] = 1;
+    }
+  if (roots.empty())
+    for (size_t v = 0; v < net.graph.size(); v++)
+      net.root[v] = net.graph.outStart[v] == net.graph.outStart[v + 1];
+
+  net.players = std::count(net.root.begin(), net.root.end(), 0);
+  return net;
+}
+
+GameResult playGame(const GameNetwork &net, const GameParams &params,
+		    uint64_t rounds, uint64_t seed)
+{
+  Game game(net, params, seed);
+
+  return game.play(std::max<uint64_t>((rounds + params.epoch - 1) / params.epoch, 1));
+}
+
+unsigned dropsToBlacklist(const GameParams &params)
+{
+  double score = 1;
+  unsigned drops = 0;
+
+  if (params.threshold <= 0 || params.gain <= 0)
+    return UINT_MAX;
+  while (score >= params.threshold)
+    {
+      score -= params.gain * score;
+      drops++;
+    }
+  return drops;
+}
+
+double safeThreshold(double gain, double loss)
+{
+  /* Stationary deviation of an EWMA of Bernoulli(1 - loss) samples */
+  double sd = sqrt(gain / (2 - gain) * loss * (1 - loss));
+
+  return std::max(0.05, std::min(0.95, 1 - loss - 3 * sd));
+}
+
+IncentiveSolution solveIncentives(const GameNetwork &net, const GameParams &p,
+				  uint32_t maxDuration, double margin, unsigned threads)
+{
+  const Graph &g = net.graph;
+  IncentiveSolution sol;
+  std::vector<uint8_t> forwards(g.size());
+  std::vector<uint8_t> delivered(g.size());
+
+  threads = defaultThreads(threads);
+  sol.nodes.resize(g.size());
+  sol.drops = dropsToBlacklist(p);
+  sol.converged = false;
+  for (size_t v = 0; v < g.size(); v++)
+    forwards[v] = !net.root[v];
+
+  for (sol.iterations = 1; sol.iterations <= SOLVE_MAX_ITERATIONS; sol.iterations++)
+    {
+      std::vector<std::vector<uint32_t> > heard(threads, std::vector<uint32_t>(g.size()));
+      bool changed = false;
+
+      /* Flood every origin through the current forwarders */
+      parallelFor(g.size(), threads, [&](size_t origin, unsigned t) {
+	  std::vector<uint8_t> reached(g.size());
+	  std::vector<uint32_t> queue(1, origin);
+	  bool root = false;
+
+	  if (net.root[origin])
+	    return;
+	  reached[origin] = 1;
+	  for (size_t head = 0; head < queue.size(); head++)
+	    for (uint32_t e = g.outStart[queue[head]]; e < g.outStart[queue[head] + 1]; e++)
+	      {
+		uint32_t w = g.out[e];
+
+		if (reached[w])
+		  continue;
+		reached[w] = 1;
+		if (net.root[w])
+		  root = true;
+		else
+		  {
+		    heard[t][w]++;
+		    if (forwards[w])
+		      queue.push_back(w);
+		  }
+	      }
+	  delivered[origin] = root;
+	});
+
+      for (size_t v = 0; v < g.size(); v++)
+	{
+	  Incentive &n = sol.nodes[v];
+	  double own, saved;
+	  bool best;
+
+	  if (net.root[v])
+	    continue;
+	  n.heard = 0;
+	  for (unsigned t = 0; t < threads; t++)
+	    n.heard += heard[t][v];
+	  n.heard *= p.alertRate;
+	  n.delivery = delivered[v];
+
+	  own = (p.benefit * n.delivery - p.cost) * p.alertRate;
+	  saved = p.cost * n.heard;
+	  if (saved <= 0)
+	    n.required = 0;
+	  else if ((1 - margin) * own <= saved || p.detection <= 0)
+	    n.required = HUGE_VAL;
+	  else
+	    n.required = sol.drops / (p.detection * n.heard) *
+	      (saved + margin * own) / ((1 - margin) * own - saved);
+
+	  best = n.required <= maxDuration;
+	  changed |= best != (bool)forwards[v];
+	  forwards[v] = best;
+	  n.forwards = best;
+	}
+
+      if (!changed)
+	{
+	  sol.converged = true;
+	  break;
+	}
+    }
+  if (!sol.converged)
+    sol.iterations--;
+
+  double longest = 0;
+  sol.forwarding = 0;
+  for (size_t v = 0; v < g.size(); v++)
+    if (!net.root[v] && sol.nodes[v].forwards)
+      {
+	longest = std::max(longest, sol.nodes[v].required);
+	sol.forwarding++;
+      }
+  sol.duration = std::max(1.0, ceil(longest));
+
+  return sol;
+}
@@ -0,0 +1,152 @@
+/**
+ * The repeated forwarding game played by AntiTheft nodes.
+ *
+ * Alerts are flooded: a node that hears an alert may rebroadcast it,
+ * paying the energy of a transmission, or drop it. Every node wants its
+ * own alerts to reach a root, which takes other nodes forwarding them.
+ * Drops are observed (with some probability) by the reputation engine of
+ * reputation.h, and a node whose score falls below the threshold is
+ * blacklisted: as in SettingsValue.changed / BlacklistSleep in
+ * AntiTheftC, its radio stays off for the blacklist duration, so
+ * meanwhile it neither forwards nor gets its own alerts through. Its
+ * reputation starts afresh when the blacklist ends.
+ *
+ * A round is one check interval. Every round each node that is not
+ * blacklisted originates an alert with probability alertRate. Nodes
+ * revise their behaviour once per epoch: each epoch a node either
+ * forwards or drops everything, chosen with its current forwarding
+ * probability; the epoch's payoff updates its running estimate of what
+ * each action earns, and its forwarding probability becomes the logit
+ * response to those estimates. Cooperation that survives this learning
+ * is an equilibrium of the blacklist rule, and how fast it settles is
+ * its convergence time.
+ *
+ * solveIncentives() answers the converse question analytically: how
+ * long a blacklist must last for forwarding to be every node's best
+ * response. A node that drops everything it hears saves
+ * saved = cost * heard per round, until drops observed at rate
+ * detection * heard have pushed its reputation below the threshold
+ * (after T = drops / (detection * heard) rounds, drops being the number
+ * of observed drops that take a reputation from 1 below the threshold).
+ * It then loses own, the net payoff of its own alerts, for the blacklist
+ * duration D, so dropping earns T * own / (T + D) per round against
+ * own - saved for forwarding. Requiring forwarding to win by a margin m
+ * of own, so that noisy or boundedly rational nodes still prefer it,
+ *
+ *   D >= T * (saved + m * own) / ((1 - m) * own - saved)
+ *
+ * Nodes for which (1 - m) * own <= saved cannot be made to forward by a
+ * blacklist at all. Since heard and own depend on who else forwards,
+ * the solver iterates best responses to a fixed point.
+ *
+ * Simulation state is kept as one array per quantity over dense node
+ * indices, and independent replicas run on separate threads.
+ */
+#ifndef FORWARDGAME_H
+#define FORWARDGAME_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "topology.h"
+
+struct GameParams
+{
+  double benefit;		/* payoff of one own alert reaching a root */
+  double cost;			/* cost of one transmission */
+  double alertRate;		/* chance a node originates an alert in a round */
+  double detection;		/* chance a forward or drop is observed */
+  double threshold;		/* reputation below which a node is blacklisted */
+  double gain;			/* weight of one observation in the reputation */
+  uint32_t duration;		/* blacklist duration (rounds) */
+  uint32_t epoch;		/* rounds between strategy revisions */
+  double learning;		/* weight of an epoch in the payoff estimates */
+  double rationality;		/* logit sensitivity to payoff differences */
+  double initial;		/* initial forwarding probability */
+  double loss;			/* chance a forward looks like a drop (lost copy) */
+
+  GameParams();
+};
+
+/* The game's network: a graph plus which of its nodes are roots */
+struct GameNetwork
+{
+  Graph graph;
+  std::vector<uint8_t> root;	/* per index */
+  size_t players;		/* nodes that are not roots */
+};
+
+struct GameResult
+{
+  /* Over the last tenth of the run */
+  double cooperation;		/* mean forwarding probability */
+  double delivery;		/* alerts that reached a root */
+  double payoff;		/* mean payoff per node and round */
+  double blacklisted;		/* fraction of nodes blacklisted per round */
+
+  /* First round after which the mean forwarding probability stays
+     within GAME_CONVERGED of its final value */
+  uint64_t converged;
+
+  uint64_t alerts, delivered, transmissions, blacklists;
+  std::vector<double> trajectory;	/* mean forwarding probability per epoch */
+  std::vector<double> forwardProb;	/* final forwarding probability per index */
+  std::vector<double> nodePayoff;	/* mean payoff per round, per index */
+};
+
+/* A node's incentives when others behave as in the solution */
+struct Incentive
+{
+  double heard;			/* alerts it hears per round */
+  double delivery;		/* chance its own alerts reach a root */
+  double required;		/* blacklist duration (rounds) that makes forwarding
+				   its best response; HUGE_VAL if none does */
+  bool forwards;		/* its best response under the solution */
+};
+
+struct IncentiveSolution
+{
+  std::vector<Incentive> nodes;	/* per index */
+  uint32_t duration;		/* shortest blacklist that works for all forwarders */
+  unsigned drops;		/* observed drops that trigger a blacklist */
+  unsigned iterations;		/* best-response rounds to the fixed point */
+  bool converged;		/* false if best responses kept cycling */
+  size_t forwarding;		/* players that forward */
+};
+
+/* Tolerance of GameResult::converged */
+const double GAME_CONVERGED = 0.02;
+
+/* Best-response iterations after which solveIncentives gives up */
+const unsigned SOLVE_MAX_ITERATIONS = 100;
+
+/* Build a topology from a spec: grid:WxH, line:N or random:N[:radius[:seed]]
+   generate one with root 0 (links into the root only, as roots never
+   send alerts), anything else is read as a link CSV (alertscan -l) */
+bool loadTopology(const std::string &spec, Topology &topology, std::string &error);
+
+/* Roots are the given nodes, or if there are none the nodes without
+   outgoing links */
+GameNetwork gameNetwork(const Topology &topology, const std::vector<uint16_t> &roots);
+
+/* Play rounds rounds of the game (rounded up to whole epochs) */
+GameResult playGame(const GameNetwork &net, const GameParams &params,
+		    uint64_t rounds, uint64_t seed);
+
+/* Observed drops that take a reputation from 1 below params.threshold */
+unsigned dropsToBlacklist(const GameParams &params);
+
+/* A threshold that a node losing a fraction loss of its forwards is
+   unlikely to fall below: three standard deviations under its mean score */
+double safeThreshold(double gain, double loss);
+
+/* Best-response dynamics from everybody forwarding, with blacklists of
+   at most maxDuration rounds and the given payoff margin (0 .. 1).
+   Each iteration floods every origin once, in parallel over origins. */
+IncentiveSolution solveIncentives(const GameNetwork &net, const GameParams &params,
+				  uint32_t maxDuration, double margin,
+				  unsigned threads = 0);
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * Simulate the repeated forwarding game under the blacklist rule (see
+ * forwardgame.h) and report the cooperation it settles at.
+ *
+ * Usage: forwardsim [options] [topology]
+ *   topology  grid:WxH, line:N, random:N[:radius[:seed]] or a link CSV
+ *             written by alertscan -l (default grid:10x10)
+ *   -r root   a root node (repeatable; default: nodes with no out-links)
+ *   -R rounds rounds per replica (default 100000)
+ *   -n count  independent replicas (default 8), run on -j threads
+ *             (default one per core)
+ *   -b, -c    benefit of a delivered own alert, cost of a transmission
+ *   -p        chance a node originates an alert in a round
+ *   -q        chance a forward or drop is observed
+ *   -T, -G    reputation threshold and gain
+ *   -d        blacklist duration (rounds)
+ *   -e        rounds per strategy revision
+ *   -i        initial forwarding probability
+ *   -s seed   seed of the first replica
+ *   -o file   per-node results (CSV)
+ *   -x file   mean forwarding probability per epoch (CSV)
+ *
+ * A round is one check interval, so a duration of d rounds corresponds
+ * to a settings_t duration of d times the check interval.
+ *
+ * Run time grows with nodes x rounds x replicas: the defaults on
+ * grid:10x10 take about 8 s of CPU time (split over -j threads). A
+ * blacklisting game settles within a few tens of thousands of rounds;
+ * raise -R when the "converged" round comes close to it.
+ */
+#include "forwardgame.h"
+#include "parallel.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+void usage()
+{
+  fprintf(stderr, "Usage: forwardsim [-r root] [-R rounds] [-n replicas] [-j threads]\n"
+	  "                  [-b benefit] [-c cost] [-p alertRate] [-q detection]\n"
+	  "                  [-T threshold] [-G gain] [-d duration] [-e epoch]\n"
+	  "                  [-i initial] [-s seed] [-o nodes.csv] [-x trajectory.csv]\n"
+	  "                  [topology]\n");
+  exit(2);
+}
+
+double seconds()
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* Mean and standard deviation of one result field over the replicas */
+template <class F>
+void summarise(const char *name, const std::vector<GameResult> &results, F field)
+{
+  double sum = 0, squares = 0, n = results.size();
+
+  for (size_t i = 0; i < results.size(); i++)
+    sum += field(results[i]);
+  for (size_t i = 0; i < results.size(); i++)
+    squares += (field(results[i]) - sum / n) * (field(results[i]) - sum / n);
+  printf("%-14s %10.4f  (sd %.4f)\n", name, sum / n, n > 1 ? sqrt(squares / (n - 1)) : 0);
+}
+
+FILE *openOutput(const char *name)
+{
+  FILE *f = fopen(name, "w");
+
+  if (!f)
+    {
+      perror(name);
+      exit(1);
+    }
+  return f;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  GameParams params;
+  std::vector<uint16_t> roots;
+  uint64_t rounds = 100000, seed = 1;
+  unsigned replicas = 8, threads = 0;
+  const char *nodesFile = NULL, *trajectoryFile = NULL;
+  std::string spec = "grid:10x10", error;
+  Topology topology;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:R:n:j:b:c:p:q:T:G:d:e:i:s:o:x:")) != -1)
+    switch (opt)
+      {
+      case 'r': roots.push_back(atoi(optarg)); break;
+      case 'R': rounds = strtoull(optarg, NULL, 0); break;
+      case 'n': replicas = atoi(optarg); break;
+      case 'j': threads = atoi(optarg); break;
+      case 'b': params.benefit = atof(optarg); break;
+      case 'c': params.cost = atof(optarg); break;
+      case 'p': params.alertRate = atof(optarg); break;
+      case 'q': params.detection = atof(optarg); break;
+      case 'T': params.threshold = atof(optarg); break;
+      case 'G': params.gain = atof(optarg); break;
+      case 'd': params.duration = atoi(optarg); break;
+      case 'e': params.epoch = atoi(optarg); break;
+      case 'i': params.initial = atof(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 0); break;
+      case 'o': nodesFile = optarg; break;
+      case 'x': trajectoryFile = optarg; break;
+      default: usage();
+      }
+  if (optind < argc - 1 || replicas == 0 || params.epoch == 0)
+    usage();
+  if (optind == argc - 1)
+    spec = argv[optind];
+
+  if (!loadTopology(spec, topology, error))
+    {
+      fprintf(stderr, "forwardsim: %s\n", error.c_str());
+      return 1;
+    }
+
+  GameNetwork net = gameNetwork(topology, roots);
+  std::vector<GameResult> results(replicas);
+  double start = seconds();
+
+  parallelFor(replicas, defaultThreads(threads), [&](size_t i, unsigned) {
+      results[i] = playGame(net, params, rounds, seed + i);
+    });
+
+  printf("%s: %lu nodes, %lu links, %lu roots; %u replicas of %llu rounds in %.2f s\n",
+	 spec.c_str(), (unsigned long)net.graph.size(), (unsigned long)net.graph.out.size(),
+	 (unsigned long)(net.graph.size() - net.players), replicas,
+	 (unsigned long long)rounds, seconds() - start);
+  summarise("cooperation", results, [](const GameResult &r) { return r.cooperation; });
+  summarise("delivery", results, [](const GameResult &r) { return r.delivery; });
+  summarise("payoff/round", results, [](const GameResult &r) { return r.payoff; });
+  summarise("blacklisted", results, [](const GameResult &r) { return r.blacklisted; });
+  summarise("converged", results, [](const GameResult &r) { return (double)r.converged; });
+
+  if (nodesFile)
+    {
+      FILE *out = openOutput(nodesFile);
+
+      fprintf(out, "node,root,forwardProb,payoff\n");
+      for (size_t v = 0; v < net.graph.size(); v++)
+	{
+	  double prob = 0, payoff = 0;
+
+	  for (size_t i = 0; i < replicas; i++)
+	    {
+	      prob += results[i].forwardProb[v];
+	      payoff += results[i].nodePayoff[v];
+	    }
+	  fprintf(out, "%u,%u,%.4f,%.5f\n", net.graph.ids[v], net.root[v],
+		  prob / replicas, payoff / replicas);
+	}
+      fclose(out);
+    }
+
+  if (trajectoryFile)
+    {
+      FILE *out = openOutput(trajectoryFile);
+
+      fprintf(out, "round,cooperation\n");
+      for (size_t e = 0; e < results[0].trajectory.size(); e++)
+	{
+	  double sum = 0;
+
+	  for (size_t i = 0; i < replicas; i++)
+	    sum += results[i].trajectory[e];
+	  fprintf(out, "%llu,%.4f\n", (unsigned long long)(e + 1) * params.epoch,
+		  sum / replicas);
+	}
+      fclose(out);
+    }
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * Solve for blacklist settings under which forwarding is every node's
+ * best response (see solveIncentives in forwardgame.h).
+ *
+ * Usage: forwardsolve [options] [topology]
+ *   topology  as for forwardsim; normally the measured link CSV written
+ *             by alertscan -l
+ *   -r root   a root node (repeatable; default: nodes with no out-links)
+ *   -b, -c    benefit of a delivered own alert, energy cost of a
+ *             transmission (same unit)
+ *   -p        chance a node originates an alert in a check interval
+ *   -q        chance a forward or drop is observed
+ *   -G        reputation gain
+ *   -l        chance a forward looks like a drop (lost copies); sets
+ *             the threshold unless -T gives one
+ *   -i ms     check interval (default DEFAULT_CHECK_INTERVAL)
+ *   -m        fraction of a node's own-alert payoff by which forwarding
+ *             must beat dropping (default 0.5)
+ *   -j        threads (default one per core)
+ *   -o file   per-node incentives (CSV)
+ *   -V rounds check the solution with forwardsim's game for that many
+ *             rounds, starting from 90% forwarding
+ *
+ * If no node forwards in the best response, no setting sustains
+ * forwarding; this is reported and nothing is suggested or checked.
+ *
+ * Durations are reported in check intervals and in ms, the unit of
+ * settings_t's duration, which limits them to 65535 ms.
+ */
+#include "forwardgame.h"
+#include "antitheft_codec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace antitheft;
+
+namespace {
+
+void usage()
+{
+  fprintf(stderr, "Usage: forwardsolve [-r root] [-b benefit] [-c cost] [-p alertRate]\n"
+	  "                   [-q detection] [-G gain] [-l loss] [-T threshold]\n"
+	  "                   [-i interval] [-m margin] [-j threads] [-o nodes.csv]\n"
+	  "                   [-V rounds] [topology]\n");
+  exit(2);
+}
+
+/* Print the nodes that do not forward, for one of the two reasons */
+void listNodes(const GameNetwork &net, const IncentiveSolution &sol, bool hopeless,
+	       const char *why)
+{
+  size_t count = 0;
+
+  for (size_t v = 0; v < net.graph.size(); v++)
+    if (!net.root[v] && !sol.nodes[v].forwards &&
+	(sol.nodes[v].required == HUGE_VAL) == hopeless)
+      printf(count++ ? " %u" : "nodes %u", net.graph.ids[v]);
+  if (count)
+    printf(" %s\n", why);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  GameParams params;
+  std::vector<uint16_t> roots;
+  unsigned interval = DEFAULT_CHECK_INTERVAL, threads = 0;
+  double margin = 0.5, threshold = -1;
+  uint64_t validate = 0;
+  const char *nodesFile = NULL;
+  std::string spec = "grid:10x10", error;
+  Topology topology;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:b:c:p:q:G:l:T:i:m:j:o:V:")) != -1)
+    switch (opt)
+      {
+      case 'r': roots.push_back(atoi(optarg)); break;
+      case 'b': params.benefit = atof(optarg); break;
+      case 'c': params.cost = atof(optarg); break;
+      case 'p': params.alertRate = atof(optarg); break;
+      case 'q': params.detection = atof(optarg); break;
+      case 'G': params.gain = atof(optarg); break;
+      case 'l': params.loss = atof(optarg); break;
+      case 'T': threshold = atof(optarg); break;
+      case 'i': interval = atoi(optarg); break;
+      case 'm': margin = atof(optarg); break;
+      case 'j': threads = atoi(optarg); break;
+      case 'o': nodesFile = optarg; break;
+      case 'V': validate = strtoull(optarg, NULL, 0); break;
+      default: usage();
+      }
+  if (optind < argc - 1 || interval == 0)
+    usage();
+  if (optind == argc - 1)
+    spec = argv[optind];
+
+  if (!loadTopology(spec, topology, error))
+    {
+      fprintf(stderr, "forwardsolve: %s\n", error.c_str());
+      return 1;
+    }
+
+  GameNetwork net = gameNetwork(topology, roots);
+  params.threshold = threshold >= 0 ? threshold : safeThreshold(params.gain, params.loss);
+
+  IncentiveSolution sol = solveIncentives(net, params, 65535 / interval, margin, threads);
+
+  printf("%s: %lu nodes, %lu links, %lu roots\n", spec.c_str(),
+	 (unsigned long)net.graph.size(), (unsigned long)net.graph.out.size(),
+	 (unsigned long)(net.graph.size() - net.players));
+  printf("best responses %s after %u iterations: %lu of %lu nodes forward\n",
+	 sol.converged ? "converged" : "still cycling", sol.iterations,
+	 (unsigned long)sol.forwarding, (unsigned long)net.players);
+  /* With no node forwarding, sol.duration is just the smallest one
+     tried; no threshold or duration is worth suggesting */
+  if (sol.forwarding)
+    {
+      printf("threshold %.3f (blacklist after %u observed drops)\n", params.threshold, sol.drops);
+      printf("duration %u check intervals = %u ms at a %u ms check interval\n",
+	     sol.duration, sol.duration * interval, interval);
+    }
+  listNodes(net, sol, true, "cannot be made to forward (forwarding costs more than "
+	    "their own alerts are worth)");
+  listNodes(net, sol, false, "cannot be made to forward (they would need a longer "
+	    "blacklist than settings_t allows)");
+  if (sol.forwarding)
+    printf("run alertd with -T %.3f -D %u to blacklist by these settings\n",
+	   params.threshold, sol.duration * interval);
+  else
+    printf("no blacklist setting sustains forwarding: dropping stays every "
+	   "node's best response\n");
+
+  if (nodesFile)
+    {
+      FILE *out = fopen(nodesFile, "w");
+
+      if (!out)
+	{
+	  perror(nodesFile);
+	  return 1;
+	}
+      fprintf(out, "node,heard,delivery,required,requiredMs,forwards\n");
+      for (size_t v = 0; v < net.graph.size(); v++)
+	if (!net.root[v])
+	  {
+	    const Incentive &n = sol.nodes[v];
+
+	    fprintf(out, "%u,%.4f,%.0f,", net.graph.ids[v], n.heard, n.delivery);
+	    if (n.required == HUGE_VAL)
+	      fprintf(out, ",,");
+	    else
+	      fprintf(out, "%.2f,%.0f,", n.required, ceil(n.required * interval));
+	    fprintf(out, "%u\n", n.forwards);
+	  }
+      fclose(out);
+    }
+
+  if (validate && sol.forwarding)
+    {
+      GameResult r;
+
+      params.duration = sol.duration;
+      params.initial = 0.9;
+      r = playGame(net, params, validate, 1);
+      printf("simulated: cooperation %.4f, delivery %.4f, "
+	     "blacklisted %.4f\n", r.cooperation, r.delivery, r.blacklisted);
+    }
+
+  return 0;
+}
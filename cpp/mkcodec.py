@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+"""
+Generate a header-only C++ codec for the nx_struct message layouts and
+constants of a nesC header, much as mig and ncg do for Java.
+
+For every "typedef nx_struct name { ... } name_t;" this emits a class
+NameMsg with compile-time field offsets, in-place big-endian accessors,
+whole-message decode/encode, and a NameMsgBatch struct-of-arrays that
+decodes an array of raw frames in one pass. An array field x[N] gets
+indexed accessors get_x(p, i) / set_x(p, i, v), and one column per
+element (x0, x1, ...) in the batch.
+
+Usage: mkcodec.py header.h -o output.h
+"""
+import re
+import sys
+
+NX_TYPES = {
+    'nx_uint8_t': ('uint8_t', 1), 'nx_int8_t': ('int8_t', 1),
+    'nx_uint16_t': ('uint16_t', 2), 'nx_int16_t': ('int16_t', 2),
+    'nx_uint32_t': ('uint32_t', 4), 'nx_int32_t': ('int32_t', 4),
+}
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def evaluate(expr, values):
+    """Value of an integer constant expression over known names, or None."""
+    expr = re.sub(r'\b[A-Za-z_]\w*\b',
+                  lambda m: str(values[m.group(0)]) if m.group(0) in values else '?',
+                  expr)
+    if not re.match(r'^[\s\w()+\-*/<>|&]*$', expr):
+        return None
+    try:
+        return int(eval(expr.replace('/', '//'), {'__builtins__': {}}))
+    except (SyntaxError, NameError, ValueError, ZeroDivisionError):
+        return None
+
+
+def parse_enums(text):
+    """Return [(name, value)] for all enum constants with a known value."""
+    consts, values = [], {}
+    # Compile-time defaults (#ifndef X #define X value) that enums refer to
+    for name, value in re.findall(r'#define\s+(\w+)\s+(\w+)\s*$', text, re.M):
+        try:
+            values[name] = int(value, 0)
+        except ValueError:
+            pass
+    for body in re.findall(r'enum\s*\w*\s*\{(.*?)\}', text, re.S):
+        for item in body.split(','):
+            m = re.match(r'\s*(\w+)\s*=\s*(.+?)\s*$', item, re.S)
+            if not m:
+                continue
+            name, value = m.group(1), evaluate(m.group(2), values)
+            if value is None:
+                continue
+            values[name] = value
+            consts.append((name, value))
+    return consts
+
+
+def parse_structs(text, consts):
+    """Return [(name, [(field, ctype, size, offset, count)], total size)],
+    where count is the number of elements of an array field and None for
+    a scalar."""
+    structs = []
+    values = dict(consts)
+    pattern = r'typedef\s+nx_struct\s+(\w+)\s*\{(.*?)\}\s*(\w+)\s*;'
+    for name, body, _ in re.findall(pattern, text, re.S):
+        fields, offset = [], 0
+        for decl in body.split(';'):
+            decl = decl.strip()
+            if not decl:
+                continue
+            nxtype, names = decl.split(None, 1)
+            if nxtype not in NX_TYPES:
+                sys.exit('mkcodec: %s: unsupported field type %s' % (name, nxtype))
+            ctype, size = NX_TYPES[nxtype]
+            for field in names.split(','):
+                m = re.match(r'\s*(\w+)\s*(?:\[(.*)\])?\s*$', field)
+                count = None
+                if m.group(2) is not None:
+                    count = evaluate(m.group(2), values)
+                    if not count:
+                        sys.exit('mkcodec: %s: bad array size %s' % (name, m.group(2)))
+                fields.append((m.group(1), ctype, size, offset, count))
+                offset += size * (count or 1)
+        structs.append((name, fields, offset))
+    return structs
+
+
+def columns(fields):
+    """Return the batch columns [(column, ctype, size, field, index)]: one
+    per scalar field and one per array element, whose index is the extra
+    argument to the field's getter."""
+    cols = []
+    for f, ctype, fsize, _, count in fields:
+        if count is None:
+            cols.append((f, ctype, fsize, f, ''))
+        else:
+            for i in range(count):
+                cols.append(('%s%d' % (f, i), ctype, fsize, f, ', %d' % i))
+    return cols
+
+
+def class_name(struct):
+    return ''.join(w.capitalize() for w in struct.split('_')) + 'Msg'
+
+
+def emit_struct(out, name, fields, size, consts):
+    cls = class_name(name)
+    am = 'AM_' + name.upper()
+    out.append('/* nx_struct %s */' % name)
+    out.append('struct %s' % cls)
+    out.append('{')
+    out.append('  static const size_t SIZE = %d;' % size)
+    if am in consts:
+        out.append('  static const uint8_t AM_TYPE = %s;' % am)
+    out.append('')
+    out.append('  /* Byte offset of each field, and element count of each array */')
+    out.append('  enum {')
+    out.append(',\n'.join(['    OFFSET_%s = %d' % (f[0], f[3]) for f in fields] +
+                          ['    COUNT_%s = %d' % (f[0], f[4]) for f in fields if f[4]]))
+    out.append('  };')
+    out.append('')
+    for f, ctype, _, _, count in fields:
+        out.append('  %s %s%s;' % (ctype, f, '[%d]' % count if count else ''))
+    out.append('')
+    out.append('  /* Access a field of an encoded message in place */')
+    for f, ctype, fsize, _, count in fields:
+        if count is None:
+            out.append('  static %s get_%s(const uint8_t *p) { return (%s)loadBE%d(p + OFFSET_%s); }'
+                       % (ctype, f, ctype, fsize * 8, f))
+            out.append('  static void set_%s(uint8_t *p, %s v) { storeBE%d(p + OFFSET_%s, v); }'
+                       % (f, ctype, fsize * 8, f))
+        else:
+            out.append('  static %s get_%s(const uint8_t *p, size_t i) '
+                       '{ return (%s)loadBE%d(p + OFFSET_%s + i * %d); }'
+                       % (ctype, f, ctype, fsize * 8, f, fsize))
+            out.append('  static void set_%s(uint8_t *p, size_t i, %s v) '
+                       '{ storeBE%d(p + OFFSET_%s + i * %d, v); }'
+                       % (f, ctype, fsize * 8, f, fsize))
+    out.append('')
+    out.append('  static %s decode(const uint8_t *p)' % cls)
+    out.append('  {')
+    out.append('    %s m;' % cls)
+    out.append('')
+    for f, _, _, _, count in fields:
+        if count is None:
+            out.append('    m.%s = get_%s(p);' % (f, f))
+        else:
+            out.append('    for (size_t i = 0; i < COUNT_%s; i++)' % f)
+            out.append('      m.%s[i] = get_%s(p, i);' % (f, f))
+    out.append('    return m;')
+    out.append('  }')
+    out.append('')
+    out.append('  void encode(uint8_t *p) const')
+    out.append('  {')
+    for f, _, _, _, count in fields:
+        if count is None:
+            out.append('    set_%s(p, %s);' % (f, f))
+        else:
+            out.append('    for (size_t i = 0; i < COUNT_%s; i++)' % f)
+            out.append('      set_%s(p, i, %s[i]);' % (f, f))
+    out.append('  }')
+    out.append('};')
+    out.append('')
+
+    # Struct-of-arrays batch decoder. When every field is a 16-bit word
+    # (as for alert_t), a block of frames is byte-swapped as one flat
+    # array of words - a loop the compiler turns into vector shuffles -
+    # and then scattered into the columns. Otherwise each column is
+    # filled with strided loads.
+    cols = columns(fields)
+    words = all(csize == 2 for _, _, csize, _, _ in cols)
+    out.append('/* Columns of decoded %s messages */' % name)
+    out.append('struct %sBatch' % cls)
+    out.append('{')
+    for c, ctype, _, _, _ in cols:
+        out.append('  std::vector<%s> %s;' % (ctype, c))
+    out.append('')
+    out.append('  size_t size() const { return %s.size(); }' % cols[0][0])
+    out.append('')
+    out.append('  void clear()')
+    out.append('  {')
+    for c in cols:
+        out.append('    %s.clear();' % c[0])
+    out.append('  }')
+    out.append('')
+    out.append('  /* Append n frames found every stride bytes from frames */')
+    out.append('  void decode(const uint8_t *frames, size_t n, size_t stride = %s::SIZE)' % cls)
+    out.append('  {')
+    out.append('    size_t base = size();')
+    out.append('')
+    for c in cols:
+        out.append('    %s.resize(base + n);' % c[0])
+    if words:
+        nwords = len(cols)
+        out.append('')
+        out.append('    /* Byte-swap a block of frames as a flat word array, then')
+        out.append('       transpose it into the columns */')
+        out.append('    const size_t BLOCK = 256;')
+        out.append('    uint16_t block[BLOCK * %d];' % nwords)
+        out.append('')
+        out.append('    for (size_t first = 0; first < n; first += BLOCK)')
+        out.append('      {')
+        out.append('        size_t count = n - first < BLOCK ? n - first : BLOCK;')
+        out.append('')
+        out.append('        if (stride == %s::SIZE)' % cls)
+        out.append('          memcpy(block, frames + first * stride, count * %s::SIZE);' % cls)
+        out.append('        else')
+        out.append('          for (size_t i = 0; i < count; i++)')
+        out.append('            memcpy(block + i * %d, frames + (first + i) * stride, %s::SIZE);'
+                   % (nwords, cls))
+        out.append('        for (size_t i = 0; i < count * %d; i++)' % nwords)
+        out.append('          block[i] = fromBE16(block[i]);')
+        out.append('        for (size_t i = 0; i < count; i++)')
+        out.append('          {')
+        out.append('            const uint16_t *w = block + i * %d;' % nwords)
+        out.append('')
+        for i, (c, ctype, _, _, _) in enumerate(cols):
+            out.append('            %s[base + first + i] = (%s)w[%d];' % (c, ctype, i))
+        out.append('          }')
+        out.append('      }')
+    else:
+        for c, _, _, f, index in cols:
+            out.append('    for (size_t i = 0; i < n; i++)')
+            out.append('      %s[base + i] = %s::get_%s(frames + i * stride%s);' % (c, cls, f, index))
+    out.append('  }')
+    out.append('};')
+    out.append('')
+
+
+def main():
+    args = sys.argv[1:]
+    if len(args) != 3 or args[1] != '-o':
+        sys.exit('Usage: mkcodec.py header.h -o output.h')
+    source, target = args[0], args[2]
+    text = strip_comments(open(source).read())
+    consts = parse_enums(text)
+    structs = parse_structs(text, consts)
+    guard = re.sub(r'\W', '_', target.split('/')[-1]).upper()
+
+    out = ['/**',
+           ' * This file is automatically generated by mkcodec.py. DO NOT EDIT THIS FILE.',
+           ' * C++ codec for the messages and constants of',
+           ' * %s.' % source,
+           ' */',
+           '#ifndef %s' % guard,
+           '#define %s' % guard,
+           '',
+           '#include <stddef.h>',
+           '#include <stdint.h>',
+           '#include <string.h>',
+           '#include <vector>',
+           '',
+           'namespace antitheft {',
+           '',
+           'enum {',
+           ',\n'.join('  %s = %d' % c for c in consts),
+           '};',
+           '',
+           '#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__',
+           'static inline uint16_t fromBE16(uint16_t v) { return v; }',
+           'static inline uint32_t fromBE32(uint32_t v) { return v; }',
+           '#else',
+           'static inline uint16_t fromBE16(uint16_t v) { return __builtin_bswap16(v); }',
+           'static inline uint32_t fromBE32(uint32_t v) { return __builtin_bswap32(v); }',
+           '#endif',
+           '',
+           'static inline uint8_t loadBE8(const uint8_t *p) { return *p; }',
+           'static inline void storeBE8(uint8_t *p, uint8_t v) { *p = v; }',
+           'static inline uint16_t loadBE16(const uint8_t *p)',
+           '{',
+           '  uint16_t v;',
+           '',
+           '  memcpy(&v, p, sizeof v);',
+           '  return fromBE16(v);',
+           '}',
+           'static inline void storeBE16(uint8_t *p, uint16_t v)',
+           '{',
+           '  v = fromBE16(v);',
+           '  memcpy(p, &v, sizeof v);',
+           '}',
+           'static inline uint32_t loadBE32(const uint8_t *p)',
+           '{',
+           '  uint32_t v;',
+           '',
+           '  memcpy(&v, p, sizeof v);',
+           '  return fromBE32(v);',
+           '}',
+           'static inline void storeBE32(uint8_t *p, uint32_t v)',
+           '{',
+           '  v = fromBE32(v);',
+           '  memcpy(p, &v, sizeof v);',
+           '}',
+           '']
+    names = set(c[0] for c in consts)
+    for name, fields, size in structs:
+        emit_struct(out, name, fields, size, names)
+    out.append('}')
+    out.append('')
+    out.append('#endif')
+    open(target, 'w').write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,384 @@
+/**
+ * Serial and SerialForwarder packet sources. The serial side implements
+ * the framing of the TinyOS 2 serial stack (TEP 113): HDLC-like frames
+ * delimited by 0x7e with 0x7d escapes and a CRC-16/CCITT trailer.
+ */
+#include "packetsource.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+enum {
+  HDLC_FLAG = 0x7e,
+  HDLC_ESCAPE = 0x7d,
+  HDLC_XOR = 0x20,
+
+  SERIAL_PROTO_ACK = 67,
+  SERIAL_PROTO_PACKET_ACK = 68,
+  SERIAL_PROTO_PACKET_NOACK = 69,
+
+  READ_SIZE = 4096
+};
+
+uint16_t crcByte(uint16_t crc, uint8_t b)
+{
+  crc = crc ^ b << 8;
+  for (int i = 0; i < 8; i++)
+    crc = crc & 0x8000 ? crc << 1 ^ 0x1021 : crc << 1;
+  return crc;
+}
+
+/* Write all of buf, retrying on short writes */
+bool writeAll(int fd, const uint8_t *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = write(fd, buf, len);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	return false;
+      buf += n;
+      len -= n;
+    }
+  return true;
+}
+
+class SerialSource : public PacketSource
+{
+ public:
+  SerialSource(int fd) : fd(fd), rxPos(0), rxLen(0), frameLen(0),
+			 escaped(false), inFrame(false), txSeq(0) { }
+  ~SerialSource() { close(fd); }
+
+  int readPacket(const uint8_t *&packet);
+  bool writePacket(const uint8_t *packet, int len);
+
+ private:
+  int fd;
+  uint8_t rx[READ_SIZE];
+  int rxPos, rxLen;
+  uint8_t frame[PACKET_MTU + 4];
+  int frameLen;
+  bool escaped, inFrame;
+  uint8_t txSeq;
+
+  int frameDone(const uint8_t *&packet);
+  bool writeFrame(const uint8_t *body, int len);
+};
+
+/* Unescape bytes until a complete frame is found. Frames are checked and
+   acknowledged (when the mote asked for it) in frameDone. */
+int SerialSource::readPacket(const uint8_t *&packet)
+{
+  for (;;)
+    {
+      while (rxPos < rxLen)
+	{
+	  uint8_t b = rx[rxPos++];
+
+	  if (b == HDLC_FLAG)
+	    {
+	      int len = inFrame ? frameDone(packet) : 0;
+
+	      inFrame = true;
+	      frameLen = 0;
+	      escaped = false;
+	      if (len > 0)
+		return len;
+	    }
+	  else if (!inFrame)
+	    ;
+	  else if (b == HDLC_ESCAPE)
+	    escaped = true;
+	  else if (frameLen == (int)sizeof frame)
+	    {
+	      /* Oversized: resynchronise on the next flag */
+	      badFrames++;
+	      inFrame = false;
+	    }
+	  else
+	    {
+	      frame[frameLen++] = escaped ? b ^ HDLC_XOR : b;
+	      escaped = false;
+	    }
+	}
+
+      ssize_t n = read(fd, rx, sizeof rx);
+      if (n <= 0)
+	return -1;
+      rxPos = 0;
+      rxLen = n;
+    }
+}
+
+int SerialSource::frameDone(const uint8_t *&packet)
+{
+  uint16_t crc = 0;
+
+  if (frameLen == 0) /* back-to-back flags */
+    return 0;
+  if (frameLen < 3)
+    {
+      badFrames++;
+      return 0;
+    }
+  for (int i = 0; i < frameLen - 2; i++)
+    crc = crcByte(crc, frame[i]);
+  if (crc != (frame[frameLen - 2] | frame[frameLen - 1] << 8))
+    {
+      badFrames++;
+      return 0;
+    }
+
+  switch (frame[0])
+    {
+    case SERIAL_PROTO_PACKET_NOACK:
+      packet = frame + 1;
+      return frameLen - 3;
+    case SERIAL_PROTO_PACKET_ACK:
+      {
+	uint8_t ack[2] = { SERIAL_PROTO_ACK, frame[1] };
+
+	if (frameLen < 4)
+	  break;
+	writeFrame(ack, sizeof ack);
+	packet = frame + 2;
+	return frameLen - 4;
+      }
+    }
+  /* Acks for our own packets and unknown protocols are ignored */
+  return 0;
+}
+
+bool SerialSource::writeFrame(const uint8_t *body, int len)
+{
+  uint8_t out[2 * (PACKET_MTU + 4) + 2];
+  int n = 0;
+  uint16_t crc = 0;
+
+  out[n++] = HDLC_FLAG;
+  for (int i = 0; i < len + 2; i++)
+    {
+      uint8_t b;
+
+      if (i < len)
+	{
+	  b = body[i];
+	  crc = crcByte(crc, b);
+	}
+      else /* CRC, low byte first */
+	b = i == len ? crc & 0xff : crc >> 8;
+
+      if (b == HDLC_FLAG || b == HDLC_ESCAPE)
+	{
+	  out[n++] = HDLC_ESCAPE;
+	  b ^= HDLC_XOR;
+	}
+      out[n++] = b;
+    }
+  out[n++] = HDLC_FLAG;
+
+  return writeAll(fd, out, n);
+}
+
+bool SerialSource::writePacket(const uint8_t *packet, int len)
+{
+  uint8_t body[PACKET_MTU + 2];
+
+  if (len > PACKET_MTU)
+    return false;
+  body[0] = SERIAL_PROTO_PACKET_ACK;
+  body[1] = txSeq++;
+  memcpy(body + 2, packet, len);
+
+  return writeFrame(body, len + 2);
+}
+
+/* SerialForwarder protocol: a two-byte "U " handshake in each direction,
+   then packets prefixed by a length byte. */
+class SfSource : public PacketSource
+{
+ public:
+  SfSource(int fd) : fd(fd), rxPos(0), rxLen(0) { }
+  ~SfSource() { close(fd); }
+
+  int readPacket(const uint8_t *&packet);
+  bool writePacket(const uint8_t *packet, int len);
+
+ private:
+  int fd;
+  uint8_t rx[READ_SIZE];
+  int rxPos, rxLen;
+};
+
+int SfSource::readPacket(const uint8_t *&packet)
+{
+  for (;;)
+    {
+      /* Return a packet straight from the receive buffer when it holds
+	 a complete one */
+      if (rxPos < rxLen && rxLen - rxPos - 1 >= rx[rxPos])
+	{
+	  int len = rx[rxPos];
+
+	  packet = rx + rxPos + 1;
+	  rxPos += len + 1;
+	  if (len == 0)
+	    continue;
+	  return len;
+	}
+
+      /* Move the partial packet to the front and read some more */
+      memmove(rx, rx + rxPos, rxLen - rxPos);
+      rxLen -= rxPos;
+      rxPos = 0;
+
+      ssize_t n = read(fd, rx + rxLen, sizeof rx - rxLen);
+      if (n <= 0)
+	return -1;
+      rxLen += n;
+    }
+}
+
+bool SfSource::writePacket(const uint8_t *packet, int len)
+{
+  uint8_t out[PACKET_MTU + 1];
+
+  if (len > PACKET_MTU - 1)
+    return false;
+  out[0] = len;
+  memcpy(out + 1, packet, len);
+
+  return writeAll(fd, out, len + 1);
+}
+
+speed_t baudRate(const char *rate)
+{
+  static const struct { const char *name; speed_t speed; } rates[] = {
+    { "micaz", B57600 }, { "mica2", B57600 }, { "iris", B57600 },
+    { "mica2dot", B19200 }, { "telos", B115200 }, { "telosb", B115200 },
+    { "tmote", B115200 }, { "19200", B19200 }, { "38400", B38400 },
+    { "57600", B57600 }, { "115200", B115200 }
+  };
+
+  for (size_t i = 0; i < sizeof rates / sizeof *rates; i++)
+    if (!strcmp(rates[i].name, rate))
+      return rates[i].speed;
+  return 0;
+}
+
+PacketSource *openSerial(const char *args, std::string &error)
+{
+  const char *colon = strrchr(args, ':');
+  std::string device(args, colon ? colon - args : strlen(args));
+  speed_t speed = baudRate(colon ? colon + 1 : "57600");
+  struct termios tio;
+  int fd;
+
+  if (!speed)
+    {
+      error = std::string("unknown platform or baud rate ") + (colon + 1);
+      return NULL;
+    }
+  fd = open(device.c_str(), O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    {
+      error = device + ": " + strerror(errno);
+      return NULL;
+    }
+
+  memset(&tio, 0, sizeof tio);
+  tio.c_cflag = CS8 | CLOCAL | CREAD;
+  tio.c_cc[VMIN] = 1;
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if (tcsetattr(fd, TCSANOW, &tio) < 0)
+    {
+      error = device + ": " + strerror(errno);
+      close(fd);
+      return NULL;
+    }
+  tcflush(fd, TCIOFLUSH);
+
+  return new SerialSource(fd);
+}
+
+PacketSource *openSf(const char *args, std::string &error)
+{
+  const char *colon = strrchr(args, ':');
+  std::string host(args, colon ? colon - args : strlen(args));
+  struct addrinfo hints, *addrs, *a;
+  uint8_t hello[2];
+  int fd = -1, err;
+
+  memset(&hints, 0, sizeof hints);
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  err = getaddrinfo(host.c_str(), colon ? colon + 1 : "9002", &hints, &addrs);
+  if (err)
+    {
+      error = host + ": " + gai_strerror(err);
+      return NULL;
+    }
+  for (a = addrs; a; a = a->ai_next)
+    {
+      fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) == 0)
+	break;
+      if (fd >= 0)
+	close(fd);
+      fd = -1;
+    }
+  freeaddrinfo(addrs);
+  if (fd < 0)
+    {
+      error = std::string(args) + ": " + strerror(errno);
+      return NULL;
+    }
+
+  if (!writeAll(fd, (const uint8_t *)"U ", 2) ||
+      read(fd, hello, 1) != 1 || read(fd, hello + 1, 1) != 1 || hello[0] != 'U')
+    {
+      error = std::string(args) + ": not a SerialForwarder";
+      close(fd);
+      return NULL;
+    }
+
+  return new SfSource(fd);
+}
+
+}
+
+PacketSource *openPacketSource(const char *spec, std::string &error)
+{
+  if (!strncmp(spec, "serial@", 7))
+    return openSerial(spec + 7, error);
+  if (!strncmp(spec, "sf@", 3))
+    return openSf(spec + 3, error);
+  error = std::string("unknown packet source ") + spec +
+    " (expected serial@<device>:<platform> or sf@<host>:<port>)";
+  return NULL;
+}
+
+int buildAmPacket(uint8_t *packet, uint16_t dest, uint8_t group, uint8_t type,
+		  const void *payload, uint8_t len)
+{
+  packet[0] = SERIAL_AM_DISPATCH;
+  setBE16(packet + 1, dest);
+  setBE16(packet + 3, 0);
+  packet[5] = len;
+  packet[6] = group;
+  packet[7] = type;
+  memcpy(packet + SERIAL_AM_HEADER_SIZE, payload, len);
+
+  return SERIAL_AM_HEADER_SIZE + len;
+}
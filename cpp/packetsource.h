@@ -0,0 +1,82 @@
+/**
+ * Sources of TinyOS packets for the native host tools: a mote attached
+ * to a serial port (speaking the TinyOS 2 serial protocol), or a
+ * SerialForwarder reached over TCP. Sources are named the same way as
+ * for the Java tools (MOTECOM syntax):
+ *   serial@<device>:<platform or baud rate>, e.g. serial@/dev/ttyUSB0:micaz
+ *   sf@<host>:<port>, e.g. sf@localhost:9002
+ *
+ * A packet starts with the serial dispatch byte; for active messages it
+ * is followed by the AM header and the payload (see amPayload below).
+ */
+#ifndef PACKETSOURCE_H
+#define PACKETSOURCE_H
+
+#include <stdint.h>
+#include <string>
+
+enum {
+  /* Serial dispatch byte of an active message */
+  SERIAL_AM_DISPATCH = 0,
+  /* Dispatch byte + dest(2) + src(2) + length(1) + group(1) + type(1) */
+  SERIAL_AM_HEADER_SIZE = 8,
+  /* Largest packet we accept */
+  PACKET_MTU = 256
+};
+
+class PacketSource
+{
+ public:
+  virtual ~PacketSource() { }
+
+  /* Wait for the next packet. On success, packet points to it (inside the
+     source's own buffer, valid until the next call) and its length is
+     returned. Returns -1 on end of stream, error or interrupted read
+     (errno is left as set by the failing system call). */
+  virtual int readPacket(const uint8_t *&packet) = 0;
+
+  /* Send a packet. Returns false on error. */
+  virtual bool writePacket(const uint8_t *packet, int len) = 0;
+
+  /* Frames discarded because of bad framing or CRC */
+  unsigned long badFrames;
+
+ protected:
+  PacketSource() : badFrames(0) { }
+};
+
+/* Open the source named by spec. On failure, returns NULL and sets
+   error. */
+PacketSource *openPacketSource(const char *spec, std::string &error);
+
+/* Active message accessors. Fields are big-endian (nx_ types). */
+static inline uint16_t getBE16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static inline void setBE16(uint8_t *p, uint16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v;
+}
+
+/* Return AM payload and its length, or NULL if this is not a well-formed
+   active message */
+static inline const uint8_t *amPayload(const uint8_t *packet, int len, uint8_t &amLen)
+{
+  if (len < SERIAL_AM_HEADER_SIZE || packet[0] != SERIAL_AM_DISPATCH ||
+      packet[5] > len - SERIAL_AM_HEADER_SIZE)
+    return NULL;
+  amLen = packet[5];
+  return packet + SERIAL_AM_HEADER_SIZE;
+}
+
+static inline uint8_t amType(const uint8_t *packet) { return packet[7]; }
+static inline uint16_t amSource(const uint8_t *packet) { return getBE16(packet + 3); }
+
+/* Build an active message packet for writePacket; returns its length. */
+int buildAmPacket(uint8_t *packet, uint16_t dest, uint8_t group, uint8_t type,
+		  const void *payload, uint8_t len);
+
+#endif
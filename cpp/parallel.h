@@ -0,0 +1,39 @@
+/**
+ * Minimal fork-join helper for the host tools' parallel loops.
+ */
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/* Run work(item, thread) for items 0 .. count-1 on the given number of
+   threads, handing out items one at a time */
+template <class F>
+void parallelFor(size_t count, unsigned threads, F work)
+{
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+
+  if (threads > count)
+    threads = count;
+  for (unsigned t = 0; t < threads; t++)
+    pool.push_back(std::thread([&next, count, t, &work]() {
+	  for (size_t item; (item = next++) < count; )
+	    work(item, t);
+	}));
+  for (size_t t = 0; t < pool.size(); t++)
+    pool[t].join();
+}
+
+/* Threads to use when the caller asks for 0 (one per core) */
+static inline unsigned defaultThreads(unsigned threads)
+{
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  return threads ? threads : 1;
+}
+
+#endif
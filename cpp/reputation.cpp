@@ -0,0 +1,148 @@
+/**
+ * Incremental forwarding reputation and blacklist recommendations.
+ */
+#include "reputation.h"
+#include "analysis.h"
+
+#include <algorithm>
+
+void Reputation::addAlert(const AlertRecord &r)
+{
+  uint32_t key = (uint32_t)r.origin << 16 | r.seq;
+  std::unordered_map<uint32_t, Pending>::iterator found = pending.find(key);
+  uint16_t hops[8];
+  int n = alertRoute(r, hops, topology.pathDepth());
+
+  expire(r.time);
+
+  if (found == pending.end())
+    {
+      Pending &p = pending[key];
+
+      p.firstSeen = r.time;
+      p.origin = r.origin;
+      pendingOrder.push_back(key);
+      reputations[r.origin].originated++;
+      found = pending.find(key);
+    }
+
+  /* The last hop is the root, which is not a player */
+  std::vector<uint16_t> &seen = found->second.seen;
+  for (int i = 0; i < n - 1; i++)
+    if (std::find(seen.begin(), seen.end(), hops[i]) == seen.end())
+      seen.push_back(hops[i]);
+}
+
+void Reputation::expire(uint64_t now)
+{
+  while (!pendingOrder.empty())
+    {
+      std::unordered_map<uint32_t, Pending>::iterator p =
+	pending.find(pendingOrder.front());
+
+      if (now - p->second.firstSeen < REPUTATION_WINDOW)
+	break;
+      score(p->second);
+      pending.erase(p);
+      pendingOrder.pop_front();
+    }
+}
+
+/* Every node seen handling the alert broadcast it, so every node with a
+   learned link from it should have relayed it too */
+void Reputation::score(const Pending &p)
+{
+  std::vector<uint16_t> expected;
+
+  for (size_t i = 0; i < p.seen.size(); i++)
+    {
+      std::vector<const Link *> out = topology.outLinks(p.seen[i]);
+
+      if (p.seen[i] != p.origin)
+	observe(p.seen[i], true, p.firstSeen);
+      for (size_t j = 0; j < out.size(); j++)
+	expected.push_back(out[j]->to);
+    }
+
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+  for (size_t i = 0; i < expected.size(); i++)
+    if (std::find(p.seen.begin(), p.seen.end(), expected[i]) == p.seen.end() &&
+	!topology.outLinks(expected[i]).empty()) /* roots only receive */
+      observe(expected[i], false, p.firstSeen);
+}
+
+void Reputation::observe(uint16_t node, bool cooperated, uint64_t time)
+{
+  NodeReputation &rep = reputations[node];
+
+  if (time < rep.blacklistedUntil)
+    return;
+  if (cooperated)
+    rep.forwarded++;
+  else
+    rep.missed++;
+  rep.score += REPUTATION_GAIN * ((cooperated ? 1 : 0) - rep.score);
+}
+
+void Reputation::setPolicy(double newThreshold, uint16_t newBaseDuration)
+{
+  threshold = newThreshold;
+  baseDuration = newBaseDuration;
+}
+
+void Reputation::blacklisted(uint16_t node, uint64_t until)
+{
+  reputations[node].blacklistedUntil = until;
+}
+
+std::vector<Recommendation> Reputation::recommend(uint64_t now,
+						  const NetworkAnalysis *analysis) const
+{
+  std::vector<Recommendation> result;
+
+  for (std::map<uint16_t, NodeReputation>::const_iterator n = reputations.begin();
+       n != reputations.end(); ++n)
+    {
+      const NodeReputation &rep = n->second;
+      Recommendation r;
+      double duration;
+
+      if (rep.score >= threshold || now < rep.blacklistedUntil ||
+	  rep.forwarded + rep.missed < REPUTATION_MIN_EVIDENCE)
+	continue;
+
+      /* From the base duration at the threshold to four times that for a
+	 node that never forwards */
+      duration = baseDuration * (1 + 3 * (threshold - rep.score) / threshold);
+      r.node = n->first;
+      r.duration = std::min(duration, (double)REPUTATION_MAX_DURATION);
+      r.score = rep.score;
+      r.cutsOff = 0;
+      if (analysis)
+	{
+	  std::map<uint16_t, NodeAnalysis>::const_iterator a =
+	    analysis->nodes().find(n->first);
+
+	  if (a != analysis->nodes().end())
+	    r.cutsOff = a->second.cutOff.size();
+	}
+      result.push_back(r);
+    }
+
+  std::sort(result.begin(), result.end(),
+	    [](const Recommendation &a, const Recommendation &b) { return a.score < b.score; });
+  return result;
+}
+
+void Reputation::writeCsv(FILE *out) const
+{
+  fprintf(out, "node,score,originated,forwarded,missed,blacklistedUntil\n");
+  for (std::map<uint16_t, NodeReputation>::const_iterator n = reputations.begin();
+       n != reputations.end(); ++n)
+    fprintf(out, "%u,%.3f,%llu,%llu,%llu,%llu\n", n->first, n->second.score,
+	    (unsigned long long)n->second.originated,
+	    (unsigned long long)n->second.forwarded,
+	    (unsigned long long)n->second.missed,
+	    (unsigned long long)n->second.blacklistedUntil);
+}
@@ -0,0 +1,119 @@
+/**
+ * Forwarding reputation of each node, and blacklist recommendations.
+ *
+ * Alerts are flooded: every node that hears an alert is expected to
+ * rebroadcast it. All copies of one alert (same origin and packetId)
+ * that reach the PC within REPUTATION_WINDOW ms are merged, giving the
+ * set of nodes seen handling it. Once the window has passed, each node
+ * seen relaying it earns cooperation credit, and each node that has a
+ * learned link from one of those nodes but was never seen relaying it
+ * counts as a (suspected) defection. A node's score is an exponentially
+ * weighted average of this evidence; it starts at 1, so nodes are
+ * trusted until shown otherwise.
+ *
+ * Nodes whose score drops below the threshold once enough
+ * evidence has accumulated are recommended for blacklisting, for a
+ * duration that grows with how far below the threshold they are: the
+ * punishment of the repeated forwarding game.
+ */
+#ifndef REPUTATION_H
+#define REPUTATION_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "topology.h"
+
+class NetworkAnalysis;
+
+enum {
+  /* Copies of an alert arriving this long (ms) after the first are ignored */
+  REPUTATION_WINDOW = 3000,
+  /* Observations needed before a node can be recommended for blacklisting */
+  REPUTATION_MIN_EVIDENCE = 50,
+  /* Default and longest blacklist durations (ms), limited by settings_t's
+     16-bit duration */
+  REPUTATION_BASE_DURATION = 10000,
+  REPUTATION_MAX_DURATION = 65535
+};
+
+/* Weight of one observation in a node's score, and the default score
+   below which a node is considered to be defecting (forwardsolve
+   computes thresholds and durations for a given network) */
+const double REPUTATION_GAIN = 0.05;
+const double REPUTATION_THRESHOLD = 0.5;
+
+struct NodeReputation
+{
+  double score;			/* 1 = always forwards, 0 = never does */
+  uint64_t originated;		/* alerts it originated */
+  uint64_t forwarded;		/* alerts it was seen relaying */
+  uint64_t missed;		/* alerts it should have relayed but was not seen with */
+  uint64_t blacklistedUntil;	/* end of the current blacklist (ms) */
+
+  NodeReputation() : score(1), originated(0), forwarded(0), missed(0),
+		     blacklistedUntil(0) { }
+};
+
+struct Recommendation
+{
+  uint16_t node;
+  uint16_t duration;		/* blacklist duration (ms) */
+  double score;
+  size_t cutsOff;		/* nodes that would lose their route meanwhile */
+};
+
+class Reputation
+{
+ public:
+  Reputation(const Topology &topology)
+    : topology(topology), threshold(REPUTATION_THRESHOLD),
+      baseDuration(REPUTATION_BASE_DURATION) { }
+
+  /* Change the score below which nodes are recommended for blacklisting,
+     and the blacklist duration (ms) of a node just below it */
+  void setPolicy(double threshold, uint16_t baseDuration);
+
+  /* Record an alert copy. Alerts whose window has passed are scored. */
+  void addAlert(const AlertRecord &r);
+
+  /* Score all alerts whose window ended before now */
+  void expire(uint64_t now);
+
+  /* Note that node was blacklisted until the given time. Missing
+     forwards are not held against it meanwhile. */
+  void blacklisted(uint16_t node, uint64_t until);
+
+  /* Nodes that should be blacklisted now, worst first. With an analysis,
+     recommendations say how many nodes the blacklist would cut off. */
+  std::vector<Recommendation> recommend(uint64_t now,
+					const NetworkAnalysis *analysis = NULL) const;
+
+  const std::map<uint16_t, NodeReputation> &nodes() const { return reputations; }
+
+  void writeCsv(FILE *out) const;
+
+ private:
+  struct Pending
+  {
+    uint64_t firstSeen;
+    uint16_t origin;
+    std::vector<uint16_t> seen;	/* origin and relays, in any order */
+  };
+
+  const Topology &topology;
+  double threshold;
+  uint16_t baseDuration;
+  std::map<uint16_t, NodeReputation> reputations;
+  std::unordered_map<uint32_t, Pending> pending; /* origin << 16 | packetId */
+  std::deque<uint32_t> pendingOrder;
+
+  void score(const Pending &p);
+  void observe(uint16_t node, bool cooperated, uint64_t time);
+};
+
+#endif
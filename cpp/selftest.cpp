@@ -0,0 +1,491 @@
+/**
+ * Known-answer checks of the host tools' logic, run by "make test".
+ * Each check prints what it expected when it fails; the exit status is
+ * the number of failed checks.
+ */
+#include "antitheft_codec.h"
+#include "analysis.h"
+#include "archive.h"
+#include "forwardgame.h"
+#include "packetsource.h"
+#include "reputation.h"
+#include "topology.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+using namespace antitheft;
+
+namespace {
+
+int failures;
+
+#define CHECK(cond)							\
+  do {									\
+    if (!(cond))							\
+      {									\
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	failures++;							\
+      }									\
+  } while (0)
+
+/* An alert from node 7 relayed by 4 and 3, as the root (node 0) passes
+   it over the serial port: dispatch byte, AM header, payload. Node 7
+   started the path and set ignoredId to itself; each relay prepended
+   itself, so path1 is 3, path2 4 and path3 the origin. */
+const uint8_t RELAYED_ALERT[] = {
+  0x00, 0xff, 0xff, 0x00, 0x00, 0x16, 0x22, 0x16,
+  0x00, 0x07, 0x0b, 0x2c, 0x01, 0x02, 0x00, 0x03,
+  0x00, 0x04, 0x00, 0x07, 0x03, 0xe7, 0x03, 0xe7,
+  0x03, 0xe7, 0x00, 0x07, 0x80, 0x01
+};
+
+void testCodec()
+{
+  uint8_t len, copy[AlertMsg::SIZE * 2];
+  const uint8_t *payload = amPayload(RELAYED_ALERT, sizeof RELAYED_ALERT, len);
+  AlertMsg a;
+  AlertMsgBatch batch;
+
+  CHECK(payload == RELAYED_ALERT + SERIAL_AM_HEADER_SIZE);
+  CHECK(amType(RELAYED_ALERT) == AlertMsg::AM_TYPE);
+  CHECK(amSource(RELAYED_ALERT) == 0);
+  CHECK(len == AlertMsg::SIZE);
+  if (!payload || len != AlertMsg::SIZE)
+    return;
+
+  /* Fields are big-endian, in declaration order */
+  a = AlertMsg::decode(payload);
+  CHECK(a.stolenId == 7);
+  CHECK(a.voltageData == 2860);
+  CHECK(a.packetId == 0x0102);
+  CHECK(a.path1 == 3);
+  CHECK(a.path2 == 4);
+  CHECK(a.path3 == 7);
+  CHECK(a.path4 == 999 && a.path6 == 999);
+  CHECK(a.ignoredId == 7);
+  CHECK(a.settingsVersion == 0x8001);
+  CHECK(AlertMsg::get_packetId(payload) == 0x0102);
+
+  /* Encoding gives back the same bytes */
+  memset(copy, 0, sizeof copy);
+  a.encode(copy);
+  CHECK(!memcmp(copy, payload, AlertMsg::SIZE));
+
+  /* The batch decoder agrees with the per-message one */
+  a.packetId++;
+  a.encode(copy + AlertMsg::SIZE);
+  batch.decode(copy, 2);
+  CHECK(batch.size() == 2);
+  CHECK(batch.stolenId[0] == 7 && batch.stolenId[1] == 7);
+  CHECK(batch.packetId[0] == 0x0102 && batch.packetId[1] == 0x0103);
+  CHECK(batch.voltageData[1] == 2860 && batch.settingsVersion[1] == 0x8001);
+  CHECK(batch.path2[0] == 4 && batch.path6[1] == 999);
+}
+
+/* Array fields are laid out element by element, and get a column per
+   element in the batch */
+void testCodecArrays()
+{
+  static const uint8_t BLACKLIST_PAGE[] = {
+    2, 0x00, 0x07, 0x00, 0x09, 0x4e, 0x20, 0x01, 0xf4, 0x00, 0x03, 0x80, 0x01
+  };
+  static const uint8_t PROFILES_PAGE[] = {
+    1, 2, 0x00, 0x0a, 0x00, 0x14, 0x0f, 0xa0, 0x01, 0xf4, 4, 0, 0x12, 0x34
+  };
+  uint8_t blacklistCopy[BlacklistMsg::SIZE];
+  uint8_t profilesCopy[ProfilesMsg::SIZE];
+  BlacklistMsg b;
+  BlacklistMsgBatch blacklistBatch;
+  ProfilesMsg p;
+  ProfilesMsgBatch profilesBatch;
+
+  CHECK(sizeof BLACKLIST_PAGE == BlacklistMsg::SIZE);
+  CHECK((int)BlacklistMsg::COUNT_target == (int)BLACKLIST_PAGE_SIZE);
+  CHECK(BLACKLIST_SIZE == BLACKLIST_PAGES * BLACKLIST_PAGE_SIZE);
+  b = BlacklistMsg::decode(BLACKLIST_PAGE);
+  CHECK(b.page == 2);
+  CHECK(b.target[0] == 7 && b.target[1] == 9);
+  CHECK(b.duration[0] == 20000 && b.duration[1] == 500);
+  CHECK(b.version[0] == 3 && b.version[1] == 0x8001);
+  CHECK(BlacklistMsg::get_duration(BLACKLIST_PAGE, 1) == 500);
+
+  memset(blacklistCopy, 0, sizeof blacklistCopy);
+  b.encode(blacklistCopy);
+  CHECK(!memcmp(blacklistCopy, BLACKLIST_PAGE, sizeof blacklistCopy));
+
+  blacklistBatch.decode(BLACKLIST_PAGE, 1);
+  CHECK(blacklistBatch.size() == 1 && blacklistBatch.target1[0] == 9
+        && blacklistBatch.version0[0] == 3);
+
+  CHECK(sizeof PROFILES_PAGE == ProfilesMsg::SIZE);
+  CHECK((int)ProfilesMsg::COUNT_first == (int)PROFILE_PAGE_SIZE);
+  CHECK(PROFILE_SIZE == PROFILE_PAGES * PROFILE_PAGE_SIZE);
+  p = ProfilesMsg::decode(PROFILES_PAGE);
+  CHECK(p.page == 1 && p.count == 2);
+  CHECK(p.first[0] == 10 && p.first[1] == 20);
+  CHECK(p.interval[0] == 4000 && p.interval[1] == 500);
+  CHECK(p.alert[0] == 4 && p.alert[1] == 0);
+  CHECK(p.version == 0x1234);
+  CHECK(ProfilesMsg::get_interval(PROFILES_PAGE, 1) == 500);
+
+  memset(profilesCopy, 0, sizeof profilesCopy);
+  p.encode(profilesCopy);
+  CHECK(!memcmp(profilesCopy, PROFILES_PAGE, sizeof profilesCopy));
+
+  profilesBatch.decode(PROFILES_PAGE, 1);
+  CHECK(profilesBatch.size() == 1 && profilesBatch.first1[0] == 20
+        && profilesBatch.alert0[0] == 4);
+}
+
+/* Record i of the test archive: 50 origins, relayed by 100..102 */
+AlertRecord testRecord(uint32_t i)
+{
+  AlertRecord r;
+
+  memset(&r, 0, sizeof r);
+  r.time = 10 * (uint64_t)i;
+  r.origin = i % 50;
+  r.seq = i;
+  r.root = 0;
+  r.path[0] = 100 + i % 3;
+  for (int j = 1; j < 6; j++)
+    r.path[j] = ARCHIVE_NO_NODE;
+  return r;
+}
+
+void testArchive()
+{
+  char path[] = "/tmp/selftestXXXXXX";
+  const uint32_t RECORDS = ARCHIVE_SEGMENT_RECORDS + 100;
+  int fd = mkstemp(path);
+  ArchiveWriter writer;
+  ArchiveReader reader;
+  std::string error;
+  size_t expected, found;
+  uint32_t next = 0;
+  bool inOrder = true;
+  struct rlimit limit;
+  rlim_t saved;
+
+  CHECK(fd >= 0);
+  if (fd < 0)
+    return;
+  close(fd);
+
+  /* More than a segment, so the reader meets an index block */
+  CHECK(writer.open(path, error));
+  for (uint32_t i = 0; i < RECORDS; i++)
+    CHECK(writer.append(testRecord(i)));
+  writer.close();
+
+  /* A crash in the middle of a record: reopening drops it and appends */
+  fd = open(path, O_WRONLY | O_APPEND);
+  CHECK(fd >= 0 && write(fd, "partial", 7) == 7);
+  close(fd);
+  CHECK(writer.open(path, error));
+  CHECK(writer.append(testRecord(RECORDS)));
+  writer.close();
+
+  CHECK(reader.open(path, error));
+  CHECK(reader.size() == RECORDS + 1);
+  found = reader.scan(0, UINT64_MAX, -1, [&](const AlertRecord &r) {
+      AlertRecord want = testRecord(next++);
+
+      if (memcmp(&r, &want, sizeof r))
+	inOrder = false;
+    });
+  CHECK(found == RECORDS + 1 && inOrder);
+  CHECK(reader.scan(1000, 1990, -1, [](const AlertRecord &) { }) == 100);
+
+  expected = 0;
+  for (uint32_t i = 0; i <= RECORDS; i++)
+    if (testRecord(i).involves(101) && i >= 100)
+      expected++;
+  CHECK(reader.scan(1000, UINT64_MAX, 101, [](const AlertRecord &) { }) == expected);
+  reader.close();
+
+  /* A write that fails keeps the records buffered until it can be
+     retried: none are lost or written twice */
+  unlink(path);
+  CHECK(writer.open(path, error));
+  signal(SIGXFSZ, SIG_IGN);
+  getrlimit(RLIMIT_FSIZE, &limit);
+  saved = limit.rlim_cur;
+  limit.rlim_cur = sizeof(ArchiveHeader) + 10 * sizeof(AlertRecord) + 7;
+  CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+  for (uint32_t i = 0; i < 20; i++)
+    CHECK(writer.append(testRecord(i)));
+  CHECK(!writer.flush());
+  CHECK(!writer.error().empty());
+  limit.rlim_cur = saved;
+  setrlimit(RLIMIT_FSIZE, &limit);
+  CHECK(writer.flush());
+  writer.close();
+
+  next = 0;
+  inOrder = true;
+  CHECK(reader.open(path, error));
+  found = reader.scan(0, UINT64_MAX, -1, [&](const AlertRecord &r) {
+      AlertRecord want = testRecord(next++);
+
+      if (memcmp(&r, &want, sizeof r))
+	inOrder = false;
+    });
+  CHECK(found == 20 && inOrder);
+  reader.close();
+  unlink(path);
+}
+
+/* An alert's record, path1 (last hop) first */
+AlertRecord pathRecord(uint16_t origin, uint16_t seq, uint64_t time,
+		       std::initializer_list<uint16_t> path)
+{
+  AlertRecord r = testRecord(0);
+  int i = 0;
+
+  r.origin = origin;
+  r.seq = seq;
+  r.time = time;
+  for (uint16_t hop : path)
+    r.path[i++] = hop;
+  return r;
+}
+
+bool sameRoute(const AlertRecord &r, int depth, std::initializer_list<uint16_t> route)
+{
+  uint16_t hops[8];
+  int n = alertRoute(r, hops, depth);
+
+  return n == (int)route.size() && std::equal(route.begin(), route.end(), hops);
+}
+
+void testRoutes()
+{
+  uint8_t len;
+  AlertRecord relayed =
+    AlertRecord::fromMsg(0, 0, AlertMsg::decode(amPayload(RELAYED_ALERT,
+							   sizeof RELAYED_ALERT, len)));
+  Topology topology;
+
+  /* Origin, relays oldest first, root: the origin recorded in the path
+     is not repeated */
+  CHECK(sameRoute(relayed, 6, { 7, 4, 3, 0 }));
+  CHECK(sameRoute(pathRecord(7, 0, 0, { 7 }), 6, { 7, 0 }));
+
+  /* A full path either ends at the origin or has lost it: then the
+     route starts at the oldest recorded hop */
+  CHECK(sameRoute(pathRecord(9, 0, 0, { 1, 2, 3, 4, 5, 9 }), 6, { 9, 5, 4, 3, 2, 1, 0 }));
+  CHECK(sameRoute(pathRecord(9, 0, 0, { 1, 2, 3, 4, 5, 6 }), 6, { 6, 5, 4, 3, 2, 1, 0 }));
+
+  /* Nodes built with PATH_DEPTH 3 fill only three entries */
+  CHECK(sameRoute(pathRecord(9, 0, 0, { 1, 2, 3 }), 3, { 3, 2, 1, 0 }));
+  CHECK(sameRoute(pathRecord(9, 0, 0, { 1, 2, 3 }), 6, { 9, 3, 2, 1, 0 }));
+  CHECK(sameRoute(pathRecord(9, 0, 0, { 1, 2 }), 3, { 9, 2, 1, 0 }));
+
+  /* A truncated path adds no link from the origin */
+  topology.setPathDepth(3);
+  CHECK(topology.addAlert(pathRecord(9, 0, 5, { 1, 2, 3 })) == 3);
+  CHECK(topology.addAlert(pathRecord(9, 1, 6, { 1, 2, 3 })) == 0);
+  CHECK(!topology.link(9, 3));
+  CHECK(topology.link(3, 2) && topology.link(3, 2)->uses == 2);
+  CHECK(topology.link(1, 0) && topology.link(1, 0)->lastSeen == 6);
+}
+
+/* Node 4 reaches the root (0) only through 2, which has two routes on
+   (through 1 or 3) */
+void testAnalysis()
+{
+  Topology topology;
+  NetworkAnalysis analysis;
+  const std::map<uint16_t, NodeAnalysis> &nodes = analysis.nodes();
+  const AlertRecord alerts[] = {
+    pathRecord(4, 0, 0, { 1, 2, 4 }), pathRecord(4, 1, 1, { 3, 2, 4 }),
+    pathRecord(2, 0, 2, { 1, 2 })
+  };
+
+  for (const AlertRecord &r : alerts)
+    {
+      topology.addAlert(r);
+      analysis.addAlert(r);
+    }
+  CHECK(analysis.refresh(topology, 2));
+  CHECK(!analysis.refresh(topology, 2));
+  CHECK(nodes.at(4).originated == 2 && nodes.at(4).relayed == 0);
+  CHECK(nodes.at(2).originated == 1 && nodes.at(2).relayed == 2);
+  CHECK(nodes.at(1).relayed == 2 && nodes.at(3).relayed == 1);
+
+  /* 2 is on the shortest paths 4 -> 1, 4 -> 3 and 4 -> 0; 1 and 3 are
+     each on half of those from 4 and from 2 to the root */
+  CHECK(fabs(nodes.at(2).betweenness - 3) < 1e-9);
+  CHECK(fabs(nodes.at(1).betweenness - 1) < 1e-9);
+  CHECK(fabs(nodes.at(3).betweenness - 1) < 1e-9);
+  CHECK(nodes.at(4).betweenness == 0 && nodes.at(0).betweenness == 0);
+
+  CHECK(nodes.at(2).cutOff == std::vector<uint16_t>(1, 4));
+  CHECK(nodes.at(1).cutOff.empty() && nodes.at(3).cutOff.empty());
+  CHECK(nodes.at(4).cutOff.empty());
+}
+
+/* Node 2 reaches the root (0) through 1 or 3; every alert it sends is
+   relayed by one of them, and the other should have relayed it too */
+void testReputation()
+{
+  Topology topology;
+  Reputation reputation(topology);
+  const uint64_t SPACING = REPUTATION_WINDOW + 1;
+  uint64_t time = 0;
+  uint16_t seq = 0;
+  std::vector<Recommendation> recs;
+  double score;
+
+  topology.addAlert(pathRecord(2, 0, 0, { 1 }));
+  topology.addAlert(pathRecord(2, 0, 0, { 3 }));
+
+  /* Each miss moves the score REPUTATION_GAIN of the way to 0 */
+  for (int i = 0; i < 2; i++, time += SPACING)
+    reputation.addAlert(pathRecord(2, seq++, time, { 1 }));
+  reputation.expire(time);
+  CHECK(fabs(reputation.nodes().at(3).score - 0.9025) < 1e-9);
+  CHECK(reputation.nodes().at(3).missed == 2);
+  CHECK(reputation.nodes().at(1).score == 1 && reputation.nodes().at(1).forwarded == 2);
+  CHECK(reputation.nodes().at(2).originated == 2);
+
+  /* ... and each forward the same way back to 1 */
+  reputation.addAlert(pathRecord(2, seq++, time, { 3 }));
+  time += SPACING;
+  reputation.expire(time);
+  CHECK(fabs(reputation.nodes().at(3).score - 0.907375) < 1e-9);
+  CHECK(fabs(reputation.nodes().at(1).score - 0.95) < 1e-9);
+
+  /* Copies of one alert merge; misses while blacklisted do not count */
+  reputation.blacklisted(3, time + SPACING);
+  reputation.addAlert(pathRecord(2, seq, time, { 1 }));
+  reputation.addAlert(pathRecord(2, seq++, time + 10, { 1 }));
+  time += SPACING;
+  reputation.expire(time);
+  CHECK(fabs(reputation.nodes().at(3).score - 0.907375) < 1e-9);
+  CHECK(reputation.nodes().at(2).originated == 4);
+
+  /* Enough misses get node 3 recommended, for longer the lower it is */
+  for (int i = 0; i < REPUTATION_MIN_EVIDENCE; i++, time += SPACING)
+    reputation.addAlert(pathRecord(2, seq++, time, { 1 }));
+  reputation.expire(time);
+  score = 0.907375 * pow(1 - REPUTATION_GAIN, REPUTATION_MIN_EVIDENCE);
+  recs = reputation.recommend(time);
+  CHECK(fabs(reputation.nodes().at(3).score - score) < 1e-9);
+  CHECK(recs.size() == 1 && recs[0].node == 3);
+  if (recs.size() == 1)
+    CHECK(recs[0].duration == (uint16_t)(REPUTATION_BASE_DURATION *
+					 (1 + 3 * (REPUTATION_THRESHOLD - score) /
+					  REPUTATION_THRESHOLD)));
+}
+
+void testForwardGame()
+{
+  Topology topology;
+  std::string error;
+  GameNetwork net;
+  GameParams params;
+  GameResult result, again;
+
+  CHECK(!loadTopology("grid:1x1", topology, error) && !error.empty());
+
+  /* Links both ways between neighbours, except out of the root */
+  CHECK(loadTopology("grid:3x3", topology, error));
+  CHECK(topology.links().size() == 22 && topology.link(1, 0) && !topology.link(0, 1));
+  net = gameNetwork(topology, std::vector<uint16_t>());
+  CHECK(net.players == 8 && net.root[net.graph.indexOf(0)]);
+
+  /* One epoch of everybody forwarding: every alert is delivered and
+     relayed by every other player */
+  params.initial = 1;
+  params.epoch = 5000;
+  result = playGame(net, params, 5000, 1);
+  CHECK(result.alerts > 0 && result.delivered == result.alerts);
+  CHECK(result.transmissions == 8 * result.alerts && result.blacklists == 0);
+
+  /* Nobody forwarding: only the origin transmits; a threshold of 0 never
+     blacklists */
+  params.initial = 0;
+  params.threshold = 0;
+  result = playGame(net, params, 5000, 1);
+  CHECK(result.transmissions == result.alerts && result.blacklists == 0);
+  CHECK(result.delivered < result.alerts);
+
+  /* Replicas are reproducible from their seed */
+  params = GameParams();
+  result = playGame(net, params, 20000, 7);
+  again = playGame(net, params, 20000, 7);
+  CHECK(result.trajectory == again.trajectory && result.alerts == again.alerts);
+}
+
+/* Node 2 reaches the root (0) through 1, and each hears the other's
+   alerts */
+void testIncentives()
+{
+  Topology topology;
+  std::string error;
+  GameNetwork net;
+  GameParams params;
+  IncentiveSolution sol;
+  double own, saved, required;
+
+  CHECK(dropsToBlacklist(params) == 14);	/* 0.95^14 < 0.5 < 0.95^13 */
+  params.threshold = 0;
+  CHECK(dropsToBlacklist(params) == UINT_MAX);
+  params = GameParams();
+
+  CHECK(safeThreshold(0.05, 0) == 0.95);
+  CHECK(fabs(safeThreshold(0.05, 0.1) - (0.9 - 3 * sqrt(0.05 / 1.95 * 0.09))) < 1e-9);
+
+  CHECK(loadTopology("line:3", topology, error));
+  net = gameNetwork(topology, std::vector<uint16_t>());
+
+  /* Forwarding saves the cost of the alerts heard, and is worth it if a
+     blacklist of the required length follows 14 observed drops */
+  own = (params.benefit - params.cost) * params.alertRate;
+  saved = params.cost * params.alertRate;
+  required = 14 / (params.detection * params.alertRate) * saved / (own - saved);
+  sol = solveIncentives(net, params, 100, 0, 2);
+  CHECK(sol.converged && sol.iterations == 1 && sol.forwarding == 2);
+  CHECK(fabs(sol.nodes[net.graph.indexOf(1)].required - required) < 1e-9);
+  CHECK(sol.duration == (uint32_t)ceil(required));
+
+  /* Blacklists too short for that: nobody forwards, so node 2's alerts
+     are lost and it has no reason to forward at all */
+  sol = solveIncentives(net, params, 2, 0, 2);
+  CHECK(sol.converged && sol.iterations == 2 && sol.forwarding == 0);
+  CHECK(sol.nodes[net.graph.indexOf(2)].delivery == 0);
+  CHECK(sol.nodes[net.graph.indexOf(2)].required == HUGE_VAL);
+  CHECK(sol.duration == 1);
+}
+
+}
+
+int main()
+{
+  testCodec();
+  testCodecArrays();
+  testArchive();
+  testRoutes();
+  testAnalysis();
+  testReputation();
+  testForwardGame();
+  testIncentives();
+
+  if (failures)
+    fprintf(stderr, "selftest: %d checks failed\n", failures);
+  else
+    printf("selftest: all checks passed\n");
+  return failures;
+}
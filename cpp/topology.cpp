@@ -0,0 +1,223 @@
+/**
+ * Incremental link graph built from alert hop paths.
+ */
+#include "topology.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+int alertRoute(const AlertRecord &r, uint16_t hops[8], int depth)
+{
+  int n = 0;
+
+  /* path[depth - 1] is the oldest hop the nodes record. When the alert
+     travelled more than depth hops the origin has been shifted out of
+     the path, and we cannot tell how it reached the oldest recorded hop,
+     so the route starts there. */
+  if (depth < 1 || depth > 6)
+    depth = 6;
+  if (r.path[depth - 1] == ARCHIVE_NO_NODE || r.path[depth - 1] == r.origin)
+    hops[n++] = r.origin;
+  for (int i = depth - 1; i >= 0; i--)
+    if (r.path[i] != ARCHIVE_NO_NODE && (n == 0 || hops[n - 1] != r.path[i]))
+      hops[n++] = r.path[i];
+  if (hops[n - 1] != r.root)
+    hops[n++] = r.root;
+
+  return n;
+}
+
+Link &Topology::use(uint16_t from, uint16_t to, uint64_t time, bool &added)
+{
+  uint32_t key = (uint32_t)from << 16 | to;
+  std::unordered_map<uint32_t, uint32_t>::iterator found = linkIndex.find(key);
+  Link *l;
+
+  added = found == linkIndex.end();
+  if (added)
+    {
+      Link fresh = { from, to, 0, 0, -1 };
+      uint32_t index = linkList.size();
+
+      linkList.push_back(fresh);
+      linkIndex[key] = index;
+      adjacency[from].out.push_back(index);
+      adjacency[to].in.push_back(index);
+      changes++;
+      l = &linkList[index];
+    }
+  else
+    l = &linkList[found->second];
+
+  l->uses++;
+  if (time > l->lastSeen)
+    l->lastSeen = time;
+  return *l;
+}
+
+int Topology::addAlert(const AlertRecord &r)
+{
+  uint16_t hops[8];
+  int n = alertRoute(r, hops, depth), added = 0;
+
+  for (int i = 0; i + 1 < n; i++)
+    {
+      bool fresh;
+
+      use(hops[i], hops[i + 1], r.time, fresh);
+      added += fresh;
+    }
+  return added;
+}
+
+void Topology::addLink(uint16_t from, uint16_t to, uint64_t time)
+{
+  bool added;
+
+  use(from, to, time, added);
+}
+
+const Link *Topology::link(uint16_t from, uint16_t to) const
+{
+  std::unordered_map<uint32_t, uint32_t>::const_iterator found =
+    linkIndex.find((uint32_t)from << 16 | to);
+
+  return found == linkIndex.end() ? NULL : &linkList[found->second];
+}
+
+std::vector<const Link *> Topology::outLinks(uint16_t node) const
+{
+  std::vector<const Link *> result;
+  std::unordered_map<uint16_t, Adjacency>::const_iterator a = adjacency.find(node);
+
+  if (a != adjacency.end())
+    for (size_t i = 0; i < a->second.out.size(); i++)
+      result.push_back(&linkList[a->second.out[i]]);
+  return result;
+}
+
+std::vector<const Link *> Topology::inLinks(uint16_t node) const
+{
+  std::vector<const Link *> result;
+  std::unordered_map<uint16_t, Adjacency>::const_iterator a = adjacency.find(node);
+
+  if (a != adjacency.end())
+    for (size_t i = 0; i < a->second.in.size(); i++)
+      result.push_back(&linkList[a->second.in[i]]);
+  return result;
+}
+
+std::vector<uint16_t> Topology::nodes() const
+{
+  std::vector<uint16_t> result;
+
+  for (std::unordered_map<uint16_t, Adjacency>::const_iterator a = adjacency.begin();
+       a != adjacency.end(); ++a)
+    result.push_back(a->first);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void Topology::writeDot(FILE *out) const
+{
+  fprintf(out, "digraph antitheft {\n");
+  for (size_t i = 0; i < linkList.size(); i++)
+    fprintf(out, "  %u -> %u [label=\"%llu\"];\n", linkList[i].from, linkList[i].to,
+	    (unsigned long long)linkList[i].uses);
+  fprintf(out, "}\n");
+}
+
+void Topology::writeCsv(FILE *out) const
+{
+  fprintf(out, "from,to,uses,lastSeen,latency\n");
+  for (size_t i = 0; i < linkList.size(); i++)
+    {
+      const Link &l = linkList[i];
+
+      fprintf(out, "%u,%u,%llu,%llu,", l.from, l.to, (unsigned long long)l.uses,
+	      (unsigned long long)l.lastSeen);
+      if (l.latency >= 0)
+	fprintf(out, "%.1f", l.latency);
+      fprintf(out, "\n");
+    }
+}
+
+bool Topology::readCsv(FILE *in, std::string &error)
+{
+  char line[128];
+  int lineNo = 0;
+
+  while (fgets(line, sizeof line, in))
+    {
+      unsigned from, to;
+      unsigned long long uses, lastSeen;
+      char latency[32] = "";
+      int fields;
+      bool added;
+
+      lineNo++;
+      if (lineNo == 1 && strncmp(line, "from,", 5) == 0)
+	continue;
+      fields = sscanf(line, "%u,%u,%llu,%llu,%31s", &from, &to, &uses, &lastSeen, latency);
+      if (fields < 2 || from > 0xffff || to > 0xffff)
+	{
+	  error = "line " + std::to_string(lineNo) + ": expected from,to[,uses,lastSeen,latency]";
+	  return false;
+	}
+
+      Link &l = use(from, to, fields >= 4 ? lastSeen : 0, added);
+      if (fields >= 3)
+	l.uses += uses - 1;
+      if (fields >= 5)
+	l.latency = atof(latency);
+    }
+
+  return true;
+}
+
+int64_t Graph::indexOf(uint16_t node) const
+{
+  std::vector<uint16_t>::const_iterator found =
+    std::lower_bound(ids.begin(), ids.end(), node);
+
+  return found != ids.end() && *found == node ? found - ids.begin() : -1;
+}
+
+Graph buildGraph(const Topology &topology)
+{
+  Graph g;
+  std::unordered_map<uint16_t, uint32_t> index;
+  const std::vector<Link> &links = topology.links();
+
+  g.ids = topology.nodes();
+  for (size_t i = 0; i < g.ids.size(); i++)
+    index[g.ids[i]] = i;
+
+  g.outStart.assign(g.size() + 1, 0);
+  g.inStart.assign(g.size() + 1, 0);
+  for (size_t i = 0; i < links.size(); i++)
+    {
+      g.outStart[index[links[i].from] + 1]++;
+      g.inStart[index[links[i].to] + 1]++;
+    }
+  for (size_t v = 0; v < g.size(); v++)
+    {
+      g.outStart[v + 1] += g.outStart[v];
+      g.inStart[v + 1] += g.inStart[v];
+    }
+
+  std::vector<uint32_t> outFill(g.outStart.begin(), g.outStart.end() - 1),
+    inFill(g.inStart.begin(), g.inStart.end() - 1);
+  g.out.resize(links.size());
+  g.in.resize(links.size());
+  for (size_t i = 0; i < links.size(); i++)
+    {
+      uint32_t from = index[links[i].from], to = index[links[i].to];
+
+      g.out[outFill[from]++] = to;
+      g.in[inFill[to]++] = from;
+    }
+
+  return g;
+}
@@ -0,0 +1,108 @@
+/**
+ * Network topology reconstructed from the hop paths carried by alerts.
+ *
+ * Every alert records up to six hops (path6 oldest .. path1 latest) on its
+ * way to the root, so each alert confirms a chain of directed links
+ * origin -> ... -> path1 -> root. Nodes built with a smaller PATH_DEPTH
+ * record fewer, and leave the other entries unused; the host tools must
+ * be told the depth (setPathDepth) to tell a short path from one whose
+ * origin was shifted out. The graph keeps, per link, how many
+ * alerts used it, when it was last used and the per-hop latency of a
+ * link CSV it was read from. Adding an alert costs O(path length).
+ */
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "archive.h"
+
+struct Link
+{
+  uint16_t from, to;
+  uint64_t uses;		/* alerts that crossed this link */
+  uint64_t lastSeen;		/* time of the last of those alerts */
+  double latency;		/* per-hop latency (ms) of a link CSV, < 0 if unknown */
+};
+
+class Topology
+{
+ public:
+  Topology() : depth(antitheft::PATH_DEPTH), changes(0) { }
+
+  /* Hops of the path the nodes record (their PATH_DEPTH, 1..6) */
+  void setPathDepth(int pathDepth) { depth = pathDepth; }
+  int pathDepth() const { return depth; }
+
+  /* Add the links used by an alert. Returns the number of links that
+     were not known before. */
+  int addAlert(const AlertRecord &r);
+
+  /* Add a use of link from -> to that was not learned from an alert,
+     e.g. of a generated topology */
+  void addLink(uint16_t from, uint16_t to, uint64_t time = 0);
+
+  /* The link from -> to, or NULL if never seen */
+  const Link *link(uint16_t from, uint16_t to) const;
+
+  /* Links leaving / entering node */
+  std::vector<const Link *> outLinks(uint16_t node) const;
+  std::vector<const Link *> inLinks(uint16_t node) const;
+
+  /* All nodes seen, in increasing order */
+  std::vector<uint16_t> nodes() const;
+
+  const std::vector<Link> &links() const { return linkList; }
+
+  /* Incremented whenever a link is added, so users can tell when
+     structure-dependent results need recomputing */
+  uint64_t generation() const { return changes; }
+
+  /* Export as a Graphviz digraph (edge labels are use counts) or as CSV */
+  void writeDot(FILE *out) const;
+  void writeCsv(FILE *out) const;
+
+  /* Add the links of a file written by writeCsv (or alertscan -l) */
+  bool readCsv(FILE *in, std::string &error);
+
+ private:
+  struct Adjacency
+  {
+    std::vector<uint32_t> out, in; /* indices into linkList */
+  };
+
+  std::vector<Link> linkList;
+  std::unordered_map<uint32_t, uint32_t> linkIndex; /* from << 16 | to */
+  std::unordered_map<uint16_t, Adjacency> adjacency;
+  int depth;
+  uint64_t changes;
+
+  Link &use(uint16_t from, uint16_t to, uint64_t time, bool &added);
+};
+
+/* The topology as compressed adjacency arrays over dense node indices,
+   for algorithms that walk the whole graph many times */
+struct Graph
+{
+  std::vector<uint16_t> ids;	/* node of each index, in increasing order */
+  std::vector<uint32_t> outStart, out, inStart, in;
+
+  size_t size() const { return ids.size(); }
+
+  /* Index of node, or -1 if it is not in the graph */
+  int64_t indexOf(uint16_t node) const;
+};
+
+Graph buildGraph(const Topology &topology);
+
+/* Nodes an alert went through, origin first, ending with the root, for
+   nodes that record depth hops of the path. The origin is left out if
+   it was shifted out of the path. Returns the number of entries written
+   to hops (at most 8). */
+int alertRoute(const AlertRecord &r, uint16_t hops[8], int depth);
+
+#endif
@@ -11,12 +11,12 @@
 public class AlertMsg extends net.tinyos.message.Message {
 
     /** The default size of this message type in bytes. */
-    public static final int DEFAULT_MESSAGE_SIZE = 20;
+    public static final int DEFAULT_MESSAGE_SIZE = 22;
 
     /** The Active Message type associated with this message. */
     public static final int AM_TYPE = 22;
 
-    /** Create a new AlertMsg of size 20. */
+    /** Create a new AlertMsg of size 22. */
     public AlertMsg() {
         super(DEFAULT_MESSAGE_SIZE);
         amTypeSet(AM_TYPE);
@@ -118,6 +118,9 @@ public class AlertMsg extends net.tinyos.message.Message {
       try {
         s += "  [ignoredId=0x"+Long.toHexString(get_ignoredId())+"]\n";
       } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [settingsVersion=0x"+Long.toHexString(get_settingsVersion())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
       return s;
     }
 
@@ -753,4 +756,67 @@ public class AlertMsg extends net.tinyos.message.Message {
         return 16;
     }
 
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: settingsVersion
+    //   Field type: int, unsigned
+    //   Offset (bits): 160
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'settingsVersion' is signed (false).
+     */
+    public static boolean isSigned_settingsVersion() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'settingsVersion' is an array (false).
+     */
+    public static boolean isArray_settingsVersion() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'settingsVersion'
+     */
+    public static int offset_settingsVersion() {
+        return (160 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'settingsVersion'
+     */
+    public static int offsetBits_settingsVersion() {
+        return 160;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'settingsVersion'
+     */
+    public int get_settingsVersion() {
+        return (int)getUIntBEElement(offsetBits_settingsVersion(), 16);
+    }
+
+    /**
+     * Set the value of the field 'settingsVersion'
+     */
+    public void set_settingsVersion(int value) {
+        setUIntBEElement(offsetBits_settingsVersion(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'settingsVersion'
+     */
+    public static int size_settingsVersion() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'settingsVersion'
+     */
+    public static int sizeBits_settingsVersion() {
+        return 16;
+    }
+
 }
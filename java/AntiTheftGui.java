@@ -46,6 +46,7 @@ import javax.swing.*;
 import java.awt.*;
 import java.awt.event.*;
 import java.io.*;
+import java.util.*;
 import net.tinyos.message.*;
 import net.tinyos.packet.*;
 import net.tinyos.util.*;
@@ -59,17 +60,38 @@ public class AntiTheftGui implements MessageListener, Messenger {
     JTextField fieldInterval;	// The requested check interval
     JTextField fieldTarget;	// Target node to blacklist (0 doesn't blacklist a node)
     JTextField fieldDuration;	// Duration for which node should be blacklisted	
+    JTextField fieldProfiles;	// Per-node profiles, as first:interval[:alert], ...
+    JLabel rootStatus;		// Latest root health report
+    int lastStatusSeqno = -1;	// Sequence number of the last root health report
+    JLabel settingsStatus;	// Progress of the latest settings push
+
+    /* Version of the last settings push. Seeded from the clock so that a
+       restarted GUI does not reuse a version the motes still run. */
+    int settingsVersion = (int)(System.currentTimeMillis() / 1000) & 0xffff;
+    SettingsTracker tracker = new SettingsTracker();
+
+    /* Routes to the nodes seen on alert paths, starting with the root's
+       neighbour, for blacklisting a single node by command */
+    static final int NO_HOP = 999; // an unused alert path entry
+    Map<Integer, int[]> routes = new HashMap<Integer, int[]>();
+    int commandSeqno = settingsVersion;
+    int pendingCommand = -1;	// seqno of the unacknowledged command, or -1
+    long commandSent;
+    javax.swing.Timer commandTimer;
 
     /* The checkboxes for the requested settings */
-    JCheckBox lowBattCb, broadcastCb;
+    JCheckBox lowBattCb, broadcastCb, urgentCb;
 
     public AntiTheftGui() {
 	try {
 	    guiInit();
 	    /* Setup communication with the mote and request a messageReceived
-	       callback when an AlertMsg is received */
+	       callback when an AlertMsg, RootStatusMsg or CommandMsg
+	       (acknowledgement) is received */
 	    mote = new MoteIF(this);
 	    mote.registerListener(new AlertMsg(), this);
+	    mote.registerListener(new RootStatusMsg(), this);
+	    mote.registerListener(new CommandMsg(), this);
 	}
 	catch(Exception e) {
 	    e.printStackTrace();
@@ -122,6 +144,7 @@ public class AntiTheftGui implements MessageListener, Messenger {
 	buttonPanel.makeLabel("Blacklist duration", JLabel.CENTER);
 	fieldDuration = buttonPanel.makeTextField(10, null);	
 	fieldDuration.setText(Integer.toString(0));
+	urgentCb = buttonPanel.makeCheckBox("Urgent", false);
 
 	ActionListener settingsAction = new ActionListener() {
 		public void actionPerformed(ActionEvent e) {
@@ -129,6 +152,33 @@ public class AntiTheftGui implements MessageListener, Messenger {
 		}
 	    };
 	buttonPanel.makeButton("Send", settingsAction);
+	ActionListener blacklistAction = new ActionListener() {
+		public void actionPerformed(ActionEvent e) {
+		    blacklist();
+		}
+	    };
+	buttonPanel.makeButton("Blacklist", blacklistAction);
+	commandTimer = new javax.swing.Timer(Constants.COMMAND_TIMEOUT, new ActionListener() {
+		public void actionPerformed(ActionEvent e) {
+		    commandTimedOut();
+		}
+	    });
+	commandTimer.setRepeats(false);
+	settingsStatus = buttonPanel.makeLabel("<html>No settings sent</html>", JLabel.LEFT);
+	buttonPanel.makeSeparator(SwingConstants.HORIZONTAL);
+
+	buttonPanel.makeLabel("Profiles (first:interval[:alert])", JLabel.CENTER);
+	fieldProfiles = buttonPanel.makeTextField(10, null);
+	ActionListener profilesAction = new ActionListener() {
+		public void actionPerformed(ActionEvent e) {
+		    updateProfiles();
+		}
+	    };
+	buttonPanel.makeButton("Send profiles", profilesAction);
+	buttonPanel.makeSeparator(SwingConstants.HORIZONTAL);
+
+	buttonPanel.makeLabel("Root Status", JLabel.CENTER);
+	rootStatus = buttonPanel.makeLabel("<html>No report yet</html>", JLabel.LEFT);
 
 	mainPanel.add(buttonPanel, BorderLayout.EAST);
 
@@ -226,20 +276,169 @@ public class AntiTheftGui implements MessageListener, Messenger {
 	smsg.set_checkInterval(checkInterval);
 	smsg.set_targetId(targetId);
 	smsg.set_duration(duration);
+	settingsVersion = (settingsVersion + 1) & 0xffff;
+	smsg.set_version(settingsVersion);
+	/* An urgent blacklist is also flooded ahead of dissemination */
+	if (urgentCb.isSelected() && targetId != 0)
+	    smsg.amTypeSet(Constants.AM_URGENT_SETTINGS);
 	try {
 	    mote.send(MoteIF.TOS_BCAST_ADDR, smsg);
+	    tracker.pushed(settingsVersion, System.currentTimeMillis());
+	    updateSettingsStatus();
+	}
+	catch (IOException e) {
+	    error("Cannot send message to mote");
+	}
+    }
+
+    /* User pressed the "Send profiles" button. Read the profiles field,
+       e.g. "1:4000, 10:500:4" (nodes 1 to 9 check every 4 s, nodes 10
+       and up every 0.5 s and broadcast alerts), and send it sorted by
+       first node as ProfilesMsg pages of PROFILE_PAGE_SIZE entries, in
+       order and with the same version. An interval or alert of 0 leaves
+       the nodes to the settings; an empty field clears the profiles. */
+    public void updateProfiles() {
+	TreeMap<Integer, int[]> entries = new TreeMap<Integer, int[]>();
+
+	try {
+	    for (String entry : fieldProfiles.getText().split(",")) {
+		if (entry.trim().length() == 0)
+		    continue;
+		String[] values = entry.trim().split(":");
+		if (values.length < 2 || values.length > 3)
+		    throw new NumberFormatException();
+		int first = Integer.parseInt(values[0]);
+		int interval = Integer.parseInt(values[1]);
+		int alert = values.length == 3 ? Integer.parseInt(values[2]) : 0;
+		if (first < 0 || first > 0xffff || interval < 0 || interval > 0xffff ||
+		    (interval > 0 && interval < 10) || alert < 0 || alert > 0xff ||
+		    entries.put(first, new int[] { interval, alert }) != null)
+		    throw new NumberFormatException();
+	    }
+	    if (entries.size() > Constants.PROFILE_SIZE)
+		throw new NumberFormatException();
+	}
+	catch (NumberFormatException e) {
+	    error("Profiles are up to " + Constants.PROFILE_SIZE +
+		  " first:interval[:alert] entries for different nodes");
+	    return;
+	}
+
+	int pages = Math.max(1, (entries.size() + Constants.PROFILE_PAGE_SIZE - 1) /
+			     Constants.PROFILE_PAGE_SIZE);
+	ProfilesMsg[] pmsgs = new ProfilesMsg[pages];
+	int i = 0;
+	settingsVersion = (settingsVersion + 1) & 0xffff;
+	for (int page = 0; page < pages; page++) {
+	    pmsgs[page] = new ProfilesMsg();
+	    pmsgs[page].set_page((short)page);
+	    pmsgs[page].set_count((short)Math.min(Constants.PROFILE_PAGE_SIZE,
+						  entries.size() - page * Constants.PROFILE_PAGE_SIZE));
+	    pmsgs[page].set_version(settingsVersion);
+	}
+	for (Map.Entry<Integer, int[]> e : entries.entrySet()) {
+	    ProfilesMsg pmsg = pmsgs[i / Constants.PROFILE_PAGE_SIZE];
+	    int slot = i++ % Constants.PROFILE_PAGE_SIZE;
+	    pmsg.setElement_first(slot, e.getKey());
+	    pmsg.setElement_interval(slot, e.getValue()[0]);
+	    pmsg.setElement_alert(slot, (short)e.getValue()[1]);
+	}
+	try {
+	    for (ProfilesMsg pmsg : pmsgs)
+		mote.send(MoteIF.TOS_BCAST_ADDR, pmsg);
+	    tracker.pushed(settingsVersion, System.currentTimeMillis());
+	    updateSettingsStatus();
 	}
 	catch (IOException e) {
 	    error("Cannot send message to mote");
 	}
     }
 
+    /* User pressed the "Blacklist" button. Send the blacklist straight
+       to the target along the route its alerts took, if we know one;
+       otherwise, or if it is not acknowledged in time, disseminate it
+       to the whole network as a settings push. */
+    public synchronized void blacklist() {
+	int targetId, duration;
+
+	try {
+	    targetId = Integer.parseInt(fieldTarget.getText().trim());
+	    duration = Integer.parseInt(fieldDuration.getText().trim());
+	}
+	catch (NumberFormatException e) {
+	    targetId = duration = -1;
+	}
+	int[] route = routes.get(targetId);
+	if (route == null || duration < 0 || duration > 0xffff || pendingCommand >= 0) {
+	    updateSettings();
+	    return;
+	}
+
+	CommandMsg cmsg = new CommandMsg();
+	commandSeqno = (commandSeqno + 1) & 0xffff;
+	cmsg.set_seqno(commandSeqno);
+	cmsg.set_type(Constants.COMMAND_BLACKLIST);
+	cmsg.set_hops((short)route.length);
+	cmsg.set_duration(duration);
+	int[] hops = new int[Constants.COMMAND_MAX_HOPS];
+	System.arraycopy(route, 0, hops, 0, route.length);
+	cmsg.set_route1(hops[0]);
+	cmsg.set_route2(hops[1]);
+	cmsg.set_route3(hops[2]);
+	cmsg.set_route4(hops[3]);
+	cmsg.set_route5(hops[4]);
+	cmsg.set_route6(hops[5]);
+	try {
+	    mote.send(MoteIF.TOS_BCAST_ADDR, cmsg);
+	    pendingCommand = commandSeqno;
+	    commandSent = System.currentTimeMillis();
+	    commandTimer.restart();
+	    message(" Blacklist command " + commandSeqno + " sent to node " + targetId +
+		    " via " + Arrays.toString(route));
+	}
+	catch (IOException e) {
+	    error("Cannot send message to mote");
+	}
+    }
+
+    /* No acknowledgement: fall back to dissemination */
+    synchronized void commandTimedOut() {
+	if (pendingCommand < 0)
+	    return;
+	message(" Blacklist command " + pendingCommand + " not acknowledged," +
+		" disseminating it instead");
+	pendingCommand = -1;
+	updateSettings();
+    }
+
+    synchronized void commandAckReceived(CommandMsg ack) {
+	if (ack.get_ack() == 0 || ack.get_seqno() != pendingCommand)
+	    return;
+	commandTimer.stop();
+	pendingCommand = -1;
+	message(" Blacklist command " + ack.get_seqno() + " acknowledged in " +
+		(System.currentTimeMillis() - commandSent) + " ms");
+    }
+
+    /* Learn the routes to the nodes on an alert's path */
+    synchronized void learnRoutes(AlertMsg alert) {
+	int[] path = { alert.get_path1(), alert.get_path2(), alert.get_path3(),
+		       alert.get_path4(), alert.get_path5(), alert.get_path6() };
+
+	for (int i = 0; i < path.length; i++) {
+	    if (path[i] == NO_HOP || path[i] == 0)
+		break;
+	    routes.put(path[i], Arrays.copyOf(path, i + 1));
+	}
+    }
+
     /* Message received from mote network. Update message area if it's
        a theft message. */
     public void messageReceived(int dest_addr, Message msg) {
 	if (msg instanceof AlertMsg) {
 	    AlertMsg alertMsg = (AlertMsg)msg;
-	    message(	" Node: " + alertMsg.get_packetId() +
+	    message(	" Node: " + alertMsg.get_stolenId() +
+			" Seq: " + alertMsg.get_packetId() +
 			" Voltage: " + alertMsg.get_voltageData() +
 			" Hop1: " + alertMsg.get_path1() +
 			" Hop2: " + alertMsg.get_path2() +
@@ -247,7 +446,70 @@ public class AntiTheftGui implements MessageListener, Messenger {
 			" Hop4: " + alertMsg.get_path4() +
 			" Hop5: " + alertMsg.get_path5() +
 			" Hop6: " + alertMsg.get_path6());
+	    learnRoutes(alertMsg);
+	    if (tracker.reported(alertMsg.get_stolenId(),
+				 alertMsg.get_settingsVersion(),
+				 System.currentTimeMillis()))
+		message(" Settings version " + tracker.pushVersion() +
+			" reached all nodes in " + tracker.convergenceTime() + " ms");
+	    updateSettingsStatus();
 	}
+	else if (msg instanceof RootStatusMsg)
+	    rootStatusReceived((RootStatusMsg)msg);
+	else if (msg instanceof CommandMsg)
+	    commandAckReceived((CommandMsg)msg);
+    }
+
+    /* Show how far the latest settings push has got */
+    void updateSettingsStatus() {
+	if (tracker.pushVersion() < 0)
+	    return;
+
+	String text = "<html>Version " + tracker.pushVersion() + ": ";
+	SortedSet<Integer> stragglers = tracker.stragglers();
+	if (tracker.convergenceTime() >= 0)
+	    text += "converged in " + tracker.convergenceTime() + " ms";
+	else
+	    text += tracker.acknowledged() + " node(s) updated<br>" +
+		"waiting for " + stragglers;
+	settingsStatus.setText(text + "</html>");
+    }
+
+    /* Root health report received. Show it as rates next to the
+       settings, highlight it when the root is falling behind, and log
+       it to stdout so runs can be analysed later. */
+    void rootStatusReceived(RootStatusMsg status) {
+	int seqno = status.get_seqno();
+	double secs = Math.max(status.get_interval(), 1) / 1000.0;
+	int uartPercent = 100 * status.get_uartBusy() / Math.max(status.get_interval(), 1);
+	int lost = lastStatusSeqno < 0 ? 0 : (seqno - lastStatusSeqno - 1) & 0xffff;
+	boolean behind = status.get_dropped() > 0 || status.get_sendFailed() > 0 ||
+	    status.get_maxQueue() >= Constants.ROOT_QUEUE_SIZE;
+
+	lastStatusSeqno = seqno;
+	rootStatus.setForeground(behind ? Color.RED : Color.BLACK);
+	rootStatus.setText("<html>" +
+	    String.format("Rx %.1f/s Fwd %.1f/s<br>", status.get_received() / secs,
+			  status.get_forwarded() / secs) +
+	    "Dropped " + status.get_dropped() +
+	    " Failed " + status.get_sendFailed() + "<br>" +
+	    "Queue " + status.get_queueLen() + "/" + Constants.ROOT_QUEUE_SIZE +
+	    " (max " + status.get_maxQueue() + ")<br>" +
+	    "Serial busy " + uartPercent + "%" +
+	    (lost > 0 ? "<br>" + lost + " report(s) lost" : "") + "</html>");
+
+	System.out.println("root-status" +
+			   " time=" + System.currentTimeMillis() +
+			   " seqno=" + seqno +
+			   " interval=" + status.get_interval() +
+			   " received=" + status.get_received() +
+			   " forwarded=" + status.get_forwarded() +
+			   " dropped=" + status.get_dropped() +
+			   " sendFailed=" + status.get_sendFailed() +
+			   " queueLen=" + status.get_queueLen() +
+			   " maxQueue=" + status.get_maxQueue() +
+			   " uartBusy=" + status.get_uartBusy() +
+			   " lost=" + lost);
     }
 
     /* Just start the app... */
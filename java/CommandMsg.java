@@ -0,0 +1,950 @@
+/**
+ * This class is automatically generated by mig. DO NOT EDIT THIS FILE.
+ * This class implements a Java interface to the 'CommandMsg'
+ * message type.
+ */
+
+public class CommandMsg extends net.tinyos.message.Message {
+
+    /** The default size of this message type in bytes. */
+    public static final int DEFAULT_MESSAGE_SIZE = 22;
+
+    /** The Active Message type associated with this message. */
+    public static final int AM_TYPE = 25;
+
+    /** Create a new CommandMsg of size 22. */
+    public CommandMsg() {
+        super(DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /** Create a new CommandMsg of the given data_length. */
+    public CommandMsg(int data_length) {
+        super(data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg with the given data_length
+     * and base offset.
+     */
+    public CommandMsg(int data_length, int base_offset) {
+        super(data_length, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg using the given byte array
+     * as backing store.
+     */
+    public CommandMsg(byte[] data) {
+        super(data);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg using the given byte array
+     * as backing store, with the given base offset.
+     */
+    public CommandMsg(byte[] data, int base_offset) {
+        super(data, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg using the given byte array
+     * as backing store, with the given base offset and data length.
+     */
+    public CommandMsg(byte[] data, int base_offset, int data_length) {
+        super(data, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg embedded in the given message
+     * at the given base offset.
+     */
+    public CommandMsg(net.tinyos.message.Message msg, int base_offset) {
+        super(msg, base_offset, DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new CommandMsg embedded in the given message
+     * at the given base offset and length.
+     */
+    public CommandMsg(net.tinyos.message.Message msg, int base_offset, int data_length) {
+        super(msg, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+    /* Return a String representation of this message. Includes the
+     * message type name and the non-indexed field values.
+     */
+    public String toString() {
+      String s = "Message <CommandMsg> \n";
+      try {
+        s += "  [seqno=0x"+Long.toHexString(get_seqno())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [rootId=0x"+Long.toHexString(get_rootId())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [type=0x"+Long.toHexString(get_type())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [ack=0x"+Long.toHexString(get_ack())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [hops=0x"+Long.toHexString(get_hops())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [hop=0x"+Long.toHexString(get_hop())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [duration=0x"+Long.toHexString(get_duration())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route1=0x"+Long.toHexString(get_route1())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route2=0x"+Long.toHexString(get_route2())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route3=0x"+Long.toHexString(get_route3())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route4=0x"+Long.toHexString(get_route4())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route5=0x"+Long.toHexString(get_route5())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [route6=0x"+Long.toHexString(get_route6())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      return s;
+    }
+
+    // Message-type-specific access methods appear below.
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: seqno
+    //   Field type: int, unsigned
+    //   Offset (bits): 0
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'seqno' is signed (false).
+     */
+    public static boolean isSigned_seqno() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'seqno' is an array (false).
+     */
+    public static boolean isArray_seqno() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'seqno'
+     */
+    public static int offset_seqno() {
+        return (0 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'seqno'
+     */
+    public static int offsetBits_seqno() {
+        return 0;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'seqno'
+     */
+    public int get_seqno() {
+        return (int)getUIntBEElement(offsetBits_seqno(), 16);
+    }
+
+    /**
+     * Set the value of the field 'seqno'
+     */
+    public void set_seqno(int value) {
+        setUIntBEElement(offsetBits_seqno(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'seqno'
+     */
+    public static int size_seqno() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'seqno'
+     */
+    public static int sizeBits_seqno() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: rootId
+    //   Field type: int, unsigned
+    //   Offset (bits): 16
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'rootId' is signed (false).
+     */
+    public static boolean isSigned_rootId() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'rootId' is an array (false).
+     */
+    public static boolean isArray_rootId() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'rootId'
+     */
+    public static int offset_rootId() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'rootId'
+     */
+    public static int offsetBits_rootId() {
+        return 16;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'rootId'
+     */
+    public int get_rootId() {
+        return (int)getUIntBEElement(offsetBits_rootId(), 16);
+    }
+
+    /**
+     * Set the value of the field 'rootId'
+     */
+    public void set_rootId(int value) {
+        setUIntBEElement(offsetBits_rootId(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'rootId'
+     */
+    public static int size_rootId() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'rootId'
+     */
+    public static int sizeBits_rootId() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: type
+    //   Field type: short, unsigned
+    //   Offset (bits): 32
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'type' is signed (false).
+     */
+    public static boolean isSigned_type() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'type' is an array (false).
+     */
+    public static boolean isArray_type() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'type'
+     */
+    public static int offset_type() {
+        return (32 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'type'
+     */
+    public static int offsetBits_type() {
+        return 32;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'type'
+     */
+    public short get_type() {
+        return (short)getUIntBEElement(offsetBits_type(), 8);
+    }
+
+    /**
+     * Set the value of the field 'type'
+     */
+    public void set_type(short value) {
+        setUIntBEElement(offsetBits_type(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'type'
+     */
+    public static int size_type() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'type'
+     */
+    public static int sizeBits_type() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: ack
+    //   Field type: short, unsigned
+    //   Offset (bits): 40
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'ack' is signed (false).
+     */
+    public static boolean isSigned_ack() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'ack' is an array (false).
+     */
+    public static boolean isArray_ack() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'ack'
+     */
+    public static int offset_ack() {
+        return (40 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'ack'
+     */
+    public static int offsetBits_ack() {
+        return 40;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'ack'
+     */
+    public short get_ack() {
+        return (short)getUIntBEElement(offsetBits_ack(), 8);
+    }
+
+    /**
+     * Set the value of the field 'ack'
+     */
+    public void set_ack(short value) {
+        setUIntBEElement(offsetBits_ack(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'ack'
+     */
+    public static int size_ack() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'ack'
+     */
+    public static int sizeBits_ack() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: hops
+    //   Field type: short, unsigned
+    //   Offset (bits): 48
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'hops' is signed (false).
+     */
+    public static boolean isSigned_hops() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'hops' is an array (false).
+     */
+    public static boolean isArray_hops() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'hops'
+     */
+    public static int offset_hops() {
+        return (48 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'hops'
+     */
+    public static int offsetBits_hops() {
+        return 48;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'hops'
+     */
+    public short get_hops() {
+        return (short)getUIntBEElement(offsetBits_hops(), 8);
+    }
+
+    /**
+     * Set the value of the field 'hops'
+     */
+    public void set_hops(short value) {
+        setUIntBEElement(offsetBits_hops(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'hops'
+     */
+    public static int size_hops() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'hops'
+     */
+    public static int sizeBits_hops() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: hop
+    //   Field type: short, unsigned
+    //   Offset (bits): 56
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'hop' is signed (false).
+     */
+    public static boolean isSigned_hop() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'hop' is an array (false).
+     */
+    public static boolean isArray_hop() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'hop'
+     */
+    public static int offset_hop() {
+        return (56 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'hop'
+     */
+    public static int offsetBits_hop() {
+        return 56;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'hop'
+     */
+    public short get_hop() {
+        return (short)getUIntBEElement(offsetBits_hop(), 8);
+    }
+
+    /**
+     * Set the value of the field 'hop'
+     */
+    public void set_hop(short value) {
+        setUIntBEElement(offsetBits_hop(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'hop'
+     */
+    public static int size_hop() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'hop'
+     */
+    public static int sizeBits_hop() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: duration
+    //   Field type: int, unsigned
+    //   Offset (bits): 64
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'duration' is signed (false).
+     */
+    public static boolean isSigned_duration() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'duration' is an array (false).
+     */
+    public static boolean isArray_duration() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'duration'
+     */
+    public static int offset_duration() {
+        return (64 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'duration'
+     */
+    public static int offsetBits_duration() {
+        return 64;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'duration'
+     */
+    public int get_duration() {
+        return (int)getUIntBEElement(offsetBits_duration(), 16);
+    }
+
+    /**
+     * Set the value of the field 'duration'
+     */
+    public void set_duration(int value) {
+        setUIntBEElement(offsetBits_duration(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'duration'
+     */
+    public static int size_duration() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'duration'
+     */
+    public static int sizeBits_duration() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route1
+    //   Field type: int, unsigned
+    //   Offset (bits): 80
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route1' is signed (false).
+     */
+    public static boolean isSigned_route1() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route1' is an array (false).
+     */
+    public static boolean isArray_route1() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route1'
+     */
+    public static int offset_route1() {
+        return (80 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route1'
+     */
+    public static int offsetBits_route1() {
+        return 80;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route1'
+     */
+    public int get_route1() {
+        return (int)getUIntBEElement(offsetBits_route1(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route1'
+     */
+    public void set_route1(int value) {
+        setUIntBEElement(offsetBits_route1(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route1'
+     */
+    public static int size_route1() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route1'
+     */
+    public static int sizeBits_route1() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route2
+    //   Field type: int, unsigned
+    //   Offset (bits): 96
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route2' is signed (false).
+     */
+    public static boolean isSigned_route2() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route2' is an array (false).
+     */
+    public static boolean isArray_route2() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route2'
+     */
+    public static int offset_route2() {
+        return (96 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route2'
+     */
+    public static int offsetBits_route2() {
+        return 96;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route2'
+     */
+    public int get_route2() {
+        return (int)getUIntBEElement(offsetBits_route2(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route2'
+     */
+    public void set_route2(int value) {
+        setUIntBEElement(offsetBits_route2(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route2'
+     */
+    public static int size_route2() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route2'
+     */
+    public static int sizeBits_route2() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route3
+    //   Field type: int, unsigned
+    //   Offset (bits): 112
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route3' is signed (false).
+     */
+    public static boolean isSigned_route3() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route3' is an array (false).
+     */
+    public static boolean isArray_route3() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route3'
+     */
+    public static int offset_route3() {
+        return (112 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route3'
+     */
+    public static int offsetBits_route3() {
+        return 112;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route3'
+     */
+    public int get_route3() {
+        return (int)getUIntBEElement(offsetBits_route3(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route3'
+     */
+    public void set_route3(int value) {
+        setUIntBEElement(offsetBits_route3(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route3'
+     */
+    public static int size_route3() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route3'
+     */
+    public static int sizeBits_route3() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route4
+    //   Field type: int, unsigned
+    //   Offset (bits): 128
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route4' is signed (false).
+     */
+    public static boolean isSigned_route4() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route4' is an array (false).
+     */
+    public static boolean isArray_route4() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route4'
+     */
+    public static int offset_route4() {
+        return (128 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route4'
+     */
+    public static int offsetBits_route4() {
+        return 128;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route4'
+     */
+    public int get_route4() {
+        return (int)getUIntBEElement(offsetBits_route4(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route4'
+     */
+    public void set_route4(int value) {
+        setUIntBEElement(offsetBits_route4(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route4'
+     */
+    public static int size_route4() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route4'
+     */
+    public static int sizeBits_route4() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route5
+    //   Field type: int, unsigned
+    //   Offset (bits): 144
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route5' is signed (false).
+     */
+    public static boolean isSigned_route5() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route5' is an array (false).
+     */
+    public static boolean isArray_route5() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route5'
+     */
+    public static int offset_route5() {
+        return (144 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route5'
+     */
+    public static int offsetBits_route5() {
+        return 144;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route5'
+     */
+    public int get_route5() {
+        return (int)getUIntBEElement(offsetBits_route5(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route5'
+     */
+    public void set_route5(int value) {
+        setUIntBEElement(offsetBits_route5(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route5'
+     */
+    public static int size_route5() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route5'
+     */
+    public static int sizeBits_route5() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: route6
+    //   Field type: int, unsigned
+    //   Offset (bits): 160
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'route6' is signed (false).
+     */
+    public static boolean isSigned_route6() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'route6' is an array (false).
+     */
+    public static boolean isArray_route6() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'route6'
+     */
+    public static int offset_route6() {
+        return (160 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'route6'
+     */
+    public static int offsetBits_route6() {
+        return 160;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'route6'
+     */
+    public int get_route6() {
+        return (int)getUIntBEElement(offsetBits_route6(), 16);
+    }
+
+    /**
+     * Set the value of the field 'route6'
+     */
+    public void set_route6(int value) {
+        setUIntBEElement(offsetBits_route6(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'route6'
+     */
+    public static int size_route6() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'route6'
+     */
+    public static int sizeBits_route6() {
+        return 16;
+    }
+
+}
@@ -10,13 +10,41 @@
 
 public class Constants  {
     public static final byte LOW_BATTERY = 1;
-    public static final byte DIS_SETTINGS = 42;
+    public static final byte DIS_SAMPLING = 43;
+    public static final byte DIS_REPORTING = 44;
+    public static final byte DIS_BLACKLIST = 45;
+    public static final byte DIS_PROFILES = 49;
     public static final short DEFAULT_CHECK_INTERVAL = 1000;
     public static final byte BROADCAST = 4;
     public static final byte DEFAULT_DETECT = 1;
     public static final byte AM_THEFT = 99;
     public static final byte AM_SETTINGS = 54;
+    public static final byte AM_URGENT_SETTINGS = 55;
+    public static final byte AM_PROFILES = 56;
     public static final byte COL_ALERTS = 11;
     public static final byte DEFAULT_ALERT = 4;
     public static final byte AM_ALERT = 22;
+    public static final byte AM_ROOT_STATUS = 23;
+    public static final byte AM_ENERGY = 24;
+    public static final byte AM_COMMAND = 25;
+    public static final byte AM_URGENT = 26;
+    public static final byte BLACKLIST_PAGE_SIZE = 2;
+    public static final byte BLACKLIST_PAGES = 4;
+    public static final byte BLACKLIST_SIZE = 8;
+    public static final byte PROFILE_PAGE_SIZE = 2;
+    public static final byte PROFILE_PAGES = 4;
+    public static final byte PROFILE_SIZE = 8;
+    public static final byte COMMAND_BLACKLIST = 1;
+    public static final byte COMMAND_MAX_HOPS = 6;
+    public static final byte COMMAND_RETRIES = 3;
+    public static final short COMMAND_TIMEOUT = 5000;
+    public static final byte DISSEMINATION_ITEM_SIZE = 16;
+    public static final byte ROOT_QUEUE_SIZE = 8;
+    public static final byte MSG_POOL_SIZE = 4;
+    public static final byte PATH_DEPTH = 6;
+    public static final byte DUP_CACHE_SIZE = 0;
+    public static final byte AGGREGATION_WINDOW = 0;
+    public static final short LPL_INTERVAL = 512;
+    public static final short ROOT_STATUS_INTERVAL = 5000;
+    public static final int ENERGY_REPORT_INTERVAL = 60000;
 }
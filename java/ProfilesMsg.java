@@ -0,0 +1,720 @@
+/**
+ * This class is automatically generated by mig. DO NOT EDIT THIS FILE.
+ * This class implements a Java interface to the 'ProfilesMsg'
+ * message type.
+ */
+
+public class ProfilesMsg extends net.tinyos.message.Message {
+
+    /** The default size of this message type in bytes. */
+    public static final int DEFAULT_MESSAGE_SIZE = 14;
+
+    /** The Active Message type associated with this message. */
+    public static final int AM_TYPE = 56;
+
+    /** Create a new ProfilesMsg of size 14. */
+    public ProfilesMsg() {
+        super(DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /** Create a new ProfilesMsg of the given data_length. */
+    public ProfilesMsg(int data_length) {
+        super(data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg with the given data_length
+     * and base offset.
+     */
+    public ProfilesMsg(int data_length, int base_offset) {
+        super(data_length, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg using the given byte array
+     * as backing store.
+     */
+    public ProfilesMsg(byte[] data) {
+        super(data);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg using the given byte array
+     * as backing store, with the given base offset.
+     */
+    public ProfilesMsg(byte[] data, int base_offset) {
+        super(data, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg using the given byte array
+     * as backing store, with the given base offset and data length.
+     */
+    public ProfilesMsg(byte[] data, int base_offset, int data_length) {
+        super(data, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg embedded in the given message
+     * at the given base offset.
+     */
+    public ProfilesMsg(net.tinyos.message.Message msg, int base_offset) {
+        super(msg, base_offset, DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new ProfilesMsg embedded in the given message
+     * at the given base offset and length.
+     */
+    public ProfilesMsg(net.tinyos.message.Message msg, int base_offset, int data_length) {
+        super(msg, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+    /* Return a String representation of this message. Includes the
+     * message type name and the non-indexed field values.
+     */
+    public String toString() {
+      String s = "Message <ProfilesMsg> \n";
+      try {
+        s += "  [page=0x"+Long.toHexString(get_page())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [count=0x"+Long.toHexString(get_count())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [first=";
+        for (int i = 0; i < 2; i++) {
+          s += "0x"+Long.toHexString(getElement_first(i) & 0xffff)+" ";
+        }
+        s += "]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [interval=";
+        for (int i = 0; i < 2; i++) {
+          s += "0x"+Long.toHexString(getElement_interval(i) & 0xffff)+" ";
+        }
+        s += "]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [alert=";
+        for (int i = 0; i < 2; i++) {
+          s += "0x"+Long.toHexString(getElement_alert(i) & 0xff)+" ";
+        }
+        s += "]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [version=0x"+Long.toHexString(get_version())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      return s;
+    }
+
+    // Message-type-specific access methods appear below.
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: page
+    //   Field type: short, unsigned
+    //   Offset (bits): 0
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'page' is signed (false).
+     */
+    public static boolean isSigned_page() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'page' is an array (false).
+     */
+    public static boolean isArray_page() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'page'
+     */
+    public static int offset_page() {
+        return (0 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'page'
+     */
+    public static int offsetBits_page() {
+        return 0;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'page'
+     */
+    public short get_page() {
+        return (short)getUIntBEElement(offsetBits_page(), 8);
+    }
+
+    /**
+     * Set the value of the field 'page'
+     */
+    public void set_page(short value) {
+        setUIntBEElement(offsetBits_page(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'page'
+     */
+    public static int size_page() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'page'
+     */
+    public static int sizeBits_page() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: count
+    //   Field type: short, unsigned
+    //   Offset (bits): 8
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'count' is signed (false).
+     */
+    public static boolean isSigned_count() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'count' is an array (false).
+     */
+    public static boolean isArray_count() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'count'
+     */
+    public static int offset_count() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'count'
+     */
+    public static int offsetBits_count() {
+        return 8;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'count'
+     */
+    public short get_count() {
+        return (short)getUIntBEElement(offsetBits_count(), 8);
+    }
+
+    /**
+     * Set the value of the field 'count'
+     */
+    public void set_count(short value) {
+        setUIntBEElement(offsetBits_count(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'count'
+     */
+    public static int size_count() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'count'
+     */
+    public static int sizeBits_count() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: first
+    //   Field type: int[], unsigned
+    //   Offset (bits): 16
+    //   Size of each element (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'first' is signed (false).
+     */
+    public static boolean isSigned_first() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'first' is an array (true).
+     */
+    public static boolean isArray_first() {
+        return true;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'first'
+     */
+    public static int offset_first(int index1) {
+        int offset = 16;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 16;
+        return (offset / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'first'
+     */
+    public static int offsetBits_first(int index1) {
+        int offset = 16;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 16;
+        return offset;
+    }
+
+    /**
+     * Return the entire array 'first' as a int[]
+     */
+    public int[] get_first() {
+        int[] tmp = new int[2];
+        for (int index0 = 0; index0 < numElements_first(0); index0++) {
+            tmp[index0] = getElement_first(index0);
+        }
+        return tmp;
+    }
+
+    /**
+     * Set the contents of the array 'first' from the given int[]
+     */
+    public void set_first(int[] value) {
+        for (int index0 = 0; index0 < value.length; index0++) {
+            setElement_first(index0, value[index0]);
+        }
+    }
+
+    /**
+     * Return an element (as a int) of the array 'first'
+     */
+    public int getElement_first(int index1) {
+        return (int)getUIntBEElement(offsetBits_first(index1), 16);
+    }
+
+    /**
+     * Set an element of the array 'first'
+     */
+    public void setElement_first(int index1, int value) {
+        setUIntBEElement(offsetBits_first(index1), 16, value);
+    }
+
+    /**
+     * Return the total size, in bytes, of the array 'first'
+     */
+    public static int totalSize_first() {
+        return (32 / 8);
+    }
+
+    /**
+     * Return the total size, in bits, of the array 'first'
+     */
+    public static int totalSizeBits_first() {
+        return 32;
+    }
+
+    /**
+     * Return the size, in bytes, of each element of the array 'first'
+     */
+    public static int elementSize_first() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of each element of the array 'first'
+     */
+    public static int elementSizeBits_first() {
+        return 16;
+    }
+
+    /**
+     * Return the number of dimensions in the array 'first'
+     */
+    public static int numDimensions_first() {
+        return 1;
+    }
+
+    /**
+     * Return the number of elements in the array 'first'
+     */
+    public static int numElements_first() {
+        return 2;
+    }
+
+    /**
+     * Return the number of elements in the array 'first'
+     * for the given dimension.
+     */
+    public static int numElements_first(int dimension) {
+      int array_dims[] = { 2,  };
+        if (dimension < 0 || dimension >= 1) throw new ArrayIndexOutOfBoundsException();
+        if (array_dims[dimension] == 0) throw new IllegalArgumentException("Array dimension "+dimension+" has unknown size");
+        return array_dims[dimension];
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: interval
+    //   Field type: int[], unsigned
+    //   Offset (bits): 48
+    //   Size of each element (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'interval' is signed (false).
+     */
+    public static boolean isSigned_interval() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'interval' is an array (true).
+     */
+    public static boolean isArray_interval() {
+        return true;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'interval'
+     */
+    public static int offset_interval(int index1) {
+        int offset = 48;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 16;
+        return (offset / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'interval'
+     */
+    public static int offsetBits_interval(int index1) {
+        int offset = 48;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 16;
+        return offset;
+    }
+
+    /**
+     * Return the entire array 'interval' as a int[]
+     */
+    public int[] get_interval() {
+        int[] tmp = new int[2];
+        for (int index0 = 0; index0 < numElements_interval(0); index0++) {
+            tmp[index0] = getElement_interval(index0);
+        }
+        return tmp;
+    }
+
+    /**
+     * Set the contents of the array 'interval' from the given int[]
+     */
+    public void set_interval(int[] value) {
+        for (int index0 = 0; index0 < value.length; index0++) {
+            setElement_interval(index0, value[index0]);
+        }
+    }
+
+    /**
+     * Return an element (as a int) of the array 'interval'
+     */
+    public int getElement_interval(int index1) {
+        return (int)getUIntBEElement(offsetBits_interval(index1), 16);
+    }
+
+    /**
+     * Set an element of the array 'interval'
+     */
+    public void setElement_interval(int index1, int value) {
+        setUIntBEElement(offsetBits_interval(index1), 16, value);
+    }
+
+    /**
+     * Return the total size, in bytes, of the array 'interval'
+     */
+    public static int totalSize_interval() {
+        return (32 / 8);
+    }
+
+    /**
+     * Return the total size, in bits, of the array 'interval'
+     */
+    public static int totalSizeBits_interval() {
+        return 32;
+    }
+
+    /**
+     * Return the size, in bytes, of each element of the array 'interval'
+     */
+    public static int elementSize_interval() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of each element of the array 'interval'
+     */
+    public static int elementSizeBits_interval() {
+        return 16;
+    }
+
+    /**
+     * Return the number of dimensions in the array 'interval'
+     */
+    public static int numDimensions_interval() {
+        return 1;
+    }
+
+    /**
+     * Return the number of elements in the array 'interval'
+     */
+    public static int numElements_interval() {
+        return 2;
+    }
+
+    /**
+     * Return the number of elements in the array 'interval'
+     * for the given dimension.
+     */
+    public static int numElements_interval(int dimension) {
+      int array_dims[] = { 2,  };
+        if (dimension < 0 || dimension >= 1) throw new ArrayIndexOutOfBoundsException();
+        if (array_dims[dimension] == 0) throw new IllegalArgumentException("Array dimension "+dimension+" has unknown size");
+        return array_dims[dimension];
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: alert
+    //   Field type: short[], unsigned
+    //   Offset (bits): 80
+    //   Size of each element (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'alert' is signed (false).
+     */
+    public static boolean isSigned_alert() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'alert' is an array (true).
+     */
+    public static boolean isArray_alert() {
+        return true;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'alert'
+     */
+    public static int offset_alert(int index1) {
+        int offset = 80;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 8;
+        return (offset / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'alert'
+     */
+    public static int offsetBits_alert(int index1) {
+        int offset = 80;
+        if (index1 < 0 || index1 >= 2) throw new ArrayIndexOutOfBoundsException();
+        offset += 0 + index1 * 8;
+        return offset;
+    }
+
+    /**
+     * Return the entire array 'alert' as a short[]
+     */
+    public short[] get_alert() {
+        short[] tmp = new short[2];
+        for (int index0 = 0; index0 < numElements_alert(0); index0++) {
+            tmp[index0] = getElement_alert(index0);
+        }
+        return tmp;
+    }
+
+    /**
+     * Set the contents of the array 'alert' from the given short[]
+     */
+    public void set_alert(short[] value) {
+        for (int index0 = 0; index0 < value.length; index0++) {
+            setElement_alert(index0, value[index0]);
+        }
+    }
+
+    /**
+     * Return an element (as a short) of the array 'alert'
+     */
+    public short getElement_alert(int index1) {
+        return (short)getUIntBEElement(offsetBits_alert(index1), 8);
+    }
+
+    /**
+     * Set an element of the array 'alert'
+     */
+    public void setElement_alert(int index1, short value) {
+        setUIntBEElement(offsetBits_alert(index1), 8, value);
+    }
+
+    /**
+     * Return the total size, in bytes, of the array 'alert'
+     */
+    public static int totalSize_alert() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the total size, in bits, of the array 'alert'
+     */
+    public static int totalSizeBits_alert() {
+        return 16;
+    }
+
+    /**
+     * Return the size, in bytes, of each element of the array 'alert'
+     */
+    public static int elementSize_alert() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of each element of the array 'alert'
+     */
+    public static int elementSizeBits_alert() {
+        return 8;
+    }
+
+    /**
+     * Return the number of dimensions in the array 'alert'
+     */
+    public static int numDimensions_alert() {
+        return 1;
+    }
+
+    /**
+     * Return the number of elements in the array 'alert'
+     */
+    public static int numElements_alert() {
+        return 2;
+    }
+
+    /**
+     * Return the number of elements in the array 'alert'
+     * for the given dimension.
+     */
+    public static int numElements_alert(int dimension) {
+      int array_dims[] = { 2,  };
+        if (dimension < 0 || dimension >= 1) throw new ArrayIndexOutOfBoundsException();
+        if (array_dims[dimension] == 0) throw new IllegalArgumentException("Array dimension "+dimension+" has unknown size");
+        return array_dims[dimension];
+    }
+
+    /**
+     * Fill in the array 'alert' with a String
+     */
+    public void setString_alert(String s) { 
+         int len = s.length();
+         int i;
+         for (i = 0; i < len; i++) {
+             setElement_alert(i, (short)s.charAt(i));
+         }
+         setElement_alert(i, (short)0); //null terminate
+    }
+
+    /**
+     * Read the array 'alert' as a String
+     */
+    public String getString_alert() { 
+         char carr[] = new char[Math.min(net.tinyos.message.Message.MAX_CONVERTED_STRING_LENGTH,2)];
+         int i;
+         for (i = 0; i < carr.length; i++) {
+             if ((char)getElement_alert(i) == (char)0) break;
+             carr[i] = (char)getElement_alert(i);
+         }
+         return new String(carr,0,i);
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: version
+    //   Field type: int, unsigned
+    //   Offset (bits): 96
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'version' is signed (false).
+     */
+    public static boolean isSigned_version() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'version' is an array (false).
+     */
+    public static boolean isArray_version() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'version'
+     */
+    public static int offset_version() {
+        return (96 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'version'
+     */
+    public static int offsetBits_version() {
+        return 96;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'version'
+     */
+    public int get_version() {
+        return (int)getUIntBEElement(offsetBits_version(), 16);
+    }
+
+    /**
+     * Set the value of the field 'version'
+     */
+    public void set_version(int value) {
+        setUIntBEElement(offsetBits_version(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'version'
+     */
+    public static int size_version() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'version'
+     */
+    public static int sizeBits_version() {
+        return 16;
+    }
+
+}
@@ -0,0 +1,686 @@
+/**
+ * This class is automatically generated by mig. DO NOT EDIT THIS FILE.
+ * This class implements a Java interface to the 'RootStatusMsg'
+ * message type.
+ */
+
+public class RootStatusMsg extends net.tinyos.message.Message {
+
+    /** The default size of this message type in bytes. */
+    public static final int DEFAULT_MESSAGE_SIZE = 16;
+
+    /** The Active Message type associated with this message. */
+    public static final int AM_TYPE = 23;
+
+    /** Create a new RootStatusMsg of size 16. */
+    public RootStatusMsg() {
+        super(DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /** Create a new RootStatusMsg of the given data_length. */
+    public RootStatusMsg(int data_length) {
+        super(data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg with the given data_length
+     * and base offset.
+     */
+    public RootStatusMsg(int data_length, int base_offset) {
+        super(data_length, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg using the given byte array
+     * as backing store.
+     */
+    public RootStatusMsg(byte[] data) {
+        super(data);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg using the given byte array
+     * as backing store, with the given base offset.
+     */
+    public RootStatusMsg(byte[] data, int base_offset) {
+        super(data, base_offset);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg using the given byte array
+     * as backing store, with the given base offset and data length.
+     */
+    public RootStatusMsg(byte[] data, int base_offset, int data_length) {
+        super(data, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg embedded in the given message
+     * at the given base offset.
+     */
+    public RootStatusMsg(net.tinyos.message.Message msg, int base_offset) {
+        super(msg, base_offset, DEFAULT_MESSAGE_SIZE);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+     * Create a new RootStatusMsg embedded in the given message
+     * at the given base offset and length.
+     */
+    public RootStatusMsg(net.tinyos.message.Message msg, int base_offset, int data_length) {
+        super(msg, base_offset, data_length);
+        amTypeSet(AM_TYPE);
+    }
+
+    /**
+    /* Return a String representation of this message. Includes the
+     * message type name and the non-indexed field values.
+     */
+    public String toString() {
+      String s = "Message <RootStatusMsg> \n";
+      try {
+        s += "  [seqno=0x"+Long.toHexString(get_seqno())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [interval=0x"+Long.toHexString(get_interval())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [received=0x"+Long.toHexString(get_received())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [forwarded=0x"+Long.toHexString(get_forwarded())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [dropped=0x"+Long.toHexString(get_dropped())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [sendFailed=0x"+Long.toHexString(get_sendFailed())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [uartBusy=0x"+Long.toHexString(get_uartBusy())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [queueLen=0x"+Long.toHexString(get_queueLen())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [maxQueue=0x"+Long.toHexString(get_maxQueue())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      return s;
+    }
+
+    // Message-type-specific access methods appear below.
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: seqno
+    //   Field type: int, unsigned
+    //   Offset (bits): 0
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'seqno' is signed (false).
+     */
+    public static boolean isSigned_seqno() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'seqno' is an array (false).
+     */
+    public static boolean isArray_seqno() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'seqno'
+     */
+    public static int offset_seqno() {
+        return (0 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'seqno'
+     */
+    public static int offsetBits_seqno() {
+        return 0;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'seqno'
+     */
+    public int get_seqno() {
+        return (int)getUIntBEElement(offsetBits_seqno(), 16);
+    }
+
+    /**
+     * Set the value of the field 'seqno'
+     */
+    public void set_seqno(int value) {
+        setUIntBEElement(offsetBits_seqno(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'seqno'
+     */
+    public static int size_seqno() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'seqno'
+     */
+    public static int sizeBits_seqno() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: interval
+    //   Field type: int, unsigned
+    //   Offset (bits): 16
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'interval' is signed (false).
+     */
+    public static boolean isSigned_interval() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'interval' is an array (false).
+     */
+    public static boolean isArray_interval() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'interval'
+     */
+    public static int offset_interval() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'interval'
+     */
+    public static int offsetBits_interval() {
+        return 16;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'interval'
+     */
+    public int get_interval() {
+        return (int)getUIntBEElement(offsetBits_interval(), 16);
+    }
+
+    /**
+     * Set the value of the field 'interval'
+     */
+    public void set_interval(int value) {
+        setUIntBEElement(offsetBits_interval(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'interval'
+     */
+    public static int size_interval() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'interval'
+     */
+    public static int sizeBits_interval() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: received
+    //   Field type: int, unsigned
+    //   Offset (bits): 32
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'received' is signed (false).
+     */
+    public static boolean isSigned_received() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'received' is an array (false).
+     */
+    public static boolean isArray_received() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'received'
+     */
+    public static int offset_received() {
+        return (32 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'received'
+     */
+    public static int offsetBits_received() {
+        return 32;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'received'
+     */
+    public int get_received() {
+        return (int)getUIntBEElement(offsetBits_received(), 16);
+    }
+
+    /**
+     * Set the value of the field 'received'
+     */
+    public void set_received(int value) {
+        setUIntBEElement(offsetBits_received(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'received'
+     */
+    public static int size_received() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'received'
+     */
+    public static int sizeBits_received() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: forwarded
+    //   Field type: int, unsigned
+    //   Offset (bits): 48
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'forwarded' is signed (false).
+     */
+    public static boolean isSigned_forwarded() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'forwarded' is an array (false).
+     */
+    public static boolean isArray_forwarded() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'forwarded'
+     */
+    public static int offset_forwarded() {
+        return (48 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'forwarded'
+     */
+    public static int offsetBits_forwarded() {
+        return 48;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'forwarded'
+     */
+    public int get_forwarded() {
+        return (int)getUIntBEElement(offsetBits_forwarded(), 16);
+    }
+
+    /**
+     * Set the value of the field 'forwarded'
+     */
+    public void set_forwarded(int value) {
+        setUIntBEElement(offsetBits_forwarded(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'forwarded'
+     */
+    public static int size_forwarded() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'forwarded'
+     */
+    public static int sizeBits_forwarded() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: dropped
+    //   Field type: int, unsigned
+    //   Offset (bits): 64
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'dropped' is signed (false).
+     */
+    public static boolean isSigned_dropped() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'dropped' is an array (false).
+     */
+    public static boolean isArray_dropped() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'dropped'
+     */
+    public static int offset_dropped() {
+        return (64 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'dropped'
+     */
+    public static int offsetBits_dropped() {
+        return 64;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'dropped'
+     */
+    public int get_dropped() {
+        return (int)getUIntBEElement(offsetBits_dropped(), 16);
+    }
+
+    /**
+     * Set the value of the field 'dropped'
+     */
+    public void set_dropped(int value) {
+        setUIntBEElement(offsetBits_dropped(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'dropped'
+     */
+    public static int size_dropped() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'dropped'
+     */
+    public static int sizeBits_dropped() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: sendFailed
+    //   Field type: int, unsigned
+    //   Offset (bits): 80
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'sendFailed' is signed (false).
+     */
+    public static boolean isSigned_sendFailed() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'sendFailed' is an array (false).
+     */
+    public static boolean isArray_sendFailed() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'sendFailed'
+     */
+    public static int offset_sendFailed() {
+        return (80 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'sendFailed'
+     */
+    public static int offsetBits_sendFailed() {
+        return 80;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'sendFailed'
+     */
+    public int get_sendFailed() {
+        return (int)getUIntBEElement(offsetBits_sendFailed(), 16);
+    }
+
+    /**
+     * Set the value of the field 'sendFailed'
+     */
+    public void set_sendFailed(int value) {
+        setUIntBEElement(offsetBits_sendFailed(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'sendFailed'
+     */
+    public static int size_sendFailed() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'sendFailed'
+     */
+    public static int sizeBits_sendFailed() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: uartBusy
+    //   Field type: int, unsigned
+    //   Offset (bits): 96
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'uartBusy' is signed (false).
+     */
+    public static boolean isSigned_uartBusy() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'uartBusy' is an array (false).
+     */
+    public static boolean isArray_uartBusy() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'uartBusy'
+     */
+    public static int offset_uartBusy() {
+        return (96 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'uartBusy'
+     */
+    public static int offsetBits_uartBusy() {
+        return 96;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'uartBusy'
+     */
+    public int get_uartBusy() {
+        return (int)getUIntBEElement(offsetBits_uartBusy(), 16);
+    }
+
+    /**
+     * Set the value of the field 'uartBusy'
+     */
+    public void set_uartBusy(int value) {
+        setUIntBEElement(offsetBits_uartBusy(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'uartBusy'
+     */
+    public static int size_uartBusy() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'uartBusy'
+     */
+    public static int sizeBits_uartBusy() {
+        return 16;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: queueLen
+    //   Field type: short, unsigned
+    //   Offset (bits): 112
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'queueLen' is signed (false).
+     */
+    public static boolean isSigned_queueLen() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'queueLen' is an array (false).
+     */
+    public static boolean isArray_queueLen() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'queueLen'
+     */
+    public static int offset_queueLen() {
+        return (112 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'queueLen'
+     */
+    public static int offsetBits_queueLen() {
+        return 112;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'queueLen'
+     */
+    public short get_queueLen() {
+        return (short)getUIntBEElement(offsetBits_queueLen(), 8);
+    }
+
+    /**
+     * Set the value of the field 'queueLen'
+     */
+    public void set_queueLen(short value) {
+        setUIntBEElement(offsetBits_queueLen(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'queueLen'
+     */
+    public static int size_queueLen() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'queueLen'
+     */
+    public static int sizeBits_queueLen() {
+        return 8;
+    }
+
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: maxQueue
+    //   Field type: short, unsigned
+    //   Offset (bits): 120
+    //   Size (bits): 8
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'maxQueue' is signed (false).
+     */
+    public static boolean isSigned_maxQueue() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'maxQueue' is an array (false).
+     */
+    public static boolean isArray_maxQueue() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'maxQueue'
+     */
+    public static int offset_maxQueue() {
+        return (120 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'maxQueue'
+     */
+    public static int offsetBits_maxQueue() {
+        return 120;
+    }
+
+    /**
+     * Return the value (as a short) of the field 'maxQueue'
+     */
+    public short get_maxQueue() {
+        return (short)getUIntBEElement(offsetBits_maxQueue(), 8);
+    }
+
+    /**
+     * Set the value of the field 'maxQueue'
+     */
+    public void set_maxQueue(short value) {
+        setUIntBEElement(offsetBits_maxQueue(), 8, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'maxQueue'
+     */
+    public static int size_maxQueue() {
+        return (8 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'maxQueue'
+     */
+    public static int sizeBits_maxQueue() {
+        return 8;
+    }
+
+}
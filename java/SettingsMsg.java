@@ -11,12 +11,12 @@
 public class SettingsMsg extends net.tinyos.message.Message {
 
     /** The default size of this message type in bytes. */
-    public static final int DEFAULT_MESSAGE_SIZE = 8;
+    public static final int DEFAULT_MESSAGE_SIZE = 10;
 
     /** The Active Message type associated with this message. */
     public static final int AM_TYPE = 54;
 
-    /** Create a new SettingsMsg of size 8. */
+    /** Create a new SettingsMsg of size 10. */
     public SettingsMsg() {
         super(DEFAULT_MESSAGE_SIZE);
         amTypeSet(AM_TYPE);
@@ -103,6 +103,9 @@ public class SettingsMsg extends net.tinyos.message.Message {
       try {
         s += "  [duration=0x"+Long.toHexString(get_duration())+"]\n";
       } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
+      try {
+        s += "  [version=0x"+Long.toHexString(get_version())+"]\n";
+      } catch (ArrayIndexOutOfBoundsException aioobe) { /* Skip field */ }
       return s;
     }
 
@@ -423,4 +426,67 @@ public class SettingsMsg extends net.tinyos.message.Message {
         return 16;
     }
 
+    /////////////////////////////////////////////////////////
+    // Accessor methods for field: version
+    //   Field type: int, unsigned
+    //   Offset (bits): 64
+    //   Size (bits): 16
+    /////////////////////////////////////////////////////////
+
+    /**
+     * Return whether the field 'version' is signed (false).
+     */
+    public static boolean isSigned_version() {
+        return false;
+    }
+
+    /**
+     * Return whether the field 'version' is an array (false).
+     */
+    public static boolean isArray_version() {
+        return false;
+    }
+
+    /**
+     * Return the offset (in bytes) of the field 'version'
+     */
+    public static int offset_version() {
+        return (64 / 8);
+    }
+
+    /**
+     * Return the offset (in bits) of the field 'version'
+     */
+    public static int offsetBits_version() {
+        return 64;
+    }
+
+    /**
+     * Return the value (as a int) of the field 'version'
+     */
+    public int get_version() {
+        return (int)getUIntBEElement(offsetBits_version(), 16);
+    }
+
+    /**
+     * Set the value of the field 'version'
+     */
+    public void set_version(int value) {
+        setUIntBEElement(offsetBits_version(), 16, value);
+    }
+
+    /**
+     * Return the size, in bytes, of the field 'version'
+     */
+    public static int size_version() {
+        return (16 / 8);
+    }
+
+    /**
+     * Return the size, in bits, of the field 'version'
+     */
+    public static int sizeBits_version() {
+        return 16;
+    }
+
 }
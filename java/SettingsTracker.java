@@ -0,0 +1,89 @@
+import java.util.*;
+
+/**
+ * Tracks how far the latest settings push has spread through the network.
+ * Every alert carries the settings version its originating node is
+ * running. A push is converged once every node we have heard from
+ * reports the pushed version; until then the nodes still reporting an
+ * older version are the stragglers.
+ */
+public class SettingsTracker {
+    /* Version each node reported in its most recent alert */
+    Map<Integer, Integer> nodeVersion = new TreeMap<Integer, Integer>();
+
+    /* The latest push: its version, when it was sent, the nodes that had
+       not yet reported it and how long each other node took to do so */
+    int pushVersion = -1;
+    long pushTime;
+    SortedSet<Integer> stragglers = new TreeSet<Integer>();
+    Map<Integer, Long> ackDelay = new TreeMap<Integer, Long>();
+    long convergenceTime = -1;
+
+    /* Record a settings push. All nodes heard from so far are expected to
+       pick it up. */
+    public synchronized void pushed(int version, long time) {
+	pushVersion = version;
+	pushTime = time;
+	convergenceTime = -1;
+	ackDelay.clear();
+	stragglers.clear();
+	for (Map.Entry<Integer, Integer> e : nodeVersion.entrySet())
+	    if (e.getValue() != version)
+		stragglers.add(e.getKey());
+	if (stragglers.isEmpty() && !nodeVersion.isEmpty())
+	    convergenceTime = 0;
+    }
+
+    /* Record the settings version reported by node in an alert. Returns
+       true if this report completed convergence of the latest push. A
+       node first heard after the push that runs older settings is a
+       straggler too. Only a node's first report of the push counts
+       towards its delay. */
+    public synchronized boolean reported(int node, int version, long time) {
+	boolean firstHeard = !nodeVersion.containsKey(node);
+
+	nodeVersion.put(node, version);
+	if (pushVersion < 0)
+	    return false;
+	if (version != pushVersion) {
+	    if (firstHeard && stragglers.add(node))
+		convergenceTime = -1;
+	    return false;
+	}
+
+	if (!ackDelay.containsKey(node))
+	    ackDelay.put(node, time - pushTime);
+	if (stragglers.remove(node) && stragglers.isEmpty()) {
+	    convergenceTime = time - pushTime;
+	    return true;
+	}
+	return false;
+    }
+
+    /* Version of the latest push (-1 if nothing was pushed yet) */
+    public synchronized int pushVersion() {
+	return pushVersion;
+    }
+
+    /* Time from the latest push until all nodes reported it, -1 if that
+       has not happened yet */
+    public synchronized long convergenceTime() {
+	return convergenceTime;
+    }
+
+    /* Nodes still running older settings */
+    public synchronized SortedSet<Integer> stragglers() {
+	return new TreeSet<Integer>(stragglers);
+    }
+
+    /* Number of nodes known to run the latest push */
+    public synchronized int acknowledged() {
+	return ackDelay.size();
+    }
+
+    /* Per-node delay (ms) between the latest push and its first alert
+       reporting the new version */
+    public synchronized Map<Integer, Long> ackDelays() {
+	return new TreeMap<Integer, Long>(ackDelay);
+    }
+}
@@ -0,0 +1,254 @@
+#!/usr/bin/env python
+"""Cycle counts and stack use of the AntiTheft node code on a micaz.
+
+Runs a build of the node code (main.exe) on a few micaz motes under the
+Avrora instruction-level simulator. Every mote originates an alert each
+check interval and floods the others' alerts, so the receive -> forward
+path runs continuously. Avrora's profile monitor counts the cycles spent
+at each instruction. This script maps them onto the functions of
+main.exe's symbol table. It prints the functions of the receive ->
+forward path (--path) and the busiest others, with calls, cycles per
+call and share of all cycles. It also reads the stack high-water mark
+from Avrora's stack monitor.
+
+    $ prof/avrprofile.py --avrora avrora.jar -o profile Nodes/build/micaz/main.exe
+    $ prof/avrprofile.py --avrora avrora.jar --baseline baseline.json main.exe
+
+writes profile.json and profile.csv. --baseline compares them with an
+earlier profile.json and exits with status 1 if a path function got
+more than --tolerance slower per call or the stack grew.
+
+nesC and avr-gcc inline most small functions, so by default a profiled
+function includes everything inlined into it. For example,
+CC2420ReceiveP__receiveDone_task__runTask contains the AM dispatch and
+AntiTheftP__0__TheftReceive__receive. prof/Makefile builds with -fno-inline
+(unless INLINE=1) to attribute cycles to each nesC function, at the
+price of some call overhead that the real image does not have.
+"""
+
+from __future__ import print_function
+
+import argparse
+import bisect
+import csv
+import json
+import re
+import struct
+import subprocess
+import sys
+
+PATH = [
+    r"^AntiTheftP__\d+__(TheftReceive|TheftSend|blacklist|sendTask|queueAlert|aggregate)",
+    r"^AntiTheftP__\d+__(onPath|prependToPath|forwardedBefore|rememberForwarded)",
+    r"^PoolP__\d+__Pool__|^QueueC__\d+__Queue__",
+    r"^CC2420(Receive|Transmit|ActiveMessage|TinyosNetwork|Csma)P__",
+    r"^UniqueReceiveP__|^UniqueSendP__",
+    r"^AMQueueImplP__|^AMQueueEntryP__",
+    r"^CC2420SpiP__|^HplAtm128UartP|^Atm128SpiP__",
+]
+
+CPU_HZ = 7372800  # micaz system clock
+
+
+def functions(path):
+    """(address, size, name) of the functions in an AVR ELF executable"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or bytearray(data)[4] != 1:
+        raise ValueError("%s is not a 32-bit ELF file" % path)
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2e)
+    sections = [struct.unpack_from("<10I", data, shoff + i * shentsize) for i in range(shnum)]
+    result = []
+    for sh in sections:
+        if sh[1] != 2:  # SHT_SYMTAB
+            continue
+        strtab = sections[sh[6]][4]
+        for i in range(sh[5] // 16):
+            name, value, size, info, _, _ = struct.unpack_from("<IIIBBH", data, sh[4] + i * 16)
+            if info & 0xf == 2 and size:  # STT_FUNC
+                end = data.index(b"\0", strtab + name)
+                result.append((value, size, data[strtab + name:end].decode()))
+    return sorted(result)
+
+
+def run_avrora(avrora, image, nodes, seconds):
+    command = ["java", "-jar", avrora, "-platform=micaz", "-simulation=sensor-network",
+               "-nodecount=%d" % nodes, "-seconds=%g" % seconds, "-colors=false",
+               "-monitors=profile,stack", "-record-cycles=true", image]
+    return subprocess.check_output(command, universal_newlines=True)
+
+
+ADDRESS = re.compile(r"^\s*(0x[0-9a-fA-F]+)(?:\s*-\s*(0x[0-9a-fA-F]+))?:?\s+(.*)$")
+STACK = re.compile(r"max\w*\s+stack\w*[^0-9]*(\d+)", re.I)
+
+
+def parse_avrora(text):
+    """Per-instruction (start, end, count, cycles) ranges summed over all
+    motes, and the largest stack high-water mark. The profile's columns
+    are found from its header (Address Count Run Cycles ...)."""
+    ranges = []
+    stack = None
+    count_col = cycles_col = None
+    for line in text.splitlines():
+        words = line.split()
+        if "Address" in words and "Cycles" in words:
+            after = words[words.index("Address") + 1:]
+            count_col, cycles_col = after.index("Count"), after.index("Cycles")
+            continue
+        m = STACK.search(line)
+        if m:
+            stack = max(stack or 0, int(m.group(1)))
+            continue
+        m = ADDRESS.match(line)
+        if m and cycles_col is not None:
+            values = [v.rstrip("%") for v in m.group(3).split()]
+            try:
+                count, cycles = int(values[count_col]), int(values[cycles_col])
+            except (IndexError, ValueError):
+                continue
+            start = int(m.group(1), 16)
+            end = int(m.group(2), 16) if m.group(2) else start
+            ranges.append((start, end, count, cycles))
+    return ranges, stack
+
+
+def attribute(funcs, ranges):
+    """Cycles and calls (executions of the entry instruction) per function.
+    A range spanning several functions is split by bytes."""
+    starts = [f[0] for f in funcs]
+    stats = dict((name, {"address": a, "bytes": size, "calls": 0, "cycles": 0})
+                 for a, size, name in funcs)
+    other = 0
+    for start, end, count, cycles in ranges:
+        span = end - start + 2  # AVR instructions are at least two bytes
+        a = start
+        while a <= end:
+            i = bisect.bisect_right(starts, a) - 1
+            if i >= 0 and a < funcs[i][0] + funcs[i][1]:
+                address, size, name = funcs[i]
+                stop = min(end + 2, address + size)
+                stats[name]["cycles"] += cycles * (stop - a) // span
+                if a == address:
+                    stats[name]["calls"] += count
+                a = stop
+            else:
+                other += cycles * 2 // span
+                a += 2
+    return stats, other
+
+
+def module(name):
+    return name.split("__")[0]
+
+
+def on_path(name, patterns):
+    return any(re.search(p, name) for p in patterns)
+
+
+def write(prefix, stats, total, stack, patterns, seconds, nodes):
+    rows = []
+    for name, s in stats.items():
+        if not s["cycles"]:
+            continue
+        rows.append({"function": name, "module": module(name), "path": on_path(name, patterns),
+                     "calls": s["calls"], "cycles": s["cycles"], "bytes": s["bytes"],
+                     "cyclesPerCall": float(s["cycles"]) / s["calls"] if s["calls"] else None,
+                     "share": float(s["cycles"]) / total if total else 0.0})
+    rows.sort(key=lambda r: -r["cycles"])
+    with open(prefix + ".json", "w") as f:
+        json.dump({"seconds": seconds, "nodes": nodes, "totalCycles": total,
+                   "stackHighWater": stack, "functions": rows}, f, indent=2, sort_keys=True)
+        f.write("\n")
+    with open(prefix + ".csv", "w") as f:
+        out = csv.DictWriter(f, ("function", "module", "path", "calls", "cycles", "cyclesPerCall",
+                                 "share", "bytes"), lineterminator="\n")
+        out.writeheader()
+        out.writerows(rows)
+    return rows
+
+
+def show(rows, total, stack, seconds, nodes, top):
+    print("%d motes, %g s: %d cycles (%.1f%% of the CPU), stack high-water mark %s bytes" % (
+        nodes, seconds, total, 100.0 * total / (CPU_HZ * seconds * nodes), stack))
+    print("%-56s %9s %12s %10s %7s" % ("function", "calls", "cycles", "per call", "share"))
+    path = [r for r in rows if r["path"]]
+    others = [r for r in rows if not r["path"]][:top]
+    for title, group in (("receive -> forward path", path), ("busiest others", others)):
+        print("-- %s" % title)
+        for r in group:
+            print("%-56s %9d %12d %10s %6.2f%%" % (
+                r["function"][:56], r["calls"], r["cycles"],
+                "%.0f" % r["cyclesPerCall"] if r["cyclesPerCall"] is not None else "-",
+                100 * r["share"]))
+
+
+def compare(rows, stack, path, tolerance):
+    """True unless a path function got slower per call, or the stack
+    deeper, than in the baseline profile at path"""
+    with open(path) as f:
+        baseline = json.load(f)
+    old = dict((r["function"], r) for r in baseline["functions"])
+    ok = True
+    for r in rows:
+        b = old.get(r["function"])
+        if not r["path"] or not b or not b["cyclesPerCall"] or r["cyclesPerCall"] is None:
+            continue
+        change = r["cyclesPerCall"] / b["cyclesPerCall"] - 1
+        if abs(change) > tolerance:
+            print("%-56s %8.0f -> %8.0f cycles/call (%+.0f%%)" % (
+                r["function"][:56], b["cyclesPerCall"], r["cyclesPerCall"], 100 * change))
+            ok = ok and change < 0
+    if stack is not None and baseline.get("stackHighWater") is not None:
+        if stack > baseline["stackHighWater"]:
+            print("stack high-water mark %d -> %d bytes" % (baseline["stackHighWater"], stack))
+            ok = False
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Profile the node code under Avrora.")
+    parser.add_argument("image", help="main.exe of a micaz build of the node code")
+    parser.add_argument("--avrora", help="Avrora jar file")
+    parser.add_argument("--input", help="use this saved Avrora output instead of running it")
+    parser.add_argument("--save", help="save Avrora's output to this file")
+    parser.add_argument("--nodes", type=int, default=3, help="simulated motes (default 3)")
+    parser.add_argument("--seconds", type=float, default=60, help="simulated time (default 60)")
+    parser.add_argument("--path", action="append", default=[], metavar="REGEX",
+                        help="functions of the path to report (default: AntiTheftP "
+                        "receive/send and the CC2420 and AM layers below)")
+    parser.add_argument("--top", type=int, default=15, help="other functions to list")
+    parser.add_argument("-o", "--output", default="profile",
+                        help="write OUTPUT.json and OUTPUT.csv (default profile)")
+    parser.add_argument("--baseline", help="profile.json to compare with")
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="relative change in cycles per call accepted (default 0.05)")
+    args = parser.parse_args()
+    if not args.input and not args.avrora:
+        parser.error("give --avrora (or --input)")
+
+    funcs = functions(args.image)
+    if args.input:
+        with open(args.input) as f:
+            text = f.read()
+    else:
+        text = run_avrora(args.avrora, args.image, args.nodes, args.seconds)
+    if args.save:
+        with open(args.save, "w") as f:
+            f.write(text)
+
+    ranges, stack = parse_avrora(text)
+    if not ranges:
+        sys.exit("avrprofile: no profile in Avrora's output")
+    stats, _ = attribute(funcs, ranges)
+    total = sum(r[3] for r in ranges)
+    patterns = args.path or PATH
+    rows = write(args.output, stats, total, stack, patterns, args.seconds, args.nodes)
+    show(rows, total, stack, args.seconds, args.nodes, args.top)
+
+    if args.baseline and not compare(rows, stack, args.baseline, args.tolerance):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
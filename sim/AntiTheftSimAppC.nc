@@ -0,0 +1,146 @@
+/**
+ * Top-level configuration of the TOSSIM build of the AntiTheft demo app.
+ *
+ * TOSSIM runs one image on every mote, so this wires the unmodified node
+ * (AntiTheftC) and root (AntiTheftRootC) code together, and SimRoleP
+ * decides which of them a mote runs. The hardware-specific services are
+ * replaced by stand-ins: SimBatteryP for the battery sensor, SimLplP for
+ * low-power listening, SimConfigStorageP for the nodes' config volume
+ * and SimSerialC for the root's serial port. The node code always runs
+ * with energy accounting (EnergyMeterC).
+ */
+#include "antitheft.h"
+#include "antitheftsim.h"
+
+configuration AntiTheftSimAppC { }
+implementation
+{
+  components MainC, LedsC, ActiveMessageC, SimRoleP, SimLplP, SimBatteryP, SimSerialC,
+    SimConfigStorageP;
+
+  SimRoleP.Boot -> MainC.Boot;
+  SimRoleP.RadioControl -> ActiveMessageC;
+
+  /* The node code */
+  components new AntiTheftC(MSG_POOL_SIZE, PATH_DEPTH, DUP_CACHE_SIZE,
+			    AGGREGATION_WINDOW) as AntiTheft, EnergyMeterC;
+
+  AntiTheft.Boot -> SimRoleP.NodeBoot;
+  AntiTheft.Leds -> EnergyMeterC;
+  AntiTheft.RadioControl -> EnergyMeterC;
+  AntiTheft.LowPowerListening -> SimLplP;
+  AntiTheft.Mount -> SimConfigStorageP;
+  AntiTheft.ConfigStorage -> SimConfigStorageP;
+  AntiTheft.BatteryLevel -> EnergyMeterC;
+  EnergyMeterC.SubLeds -> LedsC;
+  EnergyMeterC.SubRadioControl -> SimRoleP.NodeRadioControl;
+  EnergyMeterC.SubBatteryLevel -> SimBatteryP;
+
+  /* The root code */
+  components AntiTheftRootC;
+
+  AntiTheftRootC.Boot -> SimRoleP.RootBoot;
+  AntiTheftRootC.SerialControl -> SimSerialC;
+  AntiTheftRootC.RadioControl -> SimRoleP.RootRadioControl;
+  AntiTheftRootC.LowPowerListening -> SimLplP;
+  AntiTheftRootC.Leds -> LedsC;
+
+  /* Settings dissemination: the root updates, the nodes listen */
+  components DisseminationC, new DisseminatorC(sampling_t, DIS_SAMPLING) as SamplingC,
+    new DisseminatorC(reporting_t, DIS_REPORTING) as ReportingC,
+    new PagedItemsC(blacklist_t, DIS_BLACKLIST) as BlacklistC,
+    new PagedItemsC(profiles_t, DIS_PROFILES) as ProfilesC;
+
+  AntiTheft.DisseminationControl -> DisseminationC;
+  AntiTheftRootC.DisseminationControl -> DisseminationC;
+  AntiTheftRootC.SamplingUpdate -> SamplingC;
+  AntiTheftRootC.ReportingUpdate -> ReportingC;
+  AntiTheftRootC.BlacklistUpdate -> BlacklistC.Update;
+  AntiTheftRootC.ProfilesUpdate -> ProfilesC.Update;
+  SimRoleP.SamplingValue -> SamplingC;
+  SimRoleP.ReportingValue -> ReportingC;
+  SimRoleP.BlacklistValue -> BlacklistC.Value;
+  SimRoleP.ProfilesValue -> ProfilesC.Value;
+  AntiTheft.SamplingValue -> SimRoleP.NodeSamplingValue;
+  AntiTheft.ReportingValue -> SimRoleP.NodeReportingValue;
+  AntiTheft.BlacklistValue -> SimRoleP.NodeBlacklistValue;
+  AntiTheft.ProfilesValue -> SimRoleP.NodeProfilesValue;
+  AntiTheftRootC.SettingsReceive -> SimSerialC.Receive[AM_SETTINGS];
+  AntiTheftRootC.ProfilesReceive -> SimSerialC.Receive[AM_PROFILES];
+
+  /* Urgent pushes: the root floods a blacklist page, nodes repeat it */
+  components new AMSenderC(AM_URGENT) as SendUrgent,
+    new AMSenderC(AM_URGENT) as RootSendUrgent,
+    new AMReceiverC(AM_URGENT) as ReceiveUrgent;
+
+  SimRoleP.UrgentReceive -> ReceiveUrgent;
+  AntiTheft.UrgentSend -> SendUrgent;
+  AntiTheft.UrgentReceive -> SimRoleP.NodeUrgentReceive;
+  AntiTheftRootC.UrgentSettingsReceive -> SimSerialC.Receive[AM_URGENT_SETTINGS];
+  AntiTheftRootC.UrgentSend -> RootSendUrgent;
+
+  /* Idle items, to measure dissemination against the number of items */
+#if SIM_EXTRA_ITEMS >= 4
+  components new SimExtraItemsC(DIS_SIM_EXTRA) as Extra0;
+#endif
+#if SIM_EXTRA_ITEMS >= 8
+  components new SimExtraItemsC(DIS_SIM_EXTRA + 4) as Extra1;
+#endif
+#if SIM_EXTRA_ITEMS >= 12
+  components new SimExtraItemsC(DIS_SIM_EXTRA + 8) as Extra2;
+#endif
+#if SIM_EXTRA_ITEMS >= 16
+  components new SimExtraItemsC(DIS_SIM_EXTRA + 12) as Extra3;
+#endif
+
+#ifdef ALERT_TRANSPORT_CTP
+  /* Alert collection, and alert forwarding to the PC at the root */
+  components CollectionC, new CollectionSenderC(COL_ALERTS) as AlertSender;
+
+  AntiTheft.CollectionControl -> CollectionC;
+  AntiTheft.AlertSend -> AlertSender;
+  AntiTheft.AlertIntercept -> CollectionC.Intercept[COL_ALERTS];
+  AntiTheftRootC.CollectionControl -> CollectionC;
+  AntiTheftRootC.RootControl -> CollectionC;
+  AntiTheftRootC.TheftReceive -> CollectionC.Receive[COL_ALERTS];
+#else
+  /* Alert flooding, and alert forwarding to the PC at the root */
+  components new AMSenderC(AM_THEFT) as SendTheft,
+    new AMReceiverC(AM_THEFT) as ReceiveTheft;
+
+  AntiTheft.TheftSend -> EnergyMeterC;
+  EnergyMeterC.SubTheftSend -> SendTheft;
+  SimRoleP.TheftReceive -> ReceiveTheft;
+  AntiTheft.TheftReceive -> EnergyMeterC;
+  EnergyMeterC.SubTheftReceive -> SimRoleP.NodeTheftReceive;
+  AntiTheftRootC.TheftReceive -> SimRoleP.RootTheftReceive;
+#endif
+  AntiTheftRootC.AlertsForward -> SimSerialC.AMSend[AM_ALERT];
+
+  components new PoolC(message_t, ROOT_QUEUE_SIZE) as AlertPool,
+    new QueueC(message_t *, ROOT_QUEUE_SIZE) as AlertQueue;
+
+  AntiTheftRootC.AlertPool -> AlertPool;
+  AntiTheftRootC.AlertQueue -> AlertQueue;
+
+  /* Source-routed commands from the PC, and their acknowledgements */
+  components new AMSenderC(AM_COMMAND) as SendCommand,
+    new AMSenderC(AM_COMMAND) as RootSendCommand,
+    new AMReceiverC(AM_COMMAND) as ReceiveCommand;
+
+  SimRoleP.CommandReceive -> ReceiveCommand;
+  AntiTheft.CommandSend -> SendCommand;
+  AntiTheft.CommandReceive -> SimRoleP.NodeCommandReceive;
+  AntiTheft.CommandAcks -> ActiveMessageC;
+  AntiTheftRootC.CommandReceive -> SimSerialC.Receive[AM_COMMAND];
+  AntiTheftRootC.CommandSend -> RootSendCommand;
+  AntiTheftRootC.CommandAcks -> ActiveMessageC;
+  AntiTheftRootC.CommandAckReceive -> SimRoleP.RootCommandReceive;
+  AntiTheftRootC.CommandForward -> SimSerialC.AMSend[AM_COMMAND];
+
+  components new TimerMilliC() as StatusTimer, LocalTimeMilliC;
+
+  AntiTheftRootC.StatusSend -> SimSerialC.AMSend[AM_ROOT_STATUS];
+  AntiTheftRootC.StatusTimer -> StatusTimer;
+  AntiTheftRootC.LocalTime -> LocalTimeMilliC;
+}
@@ -0,0 +1,26 @@
+/**
+ * Stand-in for the battery voltage sensor (DemoSensorC) under TOSSIM.
+ * Readings start at SIM_BATTERY_FULL, slightly lower on some motes, and
+ * drop by one every SIM_BATTERY_DRAIN_READS readings.
+ */
+#include "antitheftsim.h"
+
+module SimBatteryP
+{
+  provides interface Read<uint16_t>;
+}
+implementation
+{
+  uint32_t reads;
+
+  task void readDone() {
+    uint16_t val = SIM_BATTERY_FULL - TOS_NODE_ID % 8 - reads / SIM_BATTERY_DRAIN_READS;
+
+    reads++;
+    signal Read.readDone(SUCCESS, val);
+  }
+
+  command error_t Read.read() {
+    return post readDone() == SUCCESS ? SUCCESS : EBUSY;
+  }
+}
@@ -0,0 +1,81 @@
+/**
+ * Stand-in for the node code's config volume (ConfigStorageC) under
+ * TOSSIM, which simulates no flash. The volume is kept in each mote's
+ * memory: it mounts at once, and a write becomes valid on commit.
+ */
+#include <string.h>
+#include "antitheftsim.h"
+
+module SimConfigStorageP
+{
+  provides {
+    interface Mount;
+    interface ConfigStorage;
+  }
+}
+implementation
+{
+  uint8_t volume[SIM_CONFIG_VOLUME_SIZE], pending[SIM_CONFIG_VOLUME_SIZE];
+  bool committed;
+  storage_addr_t opAddr;
+  void *opBuf;
+  storage_len_t opLen;
+
+  task void mountDone() {
+    signal Mount.mountDone(SUCCESS);
+  }
+
+  task void readDone() {
+    memcpy(opBuf, volume + opAddr, opLen);
+    signal ConfigStorage.readDone(opAddr, opBuf, opLen, SUCCESS);
+  }
+
+  task void writeDone() {
+    memcpy(pending + opAddr, opBuf, opLen);
+    signal ConfigStorage.writeDone(opAddr, opBuf, opLen, SUCCESS);
+  }
+
+  task void commitDone() {
+    memcpy(volume, pending, sizeof volume);
+    committed = TRUE;
+    signal ConfigStorage.commitDone(SUCCESS);
+  }
+
+  error_t start(storage_addr_t addr, void *buf, storage_len_t len) {
+    if (addr + len > SIM_CONFIG_VOLUME_SIZE)
+      return EINVAL;
+    opAddr = addr;
+    opBuf = buf;
+    opLen = len;
+    return SUCCESS;
+  }
+
+  command error_t Mount.mount() {
+    memcpy(pending, volume, sizeof volume);
+    return post mountDone();
+  }
+
+  command error_t ConfigStorage.read(storage_addr_t addr, void *buf, storage_len_t len) {
+    error_t ok = start(addr, buf, len);
+
+    return ok == SUCCESS ? post readDone() : ok;
+  }
+
+  command error_t ConfigStorage.write(storage_addr_t addr, void *buf, storage_len_t len) {
+    error_t ok = start(addr, buf, len);
+
+    return ok == SUCCESS ? post writeDone() : ok;
+  }
+
+  command error_t ConfigStorage.commit() {
+    return post commitDone();
+  }
+
+  command storage_len_t ConfigStorage.getSize() {
+    return SIM_CONFIG_VOLUME_SIZE;
+  }
+
+  command bool ConfigStorage.valid() {
+    return committed;
+  }
+}
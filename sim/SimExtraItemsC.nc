@@ -0,0 +1,14 @@
+/**
+ * Four idle dissemination items, keys KEY to KEY + 3, that nothing reads
+ * or updates. They only add to the items the dissemination service keeps
+ * consistent, so that its cost can be measured against the number of
+ * items (see SIM_EXTRA_ITEMS).
+ */
+generic configuration SimExtraItemsC(uint16_t KEY) { }
+implementation
+{
+  components new DisseminatorC(uint16_t, KEY) as Item0,
+    new DisseminatorC(uint16_t, KEY + 1) as Item1,
+    new DisseminatorC(uint16_t, KEY + 2) as Item2,
+    new DisseminatorC(uint16_t, KEY + 3) as Item3;
+}
@@ -0,0 +1,26 @@
+/**
+ * TOSSIM's radio always listens, so low-power listening settings are
+ * accepted and ignored.
+ */
+module SimLplP
+{
+  provides interface LowPowerListening;
+}
+implementation
+{
+  uint16_t localWakeup;
+
+  command void LowPowerListening.setLocalWakeupInterval(uint16_t intervalMs) {
+    localWakeup = intervalMs;
+  }
+
+  command uint16_t LowPowerListening.getLocalWakeupInterval() {
+    return localWakeup;
+  }
+
+  command void LowPowerListening.setRemoteWakeupInterval(message_t *msg, uint16_t intervalMs) { }
+
+  command uint16_t LowPowerListening.getRemoteWakeupInterval(message_t *msg) {
+    return 0;
+  }
+}
@@ -0,0 +1,148 @@
+/**
+ * TOSSIM runs the same image on every mote, so the simulation links the
+ * node and the root code together. SimRoleP boots the root code on
+ * SIM_ROOT_ID and the node code everywhere else, and only passes the
+ * events of the services both use (radio control, alert, command and
+ * urgent settings reception and settings changes) to the code of the mote's role.
+ */
+#include "antitheftsim.h"
+
+module SimRoleP
+{
+  provides {
+    interface Boot as NodeBoot;
+    interface Boot as RootBoot;
+    interface SplitControl as NodeRadioControl;
+    interface SplitControl as RootRadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface Receive as NodeTheftReceive;
+    interface Receive as RootTheftReceive;
+#endif
+    interface Receive as NodeCommandReceive;
+    interface Receive as RootCommandReceive;
+    interface Receive as NodeUrgentReceive;
+    interface DisseminationValue<sampling_t> as NodeSamplingValue;
+    interface DisseminationValue<reporting_t> as NodeReportingValue;
+    interface DisseminationValue<blacklist_t> as NodeBlacklistValue[uint8_t page];
+    interface DisseminationValue<profiles_t> as NodeProfilesValue[uint8_t page];
+  }
+  uses {
+    interface Boot;
+    interface SplitControl as RadioControl;
+#ifndef ALERT_TRANSPORT_CTP
+    interface Receive as TheftReceive;
+#endif
+    interface Receive as CommandReceive;
+    interface Receive as UrgentReceive;
+    interface DisseminationValue<sampling_t> as SamplingValue;
+    interface DisseminationValue<reporting_t> as ReportingValue;
+    interface DisseminationValue<blacklist_t> as BlacklistValue[uint8_t page];
+    interface DisseminationValue<profiles_t> as ProfilesValue[uint8_t page];
+  }
+}
+implementation
+{
+  bool isRoot() {
+    return TOS_NODE_ID == SIM_ROOT_ID;
+  }
+
+  event void Boot.booted() {
+    if (isRoot())
+      signal RootBoot.booted();
+    else
+      signal NodeBoot.booted();
+  }
+
+  command error_t NodeRadioControl.start() { return call RadioControl.start(); }
+  command error_t NodeRadioControl.stop() { return call RadioControl.stop(); }
+  command error_t RootRadioControl.start() { return call RadioControl.start(); }
+  command error_t RootRadioControl.stop() { return call RadioControl.stop(); }
+
+  event void RadioControl.startDone(error_t error) {
+    if (isRoot())
+      signal RootRadioControl.startDone(error);
+    else
+      signal NodeRadioControl.startDone(error);
+  }
+
+  event void RadioControl.stopDone(error_t error) {
+    if (isRoot())
+      signal RootRadioControl.stopDone(error);
+    else
+      signal NodeRadioControl.stopDone(error);
+  }
+
+#ifndef ALERT_TRANSPORT_CTP
+  /* Flooded alerts reach every mote; collected ones only the root */
+  event message_t *TheftReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    if (isRoot())
+      return signal RootTheftReceive.receive(msg, payload, len);
+    else
+      return signal NodeTheftReceive.receive(msg, payload, len);
+  }
+#endif
+
+  /* Commands on their way out, and acknowledgements for the root */
+  event message_t *CommandReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    if (isRoot())
+      return signal RootCommandReceive.receive(msg, payload, len);
+    else
+      return signal NodeCommandReceive.receive(msg, payload, len);
+  }
+
+  /* The root sent the urgent flood; its repeats are not for it */
+  event message_t *UrgentReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    if (isRoot())
+      return msg;
+    else
+      return signal NodeUrgentReceive.receive(msg, payload, len);
+  }
+
+  /* The root changes the settings, which also signals changed() locally */
+  command const sampling_t *NodeSamplingValue.get() { return call SamplingValue.get(); }
+  command void NodeSamplingValue.set(const sampling_t *v) { call SamplingValue.set(v); }
+
+  event void SamplingValue.changed() {
+    if (!isRoot())
+      signal NodeSamplingValue.changed();
+  }
+
+  command const reporting_t *NodeReportingValue.get() { return call ReportingValue.get(); }
+  command void NodeReportingValue.set(const reporting_t *v) { call ReportingValue.set(v); }
+
+  event void ReportingValue.changed() {
+    if (!isRoot())
+      signal NodeReportingValue.changed();
+  }
+
+  command const blacklist_t *NodeBlacklistValue.get[uint8_t page]() {
+    return call BlacklistValue.get[page]();
+  }
+  command void NodeBlacklistValue.set[uint8_t page](const blacklist_t *v) {
+    call BlacklistValue.set[page](v);
+  }
+
+  event void BlacklistValue.changed[uint8_t page]() {
+    if (!isRoot())
+      signal NodeBlacklistValue.changed[page]();
+  }
+
+  command const profiles_t *NodeProfilesValue.get[uint8_t page]() {
+    return call ProfilesValue.get[page]();
+  }
+  command void NodeProfilesValue.set[uint8_t page](const profiles_t *v) {
+    call ProfilesValue.set[page](v);
+  }
+
+  event void ProfilesValue.changed[uint8_t page]() {
+    if (!isRoot())
+      signal NodeProfilesValue.changed[page]();
+  }
+
+  default command const blacklist_t *BlacklistValue.get[uint8_t page]() { return NULL; }
+  default command void BlacklistValue.set[uint8_t page](const blacklist_t *v) { }
+  default event void NodeBlacklistValue.changed[uint8_t page]() { }
+  default command const profiles_t *ProfilesValue.get[uint8_t page]() { return NULL; }
+  default command void ProfilesValue.set[uint8_t page](const profiles_t *v) { }
+  default event void NodeProfilesValue.changed[uint8_t page]() { }
+}
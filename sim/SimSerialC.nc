@@ -0,0 +1,30 @@
+/**
+ * Simulated serial port of the root (see SimSerialP).
+ */
+#include "antitheft.h"
+
+configuration SimSerialC
+{
+  provides {
+    interface SplitControl;
+    interface AMSend[am_id_t id];
+    interface Receive[am_id_t id];
+  }
+}
+implementation
+{
+  components SimSerialP, ActiveMessageC, new AMReceiverC(AM_SETTINGS) as Inject,
+    new AMReceiverC(AM_COMMAND) as InjectCommand,
+    new AMReceiverC(AM_URGENT_SETTINGS) as InjectUrgent,
+    new AMReceiverC(AM_PROFILES) as InjectProfiles;
+
+  SplitControl = SimSerialP;
+  AMSend = SimSerialP;
+  Receive = SimSerialP;
+
+  SimSerialP.Packet -> ActiveMessageC;
+  SimSerialP.InjectReceive -> Inject;
+  SimSerialP.InjectCommandReceive -> InjectCommand;
+  SimSerialP.InjectUrgentReceive -> InjectUrgent;
+  SimSerialP.InjectProfilesReceive -> InjectProfiles;
+}
@@ -0,0 +1,139 @@
+/**
+ * Stand-in for the root's serial port under TOSSIM.
+ *
+ * Messages sent to the PC are printed on the "Serial" debug channel as
+ *   serial <sim time> <AM type> <payload in hex>
+ * which sim/run.py decodes. Messages from the PC (settings, urgent
+ * settings, profiles and commands) are injected by the driver as radio packets
+ * delivered to the root, and handed to the root code as if they had
+ * arrived on the serial port.
+ * Command acknowledgements share the command AM type but come from the
+ * radio, so only unacknowledged commands are taken as injected.
+ */
+#include <stdio.h>
+#include "antitheft.h"
+#include "antitheftsim.h"
+
+module SimSerialP
+{
+  provides {
+    interface SplitControl;
+    interface AMSend[am_id_t id];
+    interface Receive[am_id_t id];
+  }
+  uses {
+    interface Packet;
+    interface Receive as InjectReceive;
+    interface Receive as InjectCommandReceive;
+    interface Receive as InjectUrgentReceive;
+    interface Receive as InjectProfilesReceive;
+  }
+}
+implementation
+{
+  message_t *pendingMsg[SIM_SERIAL_PENDING];
+  am_id_t pendingId[SIM_SERIAL_PENDING];
+  uint8_t pendingCount;
+
+  task void startDone() {
+    signal SplitControl.startDone(SUCCESS);
+  }
+
+  task void stopDone() {
+    signal SplitControl.stopDone(SUCCESS);
+  }
+
+  command error_t SplitControl.start() {
+    post startDone();
+    return SUCCESS;
+  }
+
+  command error_t SplitControl.stop() {
+    post stopDone();
+    return SUCCESS;
+  }
+
+  /* Complete the oldest send */
+  task void sendDone() {
+    message_t *msg = pendingMsg[0];
+    am_id_t id = pendingId[0];
+    uint8_t i;
+
+    pendingCount--;
+    for (i = 0; i < pendingCount; i++)
+      {
+	pendingMsg[i] = pendingMsg[i + 1];
+	pendingId[i] = pendingId[i + 1];
+      }
+    if (pendingCount)
+      post sendDone();
+
+    signal AMSend.sendDone[id](msg, SUCCESS);
+  }
+
+  command error_t AMSend.send[am_id_t id](am_addr_t addr, message_t *msg, uint8_t len) {
+    uint8_t *payload = call Packet.getPayload(msg, len);
+    char hex[2 * TOSH_DATA_LENGTH + 1];
+    uint8_t i;
+
+    if (payload == NULL)
+      return ESIZE;
+    if (pendingCount == SIM_SERIAL_PENDING)
+      return EBUSY;
+
+    for (i = 0; i < len; i++)
+      sprintf(hex + 2 * i, "%02x", payload[i]);
+    hex[2 * len] = '\0';
+    dbg("Serial", "serial %llu %hhu %s\n", sim_time(), id, hex);
+
+    call Packet.setPayloadLength(msg, len);
+    pendingMsg[pendingCount] = msg;
+    pendingId[pendingCount] = id;
+    if (!pendingCount++)
+      post sendDone();
+
+    return SUCCESS;
+  }
+
+  command error_t AMSend.cancel[am_id_t id](message_t *msg) {
+    return FAIL;
+  }
+
+  command uint8_t AMSend.maxPayloadLength[am_id_t id]() {
+    return call Packet.maxPayloadLength();
+  }
+
+  command void *AMSend.getPayload[am_id_t id](message_t *msg, uint8_t len) {
+    return call Packet.getPayload(msg, len);
+  }
+
+  event message_t *InjectReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    dbg("Serial", "inject %llu %hhu\n", sim_time(), AM_SETTINGS);
+    return signal Receive.receive[AM_SETTINGS](msg, payload, len);
+  }
+
+  event message_t *InjectUrgentReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    dbg("Serial", "inject %llu %hhu\n", sim_time(), AM_URGENT_SETTINGS);
+    return signal Receive.receive[AM_URGENT_SETTINGS](msg, payload, len);
+  }
+
+  event message_t *InjectProfilesReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    dbg("Serial", "inject %llu %hhu\n", sim_time(), AM_PROFILES);
+    return signal Receive.receive[AM_PROFILES](msg, payload, len);
+  }
+
+  event message_t *InjectCommandReceive.receive(message_t *msg, void *payload, uint8_t len) {
+    command_t *cmd = payload;
+
+    if (len != sizeof(*cmd) || cmd->ack)
+      return msg;
+    dbg("Serial", "inject %llu %hhu\n", sim_time(), AM_COMMAND);
+    return signal Receive.receive[AM_COMMAND](msg, payload, len);
+  }
+
+  default event void AMSend.sendDone[am_id_t id](message_t *msg, error_t error) { }
+
+  default event message_t *Receive.receive[am_id_t id](message_t *msg, void *payload, uint8_t len) {
+    return msg;
+  }
+}
@@ -0,0 +1,36 @@
+/**
+ * Settings of the TOSSIM build of the AntiTheft application.
+ */
+#ifndef ANTITHEFTSIM_H
+#define ANTITHEFTSIM_H
+
+/* Idle dissemination items added to the settings' (0, 4, 8, 12 or 16),
+   to measure how the dissemination backend scales with the number of
+   items: SIM_DEFINES="-DSIM_EXTRA_ITEMS=16" */
+#ifndef SIM_EXTRA_ITEMS
+#define SIM_EXTRA_ITEMS 0
+#endif
+
+enum {
+  /* The simulated mote that runs the root code; all others run the node
+     code */
+  SIM_ROOT_ID = 0,
+
+  /* Simulated battery: initial reading, and readings per unit of drain */
+  SIM_BATTERY_FULL = 400,
+  SIM_BATTERY_DRAIN_READS = 64,
+
+  /* Serial sends the simulated serial port can have in flight */
+  SIM_SERIAL_PENDING = 4,
+
+  /* Bytes of the simulated config volume (SimConfigStorageP) */
+  SIM_CONFIG_VOLUME_SIZE = 16,
+
+  /* Interval at which nodes print their energy counters (EnergyMeterP) */
+  SIM_ENERGY_REPORT_INTERVAL = 5000,
+
+  /* Dissemination key of the first of the SIM_EXTRA_ITEMS */
+  DIS_SIM_EXTRA = 100
+};
+
+#endif
@@ -0,0 +1,190 @@
+#!/usr/bin/env python
+"""Benchmark how alert delivery scales with the size of the network.
+
+    $ (cd sim; make micaz sim)
+    $ sim/bench.py -o results                    # the whole suite
+    $ sim/bench.py --sizes 10,100 --shapes grid -o quick
+    $ sim/bench.py -o results --baseline old/results.json
+
+runs the simulation of run.py on grid, random and line topologies of
+each size, once per seed, and writes one row per run to results.json and
+results.csv: delivery ratio, latency percentiles, transmissions per
+delivered alert and duplicates, plus what was simulated and how long it
+took. Every run happens in its own process (TOSSIM keeps one simulation
+per process), with the same seeds every time, so the files of two
+versions of the code can be compared directly; --baseline does so and
+exits with status 1 if delivery or latency got worse.
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+
+import run
+import topology
+
+SHAPES = ("grid", "random", "line")
+SIZES = (10, 30, 100, 300, 1000)
+
+COLUMNS = ("shape", "size", "topology", "nodes", "seed", "seconds", "checkInterval",
+           "originated", "delivered", "deliveryRatio", "latencyP50Ms", "latencyP90Ms",
+           "latencyP99Ms", "latencyMaxMs", "transmissions", "transmissionsPerDelivered",
+           "duplicates", "busyDrops", "stuckSends", "rootDropped", "joulesPerDelivered",
+           "meanPowerMw", "lifetimeDaysMin", "wallSeconds")
+
+
+def spec(shape, size):
+    """A topology spec of size motes. Grids are as square as possible,
+    rounding size up if it has no divisor close to its square root."""
+    if shape == "grid":
+        width = int(math.sqrt(size))
+        for w in range(width, width // 2, -1):
+            if size % w == 0:
+                return "grid:%dx%d" % (w, size // w)
+        return "grid:%dx%d" % (width, (size + width - 1) // width)
+    return "%s:%d" % (shape, size)
+
+
+def run_isolated(options, topo, seed, reach=1.5):
+    """One run of run.py with the given options in a fresh process; its
+    metrics, flattened into a row"""
+    fd, path = tempfile.mkstemp(prefix="antitheft-bench-", suffix=".json")
+    os.close(fd)
+    command = ([sys.executable, os.path.join(HERE, "run.py")] + options +
+               ["--reach", str(reach), "--seed", str(seed), "--json", path, topo])
+    start = time.time()
+    try:
+        status = subprocess.call(command)
+        if status != 0:
+            raise RuntimeError("%s failed with status %d" % (" ".join(command), status))
+        with open(path) as f:
+            metrics = json.load(f)
+    finally:
+        os.unlink(path)
+
+    latency = metrics.pop("latencyMs")
+    metrics.update(metrics.pop("energy", {}))
+    metrics.update(latencyP50Ms=latency["p50"], latencyP90Ms=latency["p90"],
+                   latencyP99Ms=latency["p99"], wallSeconds=round(time.time() - start, 2),
+                   seed=seed, nodes=len(topology.parse(topo, reach, seed)[0]))
+    return metrics
+
+
+def simulate(topo, seed, args):
+    options = ["--time", str(args.time), "--check-interval", str(args.check_interval)]
+    if args.noise:
+        options += ["--noise", args.noise]
+    return run_isolated(options, topo, seed, args.reach)
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(["git", "-C", HERE, "describe", "--always", "--dirty"],
+                                       universal_newlines=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def write(prefix, rows, args):
+    with open(prefix + ".json", "w") as f:
+        json.dump({"revision": git_revision(),
+                   "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+                   "seconds": args.time, "checkInterval": args.check_interval,
+                   "reach": args.reach, "runs": rows}, f, indent=2, sort_keys=True)
+        f.write("\n")
+    with open(prefix + ".csv", "w") as f:
+        out = csv.DictWriter(f, COLUMNS, extrasaction="ignore", lineterminator="\n")
+        out.writeheader()
+        out.writerows(rows)
+
+
+def mean(rows, key):
+    values = [r[key] for r in rows if r.get(key) is not None]
+    return sum(values) / float(len(values)) if values else None
+
+
+def compare(rows, path, tolerance):
+    """Print how each topology changed against a baseline results.json;
+    true if none got worse by more than tolerance (relative)"""
+    with open(path) as f:
+        baseline = json.load(f)["runs"]
+    ok = True
+    print("%-14s %21s %25s %21s" % ("topology", "delivery", "p90 latency (ms)", "tx/delivered"))
+    for topo in sorted(set(r["topology"] for r in rows)):
+        new = [r for r in rows if r["topology"] == topo]
+        old = [r for r in baseline if r["topology"] == topo]
+        if not old:
+            continue
+        values = [(mean(old, k), mean(new, k))
+                  for k in ("deliveryRatio", "latencyP90Ms", "transmissionsPerDelivered")]
+        worse = []
+        (d0, d1), (l0, l1), (t0, t1) = values
+        if d0 is not None and (d1 is None or d1 < d0 * (1 - tolerance)):
+            worse.append("delivery")
+        if l0 is not None and l1 is not None and l1 > l0 * (1 + tolerance):
+            worse.append("latency")
+        ok = ok and not worse
+        print("%-14s %10s -> %-8s %12s -> %-10s %10s -> %-8s %s" % (
+            (topo,) + tuple(fmt(v) for pair in values for v in pair) +
+            ("WORSE: " + ", ".join(worse) if worse else "",)))
+    return ok
+
+
+def fmt(value):
+    return "-" if value is None else "%.3f" % value if value < 10 else "%.0f" % value
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark alert delivery against network size.")
+    parser.add_argument("-o", "--output", default="bench",
+                        help="write OUTPUT.json and OUTPUT.csv (default bench)")
+    parser.add_argument("--shapes", default=",".join(SHAPES), help="grid, random and/or line")
+    parser.add_argument("--sizes", default=",".join(map(str, SIZES)), help="mote counts")
+    parser.add_argument("--seeds", type=int, default=3, help="runs per topology")
+    parser.add_argument("--time", type=float, default=120, help="simulated seconds per run")
+    parser.add_argument("--check-interval", type=int, default=run.C["DEFAULT_CHECK_INTERVAL"])
+    parser.add_argument("--reach", type=float, default=1.5)
+    parser.add_argument("--noise", help="TOSSIM noise trace (default meyer-heavy)")
+    parser.add_argument("--baseline", help="results.json of an earlier run to compare with")
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="relative change --baseline accepts (default 0.05)")
+    args = parser.parse_args()
+
+    shapes = args.shapes.split(",")
+    for shape in shapes:
+        if shape not in SHAPES:
+            parser.error("unknown shape " + shape)
+    sizes = [int(s) for s in args.sizes.split(",")]
+
+    rows = []
+    for shape in shapes:
+        for size in sizes:
+            topo = spec(shape, size)
+            for seed in range(1, args.seeds + 1):
+                row = simulate(topo, seed, args)
+                row.update(shape=shape, size=size)
+                rows.append(row)
+                print("%-14s seed %d: delivery %s, p90 %s ms, %s tx/alert (%.0f s)" % (
+                    topo, seed, fmt(row["deliveryRatio"]), fmt(row["latencyP90Ms"]),
+                    fmt(row["transmissionsPerDelivered"]), row["wallSeconds"]))
+                sys.stdout.flush()
+            # Write as we go: the large topologies take a while
+            write(args.output, rows, args)
+
+    if args.baseline and not compare(rows, args.baseline, args.tolerance):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
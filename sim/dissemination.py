@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+"""Compare the settings dissemination backends, Drip and DIP, in simulation.
+
+    $ sim/dissemination.py -o dissemination grid:10x10
+    $ sim/dissemination.py --items 0,8,16 --seeds 3 grid:10x10 random:50
+
+builds the simulation once per backend (DISSEMINATION=drip or dip) and
+number of idle extra items (SIM_EXTRA_ITEMS), and runs every build on
+every topology and seed. After the initial settings push, --pushes more
+pushes each blacklist a node that is not in the network: every node
+gets a new blacklist table, and nobody turns its radio off. Each run
+reports how long its pushes took from the root to the last node (mean
+and worst), the pushes that never reached every node, and the packets
+the dissemination service sent per node and minute. The rows go to
+OUTPUT.json and OUTPUT.csv, and every topology and item count is
+printed with Drip and DIP side by side.
+"""
+
+from __future__ import print_function
+
+import argparse
+import multiprocessing
+import os
+import sys
+import time
+from multiprocessing.pool import ThreadPool
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+
+import bench
+import sweep
+
+BACKENDS = ("drip", "dip")
+ABSENT_NODE = 65000  # blacklisted by the pushes; no simulated mote has this id
+
+COLUMNS = ("backend", "items", "topology", "nodes", "seed", "seconds", "pushes",
+           "pushesMissed", "pushLatencyMeanMs", "pushLatencyMaxMs", "disseminationSends",
+           "sendsPerNodeMinute", "deliveryRatio", "wallSeconds", "error")
+
+
+def build_dir(base, backend, items):
+    return os.path.join(base, "%s-%d" % (backend, items))
+
+
+def simulate(job, args):
+    backend, items, topo, seed = job
+    options = ["--build", build_dir(args.build_dir, backend, items), "--time", str(args.time)]
+    for i in range(args.pushes):
+        options += ["--blacklist", "%g:%d:1000" % (args.first + i * args.interval, ABSENT_NODE)]
+    row = {"backend": backend, "items": items, "topology": topo, "seed": seed}
+    try:
+        metrics = bench.run_isolated(options, topo, seed, args.reach)
+    except (RuntimeError, OSError, ValueError) as e:
+        row["error"] = str(e)
+        return row
+
+    # The initial push is version 1, the blacklists 2 and up
+    nodes = metrics["nodes"] - 1
+    latencies = [ms for v, ms in metrics["settingsLatencyMs"].items() if int(v) > 1]
+    reached = [v for v, n in metrics["settingsNodes"].items() if int(v) > 1 and n == nodes]
+    row.update(nodes=metrics["nodes"], seconds=args.time, pushes=args.pushes,
+               pushesMissed=args.pushes - len(reached),
+               pushLatencyMeanMs=sum(latencies) / len(latencies) if latencies else None,
+               pushLatencyMaxMs=max(latencies) if latencies else None,
+               disseminationSends=metrics["disseminationSends"],
+               sendsPerNodeMinute=metrics["disseminationSends"] * 60.0 /
+               metrics["nodes"] / args.time,
+               deliveryRatio=metrics["deliveryRatio"], wallSeconds=metrics["wallSeconds"])
+    return row
+
+
+def compare(rows):
+    """Drip and DIP side by side, averaged over the seeds"""
+    print("Drip -> DIP")
+    print("%-14s %5s %23s %23s %21s" % ("topology", "items", "push latency (ms)",
+                                         "worst latency (ms)", "sends/node/min"))
+    for topo in sorted(set(r["topology"] for r in rows)):
+        for items in sorted(set(r["items"] for r in rows)):
+            values = []
+            for key in ("pushLatencyMeanMs", "pushLatencyMaxMs", "sendsPerNodeMinute"):
+                for backend in BACKENDS:
+                    values.append(bench.mean([r for r in rows if r["topology"] == topo and
+                                              r["items"] == items and r["backend"] == backend],
+                                             key))
+            print("%-14s %5d %10s -> %-10s %10s -> %-10s %9s -> %-9s" % (
+                (topo, items) + tuple(bench.fmt(v) for v in values)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare Drip and DIP settings dissemination.")
+    parser.add_argument("topologies", nargs="*", default=["grid:10x10"])
+    parser.add_argument("--items", default="0,16",
+                        help="idle extra dissemination items (0, 4, 8, 12 or 16; default 0,16)")
+    parser.add_argument("--seeds", type=int, default=3, help="runs per topology")
+    parser.add_argument("--time", type=float, default=300, help="simulated seconds per run")
+    parser.add_argument("--pushes", type=int, default=5, help="settings pushes to time")
+    parser.add_argument("--first", type=float, default=30, help="time of the first push (s)")
+    parser.add_argument("--interval", type=float, default=45, help="time between pushes (s)")
+    parser.add_argument("--reach", type=float, default=1.5)
+    parser.add_argument("-j", "--jobs", type=int, default=multiprocessing.cpu_count(),
+                        help="simulations run at once (default: one per core)")
+    parser.add_argument("-o", "--output", default="dissemination",
+                        help="write OUTPUT.json and OUTPUT.csv (default dissemination)")
+    parser.add_argument("--build-dir", default=os.path.join(HERE, "dissembuild"),
+                        help="where the builds go (default sim/dissembuild)")
+    args = parser.parse_args()
+
+    items = [int(n) for n in args.items.split(",")]
+    for n in items:
+        if n not in (0, 4, 8, 12, 16):
+            parser.error("--items must be 0, 4, 8, 12 or 16, not %d" % n)
+    if args.first + (args.pushes - 1) * args.interval >= args.time:
+        parser.error("the last push is after the end of the run")
+
+    start = time.time()
+    pool = ThreadPool(max(1, args.jobs))
+    builds = [(backend, n) for backend in BACKENDS for n in items]
+    pool.map(lambda b: sweep.build(build_dir(args.build_dir, *b), {"SIM_EXTRA_ITEMS": b[1]},
+                                   {"DISSEMINATION": b[0]}), builds, chunksize=1)
+    jobs = [(backend, n, topo, seed) for topo in args.topologies for n in items
+            for seed in range(1, args.seeds + 1) for backend in BACKENDS]
+    print("%d builds in %.0f s; %d runs on %d workers" % (len(builds), time.time() - start,
+                                                          len(jobs), args.jobs))
+
+    rows = []
+    for row in pool.imap_unordered(lambda job: simulate(job, args), jobs, chunksize=1):
+        rows.append(row)
+        print("%d/%d %s %d items %s seed %d: %s" % (
+            len(rows), len(jobs), row["backend"], row["items"], row["topology"], row["seed"],
+            row.get("error") or "push latency %s ms, %s sends/node/min" % (
+                bench.fmt(row["pushLatencyMeanMs"]), bench.fmt(row["sendsPerNodeMinute"]))))
+        sys.stdout.flush()
+        sweep.write(args.output, rows, COLUMNS)
+    pool.close()
+    compare([r for r in rows if "error" not in r])
+
+
+if __name__ == "__main__":
+    main()
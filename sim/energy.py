@@ -0,0 +1,187 @@
+#!/usr/bin/env python
+"""Energy model of a micaz node running the AntiTheft node code.
+
+EnergyMeterP counts how long each node's radio was on, the alerts it
+sent and received, its battery readings and how long its leds were on.
+This module turns those counts into joules and average power with the
+micaz datasheet currents below, and projects battery lifetime.
+
+The radio dominates. Without low-power listening (the stock build; the
+LPL calls in AntiTheftC have no effect unless LOW_POWER_LISTENING is
+defined) it listens whenever it is on, and the CC2420 draws about as much
+sending as listening, so the CTP and Drip beacons that EnergyMeterP does
+not see add little on top of the listen time. lpl > 0 projects the same
+counts onto a build with that wakeup interval: the radio listens for
+lplCheckMs per wakeup, a broadcast is repeated for a whole interval,
+and a reception keeps the radio on for lplHoldMs. The microcontroller
+is charged a fixed active time per event (mcu*Ms; prof/avrprofile.py
+measures the cycles these take) and sleeps otherwise.
+
+    $ sim/run.py --log run.log grid:5x5
+    $ sim/energy.py --lpl 512 run.log              # from a simulation
+    $ sim/energy.py --reports reports.csv          # from motes' reports
+
+reports.csv has the fields of energy_report_t as columns, as received
+from nodes built with ENERGY_ACCOUNTING=1.
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import re
+
+MODEL = {
+    "volts": 3.0,
+    "batteryMah": 2500.0,  # two AA cells in series
+    "mcuActiveMa": 8.0,  # ATmega128L at 7.37 MHz
+    "mcuSleepMa": 0.015,  # power-save mode
+    "radioRxMa": 19.7,  # CC2420 receiving or listening
+    "radioTxMa": 17.4,  # CC2420 sending at 0 dBm
+    "radioOffMa": 0.02,  # CC2420 powered down
+    "ledMa": 4.0,  # per led
+    "adcMa": 0.3,  # during a conversion, on top of the MCU
+    "adcMs": 0.3,  # one battery reading
+    "frameBytes": 22 + 19,  # alert_t plus preamble, header and CRC
+    "radioKbps": 250.0,
+    "mcuTxMs": 1.5,  # loading and sending one alert
+    "mcuRxMs": 1.0,  # receiving and handling one alert
+    "mcuCheckMs": 0.1,  # one check interval timer event
+    "lplCheckMs": 5.0,  # channel check per LPL wakeup
+    "lplHoldMs": 100.0,  # radio left on after an LPL reception
+}
+
+COUNTS = ("elapsed", "radioOn", "txPackets", "rxPackets", "adcReads", "ledOn")
+
+LINE = re.compile(r"DEBUG \((\d+)\): energy (.*)")
+
+
+def parse_log(path):
+    """The last energy counts of each node in a simulation's debug log"""
+    counts = {}
+    with open(path) as f:
+        for line in f:
+            m = LINE.match(line)
+            if m:
+                values = [int(v) for v in m.group(2).split()[1:]]
+                counts[int(m.group(1))] = dict(zip(COUNTS, values))
+    return counts
+
+
+def read_reports(path):
+    """The last energy_report_t of each node in a CSV file"""
+    counts = {}
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            report = dict((k, int(row[k])) for k in COUNTS)
+            node = int(row["nodeId"])
+            if node not in counts or report["elapsed"] >= counts[node]["elapsed"]:
+                counts[node] = report
+    return counts
+
+
+def node_energy(c, check_interval, lpl=0, model=MODEL):
+    """Joules spent by a node over c["elapsed"] ms, per component, and its
+    average power (mW)"""
+    m = model
+    frame_ms = m["frameBytes"] * 8 / m["radioKbps"]
+    elapsed, on = float(c["elapsed"]), float(c["radioOn"])
+    mj = m["volts"] / 1000.0  # mA * ms -> mJ
+
+    if lpl > 0:
+        tx = c["txPackets"] * (lpl + frame_ms)
+        rx = c["rxPackets"] * (frame_ms + m["lplHoldMs"])
+        listen = on * m["lplCheckMs"] / lpl
+        awake = min(on, tx + rx + listen)
+        tx = min(tx, awake)
+        radio = m["radioTxMa"] * tx + m["radioRxMa"] * (awake - tx) + m["radioOffMa"] * (elapsed - awake)
+    else:
+        tx = min(on, c["txPackets"] * frame_ms)
+        radio = m["radioTxMa"] * tx + m["radioRxMa"] * (on - tx) + m["radioOffMa"] * (elapsed - on)
+
+    active = (c["txPackets"] * m["mcuTxMs"] + c["rxPackets"] * m["mcuRxMs"] +
+              elapsed / check_interval * m["mcuCheckMs"] + c["adcReads"] * m["adcMs"])
+    active = min(active, elapsed)
+    mcu = m["mcuActiveMa"] * active + m["mcuSleepMa"] * (elapsed - active)
+    adc = m["adcMa"] * c["adcReads"] * m["adcMs"]
+    led = m["ledMa"] * c["ledOn"]
+
+    result = {"radioJ": radio * mj / 1000, "mcuJ": mcu * mj / 1000,
+              "adcJ": adc * mj / 1000, "ledJ": led * mj / 1000}
+    result["totalJ"] = sum(result.values())
+    result["powerMw"] = result["totalJ"] / (elapsed / 1000) * 1000 if elapsed else 0.0
+    return result
+
+
+def lifetime_days(power_mw, model=MODEL):
+    if power_mw <= 0:
+        return None
+    joules = model["batteryMah"] * 3.6 * model["volts"]
+    return joules / (power_mw / 1000) / 86400
+
+
+def summarise(counts, check_interval, seconds, delivered, lpl=0, model=MODEL):
+    """Per-node energy and the network-wide summary: the nodes' average
+    power applied to seconds of operation, per delivered alert"""
+    nodes = dict((n, node_energy(c, check_interval, lpl, model)) for n, c in counts.items())
+    if not nodes:
+        return nodes, {}
+    powers = [e["powerMw"] for e in nodes.values()]
+    energy = sum(powers) * seconds / 1000
+    summary = {
+        "energyJ": energy,
+        "joulesPerDelivered": energy / delivered if delivered else None,
+        "meanPowerMw": sum(powers) / len(powers),
+        "maxPowerMw": max(powers),
+        "lifetimeDaysMin": lifetime_days(max(powers), model),
+        "lifetimeDaysMean": lifetime_days(sum(powers) / len(powers), model),
+    }
+    for part in ("radioJ", "mcuJ", "adcJ", "ledJ"):
+        summary[part] = sum(e[part] / counts[n]["elapsed"] for n, e in nodes.items()
+                            if counts[n]["elapsed"]) * seconds * 1000
+    return nodes, summary
+
+
+def write_nodes(path, counts, nodes, model=MODEL):
+    with open(path, "w") as f:
+        f.write("node," + ",".join(COUNTS) + ",radioJ,mcuJ,adcJ,ledJ,totalJ,powerMw,lifetimeDays\n")
+        for n in sorted(nodes):
+            e = nodes[n]
+            f.write("%d,%s,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%s\n" % (
+                n, ",".join(str(counts[n][k]) for k in COUNTS), e["radioJ"], e["mcuJ"],
+                e["adcJ"], e["ledJ"], e["totalJ"], e["powerMw"],
+                "%.1f" % lifetime_days(e["powerMw"], model) if e["powerMw"] > 0 else ""))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Energy use of AntiTheft nodes.")
+    parser.add_argument("log", nargs="?", help="debug log of a simulation (run.py --log)")
+    parser.add_argument("--reports", help="energy reports received from motes (CSV)")
+    parser.add_argument("--check-interval", type=int, default=1000, help="ms (default 1000)")
+    parser.add_argument("--lpl", type=int, default=0,
+                        help="project onto a low-power listening wakeup interval (ms)")
+    parser.add_argument("--delivered", type=int, help="alerts delivered, for joules per alert")
+    parser.add_argument("--seconds", type=float,
+                        help="operating time the network energy is given for (default: as counted)")
+    parser.add_argument("--model", help="JSON file overriding values of the energy model")
+    parser.add_argument("--nodes", help="write per-node energy to this CSV file")
+    args = parser.parse_args()
+    if bool(args.log) == bool(args.reports):
+        parser.error("give either a simulation log or --reports")
+
+    model = dict(MODEL)
+    if args.model:
+        with open(args.model) as f:
+            model.update(json.load(f))
+    counts = parse_log(args.log) if args.log else read_reports(args.reports)
+    seconds = args.seconds or max(c["elapsed"] for c in counts.values()) / 1000.0
+    nodes, summary = summarise(counts, args.check_interval, seconds, args.delivered,
+                               args.lpl, model)
+    if args.nodes:
+        write_nodes(args.nodes, counts, nodes, model)
+    print(json.dumps(summary, indent=2, sort_keys=True))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,471 @@
+#!/usr/bin/env python
+"""Run the AntiTheft application under TOSSIM and report what happened.
+
+Build the simulation first:
+
+    $ (cd sim; make micaz sim)
+
+Then, for instance,
+
+    $ sim/run.py --time 120 grid:5x5
+    $ sim/run.py --blacklist 60:7:20000 --alerts alerts.csv random:50
+    $ sim/run.py --unicast --blacklist 60:7:20000 grid:5x5
+    $ sim/run.py --urgent --blacklist 60:7:20000 grid:5x5
+    $ sim/run.py --profile 1:4000 --profile 10:500 grid:5x5
+
+boots every mote of the topology (mote 0 runs the root code, all others
+the node code), pushes settings through the root's simulated serial port
+once the network is up, and optionally pushes blacklists later on. The
+motes' debug output is parsed into alert delivery and energy metrics
+(see energy.py), printed as JSON. Every radio send is counted by AM
+type, so the packets the dissemination service sends to keep the
+settings consistent show up as disseminationSends.
+
+With --unicast, a blacklist is sent as a command along the route the
+root last saw in an alert from or through the target, as alertd and the
+GUI do, and falls back to a settings push if no route is known or the
+target does not acknowledge it within COMMAND_TIMEOUT.
+
+With --urgent, blacklist pushes (including unicast fallbacks) are sent
+as urgent settings: the root also floods the blacklist page it lists
+the node in, which every node repeats once (urgentSends counts these broadcasts).
+
+--profile FIRST:INTERVAL[:ALERT] pushes a profiles table (in pages of
+PROFILE_PAGE_SIZE entries) with the settings: nodes FIRST and up (to
+the next FIRST given) check every INTERVAL ms, and report with ALERT if
+given. profileNodes counts the nodes running each check interval at the
+end.
+"""
+
+from __future__ import print_function
+
+import argparse
+import heapq
+import json
+import os
+import random
+import re
+import struct
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+
+import energy
+import topology
+
+ROOT = 0
+NO_HOP = 999  # an unused alert path entry (AntiTheftP)
+
+
+def read_constants(path=os.path.join(HERE, "..", "Nodes", "antitheft.h")):
+    """The enum constants of antitheft.h"""
+    constants = {}
+    with open(path) as f:
+        text = f.read()
+    # The compile-time defaults that some constants are set from
+    for name, value in re.findall(r"#define\s+(\w+)\s+(\d+)\s*$", text, re.M):
+        constants[name] = int(value)
+    for body in re.findall(r"enum\s*{(.*?)}", text, re.S):
+        body = re.sub(r"/\*.*?\*/|//[^\n]*", "", body, flags=re.S)
+        for item in body.split(","):
+            # A value, or a product of values (e.g. PAGES * PAGE_SIZE)
+            m = re.match(r"\s*(\w+)\s*=\s*(\w+(?:\s*\*\s*\w+)*)\s*$", item)
+            if m:
+                product = 1
+                for value in re.split(r"\s*\*\s*", m.group(2)):
+                    product *= constants[value] if value in constants else int(value, 0)
+                constants[m.group(1)] = product
+    return constants
+
+
+C = read_constants()
+
+ALERT_FIELDS = ("stolenId", "voltageData", "packetId", "path1", "path2", "path3",
+                "path4", "path5", "path6", "ignoredId", "settingsVersion")
+COMMAND_FIELDS = ("seqno", "rootId", "type", "ack", "hops", "hop", "duration",
+                  "route1", "route2", "route3", "route4", "route5", "route6")
+STATUS_FIELDS = ("seqno", "interval", "received", "forwarded", "dropped",
+                 "sendFailed", "uartBusy", "queueLen", "maxQueue")
+
+
+def settings_payload(check_interval, target=ROOT, duration=0, version=1,
+                     alert=C["DEFAULT_ALERT"], detect=C["DEFAULT_DETECT"]):
+    """A settings_t, as the GUI sends it (target ROOT blacklists nobody)"""
+    return struct.pack(">BBHHHH", alert, detect, check_interval, target, duration, version)
+
+
+def profiles_payloads(profiles, version):
+    """The profiles_t pages of a table of (first, interval, alert) entries,
+    in the order the GUI sends them"""
+    n = C["PROFILE_PAGE_SIZE"]
+    entries = sorted(profiles)
+    pages = []
+    for page in range(max(1, (len(entries) + n - 1) // n)):
+        chunk = entries[page * n:(page + 1) * n]
+        firsts, intervals, alerts = zip(*(chunk + [(0, 0, 0)] * (n - len(chunk))))
+        pages.append(struct.pack(">BB%dH%dH%dBH" % (n, n, n), page, len(chunk),
+                                 *(firsts + intervals + alerts + (version,))))
+    return pages
+
+
+def command_payload(seqno, route, duration):
+    """A command_t blacklisting route[-1] for duration ms, as the PC sends it"""
+    hops = list(route) + [0] * (C["COMMAND_MAX_HOPS"] - len(route))
+    return struct.pack(">HHBBBBH6H", seqno, ROOT, C["COMMAND_BLACKLIST"], 0, len(route), 0,
+                       duration, *hops)
+
+
+def alert_routes(alert):
+    """Routes from the root to the nodes on an alert's path, as lists of
+    hops starting with the root's neighbour"""
+    routes = {}
+    path = [alert["path%d" % i] for i in range(1, C["COMMAND_MAX_HOPS"] + 1)]
+    for i, node in enumerate(path):
+        if node in (NO_HOP, ROOT) or node in path[:i]:
+            break
+        routes[node] = path[:i + 1]
+    return routes
+
+
+def decode(fields, fmt, hexdata):
+    return dict(zip(fields, struct.unpack(fmt, bytes(bytearray.fromhex(hexdata)))))
+
+
+def percentile(values, p):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100.0 * len(values)))]
+
+
+LINE = re.compile(r"DEBUG \((\d+)\): ([\w-]+)(.*)")
+AM_SEND = re.compile(r"DEBUG \((\d+)\): AM: Sending packet \(id=(\d+),")
+
+# AM types of the application's own sends, and of CTP (routing beacons
+# and data); every other send belongs to the dissemination service
+APP_AM_TYPES = (C["AM_THEFT"], C["AM_COMMAND"], C["AM_ENERGY"], C["AM_URGENT"], 0x70, 0x71)
+
+
+def parse_log(path, ticks_per_second, end_time, settle=2.0, blacklists=(), pushes=None):
+    """Alert delivery metrics from the motes' debug output. Alerts
+    originated in the last settle seconds are not counted, as they may
+    still be on their way. blacklists are the (time, node) of the
+    blacklists pushed, timed until the node turns its radio off; pushes
+    maps the version of each settings push to its time, to time its
+    dissemination."""
+    ms = 1000.0 / ticks_per_second
+    origins = {}
+    arrivals = {}
+    sent = busy = radio_off = stuck = 0
+    status = []
+    settings = {}
+    profiles = {}
+    radio_offs = {}
+    command_acks = 0
+    dissemination_sends = urgent_sends = 0
+
+    with open(path) as f:
+        for line in f:
+            m = AM_SEND.match(line)
+            if m:
+                if int(m.group(2)) == C["AM_URGENT"]:
+                    urgent_sends += 1
+                elif int(m.group(2)) not in APP_AM_TYPES:
+                    dissemination_sends += 1
+                continue
+            m = LINE.match(line)
+            if not m:
+                continue
+            node, event, args = int(m.group(1)), m.group(2), m.group(3).split()
+            if event == "origin":
+                origins[(int(args[1]), int(args[2]))] = int(args[0])
+            elif event in ("sent", "relay"):  # relay: a CTP hop
+                sent += 1
+            elif event == "busy":
+                busy += 1
+            elif event == "stuck":
+                stuck += 1
+            elif event == "radio-off":
+                radio_off += 1
+                radio_offs.setdefault(node, []).append(int(args[0]))
+            elif event == "profile":
+                profiles[node] = int(args[1])
+            elif event == "settings":
+                settings.setdefault(int(args[1]), {})[node] = int(args[0])
+            elif event == "serial":
+                t, am = int(args[0]), int(args[1])
+                if am == C["AM_ALERT"]:
+                    a = decode(ALERT_FIELDS, ">11H", args[2])
+                    arrivals.setdefault((a["stolenId"], a["packetId"]), []).append(t)
+                elif am == C["AM_ROOT_STATUS"]:
+                    status.append(decode(STATUS_FIELDS, ">7H2B", args[2]))
+                elif am == C["AM_COMMAND"]:
+                    command_acks += 1
+
+    cutoff = end_time - settle * ticks_per_second
+    counted = [k for k, t in origins.items() if t <= cutoff]
+    delivered = [k for k in counted if k in arrivals]
+    latencies = [(min(arrivals[k]) - origins[k]) * ms for k in delivered]
+    copies = sum(len(arrivals[k]) for k in delivered)
+    blacklist_latencies = []
+    for when, node in blacklists:
+        offs = [t for t in radio_offs.get(node, []) if t >= when]
+        if offs:
+            blacklist_latencies.append((min(offs) - when) * ms)
+    pushes = pushes or {}
+
+    return {
+        "originated": len(counted),
+        "delivered": len(delivered),
+        "deliveryRatio": float(len(delivered)) / len(counted) if counted else None,
+        "latencyMs": dict(("p%d" % p, percentile(latencies, p)) for p in (50, 90, 99)),
+        "latencyMaxMs": max(latencies) if latencies else None,
+        "transmissions": sent,
+        "transmissionsPerDelivered": float(sent) / len(delivered) if delivered else None,
+        "duplicates": copies - len(delivered),
+        "busyDrops": busy,
+        "stuckSends": stuck,
+        "rootDropped": sum(s["dropped"] for s in status),
+        "blacklists": radio_off,
+        "blacklistLatencyMs": {
+            "mean": (sum(blacklist_latencies) / len(blacklist_latencies)
+                     if blacklist_latencies else None),
+            "max": max(blacklist_latencies) if blacklist_latencies else None,
+            "missed": len(blacklists) - len(blacklist_latencies)},
+        "commandAcks": command_acks,
+        "settingsNodes": dict((v, len(n)) for v, n in settings.items()),
+        "settingsConvergedMs": dict((v, (max(n.values()) - min(n.values())) * ms)
+                                    for v, n in settings.items()),
+        "settingsLatencyMs": dict((v, (max(n.values()) - pushes[v]) * ms)
+                                  for v, n in settings.items() if v in pushes),
+        "disseminationSends": dissemination_sends,
+        "urgentSends": urgent_sends,
+        "profileNodes": dict((i, list(profiles.values()).count(i)) for i in set(profiles.values())),
+    }
+
+
+def write_alerts(path, log_path, ticks_per_second):
+    """The alerts the root sent to the PC, in alertd's CSV format"""
+    with open(log_path) as f, open(path, "w") as out:
+        out.write("time,root," + ",".join(ALERT_FIELDS) + "\n")
+        for line in f:
+            m = LINE.match(line)
+            if m and m.group(2) == "serial":
+                args = m.group(3).split()
+                if int(args[1]) == C["AM_ALERT"]:
+                    a = decode(ALERT_FIELDS, ">11H", args[2])
+                    out.write("%d,%s,%s\n" % (int(args[0]) * 1000 // ticks_per_second,
+                                              m.group(1),
+                                              ",".join(str(a[k]) for k in ALERT_FIELDS)))
+
+
+def read_noise(path, count=100):
+    """The first count readings of a TOSSIM noise trace"""
+    readings = []
+    with open(path) as f:
+        for line in f:
+            if line.strip():
+                readings.append(int(line))
+                if len(readings) == count:
+                    break
+    return readings
+
+
+def default_noise():
+    tosroot = os.environ.get("TOSROOT", "/opt/tinyos-2.x")
+    return os.path.join(tosroot, "tos", "lib", "tossim", "noise", "meyer-heavy.txt")
+
+
+def simulate(spec, seconds, check_interval=C["DEFAULT_CHECK_INTERVAL"], blacklists=(),
+             reach=1.5, seed=1, noise=None, log_path=None, settings_at=5.0,
+             boot_spread=1.0, lpl=0, unicast=False, urgent=False, profiles=()):
+    """Simulate seconds of the application on topology spec. blacklists
+    are (time s, node, duration ms) pushes, sent as commands if unicast
+    and as urgent settings if urgent. profiles are the (first, interval,
+    alert) entries of a profiles table pushed with the settings.
+    Returns the metrics, the path of the debug log (a temporary file
+    unless log_path is given) and the simulation's ticks per second. The
+    energy metrics are projected onto a low-power listening wakeup
+    interval of lpl ms (0: none)."""
+    from TOSSIM import Tossim
+
+    nodes, links = topology.parse(spec, reach, seed)
+    rng = random.Random(seed)
+    t = Tossim([])
+    t.randomSeed(seed)
+    tps = t.ticksPerSecond()
+
+    radio = t.radio()
+    for a, b, g in links:
+        radio.add(a, b, g)
+
+    readings = read_noise(noise or default_noise())
+    for n in nodes:
+        mote = t.getNode(n)
+        for r in readings:
+            mote.addNoiseTraceReading(r)
+        mote.createNoiseModel()
+        mote.bootAtTime(int(rng.uniform(0, boot_spread) * tps) + 1)
+
+    if log_path is None:
+        fd, log_path = tempfile.mkstemp(prefix="antitheft-", suffix=".log")
+        os.close(fd)
+    log = open(log_path, "w")
+    t.addChannel("AntiTheft", log)
+    t.addChannel("Serial", log)
+    t.addChannel("AM", log)
+
+    # The PC's settings pushes and commands arrive at the root as if over
+    # the serial port
+    def push(am_type, payload, when):
+        pkt = t.newPacket()
+        pkt.setData(payload)
+        pkt.setType(am_type)
+        pkt.setDestination(ROOT)
+        pkt.deliver(ROOT, max(when, t.time() + 1))
+
+    push(C["AM_SETTINGS"], settings_payload(check_interval), int(settings_at * tps))
+    blacklist_am = C["AM_URGENT_SETTINGS"] if urgent else C["AM_SETTINGS"]
+    # Versions go up in the order of the pushes: the settings, the
+    # profiles, then the blacklists
+    profiles_version = 2
+    first_blacklist = profiles_version + 1 if profiles else 2
+    if profiles:
+        for page, payload in enumerate(profiles_payloads(profiles, profiles_version)):
+            push(C["AM_PROFILES"], payload, int(settings_at * tps) + 1 + page)
+    actions = []
+    for i, (when, node, duration) in enumerate(blacklists):
+        version = i + first_blacklist
+        if unicast:
+            heapq.heappush(actions, (int(when * tps), "command", version, node, duration))
+        else:
+            push(blacklist_am, settings_payload(check_interval, node, duration, version),
+                 int(when * tps))
+
+    # With unicast, the simulation stops at every command to learn the
+    # routes and acknowledgements the root has passed to the PC so far
+    end = int(seconds * tps)
+    reader = open(log_path)
+    routes, acked = {}, set()
+    commands = fallbacks = 0
+    while t.time() < end:
+        until = min(end, actions[0][0]) if actions else end
+        while t.time() < until and t.runNextEvent():
+            pass
+        if t.time() < until:
+            break  # nothing left to simulate
+        if actions and actions[0][0] <= t.time():
+            log.flush()
+            for line in reader:
+                m = LINE.match(line)
+                if m and m.group(2) == "serial":
+                    args = m.group(3).split()
+                    if int(args[1]) == C["AM_ALERT"]:
+                        routes.update(alert_routes(decode(ALERT_FIELDS, ">11H", args[2])))
+                    elif int(args[1]) == C["AM_COMMAND"]:
+                        acked.add(decode(COMMAND_FIELDS, ">HHBBBBH6H", args[2])["seqno"])
+            when, action, version, node, duration = heapq.heappop(actions)
+            if action == "command" and node in routes:
+                commands += 1
+                push(C["AM_COMMAND"], command_payload(version, routes[node], duration), when)
+                heapq.heappush(actions, (when + C["COMMAND_TIMEOUT"] * tps // 1000,
+                                         "timeout", version, node, duration))
+            elif action == "command" or version not in acked:
+                fallbacks += 1
+                push(blacklist_am, settings_payload(check_interval, node, duration, version),
+                     when)
+    reader.close()
+    log.close()
+
+    pushed = dict((i + first_blacklist, int(when * tps))
+                  for i, (when, _, _) in enumerate(blacklists))
+    pushed[1] = int(settings_at * tps)
+    if profiles:
+        pushed[profiles_version] = int(settings_at * tps) + 1
+    metrics = parse_log(log_path, tps, end, pushes=pushed,
+                        blacklists=[(int(when * tps), node) for when, node, _ in blacklists])
+    metrics["commands"] = commands
+    metrics["commandFallbacks"] = fallbacks
+    metrics["energy"] = energy.summarise(energy.parse_log(log_path), check_interval, seconds,
+                                         metrics["delivered"], lpl)[1]
+    return metrics, log_path, tps
+
+
+def blacklist_arg(text):
+    when, node, duration = text.split(":")
+    return float(when), int(node), int(duration)
+
+
+def profile_arg(text):
+    values = [int(v) for v in text.split(":")]
+    if len(values) not in (2, 3):
+        raise argparse.ArgumentTypeError("expected FIRST:INTERVAL[:ALERT]: " + text)
+    return tuple(values) if len(values) == 3 else (values[0], values[1], 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate the AntiTheft application.")
+    parser.add_argument("topology", nargs="?", default="grid:5x5",
+                        help="grid:WxH, line:N, random:N[:density] or a TOSSIM gain file")
+    parser.add_argument("--time", type=float, default=60, help="simulated seconds")
+    parser.add_argument("--check-interval", type=int, default=C["DEFAULT_CHECK_INTERVAL"],
+                        help="check interval pushed to the nodes (ms)")
+    parser.add_argument("--blacklist", type=blacklist_arg, action="append", default=[],
+                        metavar="TIME:NODE:MS", help="blacklist NODE for MS ms at TIME s")
+    parser.add_argument("--unicast", action="store_true",
+                        help="send blacklists as source-routed commands")
+    parser.add_argument("--urgent", action="store_true",
+                        help="send blacklist pushes as urgent settings")
+    parser.add_argument("--profile", type=profile_arg, action="append", default=[],
+                        metavar="FIRST:INTERVAL[:ALERT]",
+                        help="check interval (and reporting) of nodes FIRST and up")
+    parser.add_argument("--reach", type=float, default=1.5,
+                        help="radio reach of generated topologies (units)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--noise", help="TOSSIM noise trace (default meyer-heavy)")
+    parser.add_argument("--lpl", type=int, default=0,
+                        help="project energy onto this LPL wakeup interval (ms; default none)")
+    parser.add_argument("--energy", help="write per-node energy use (CSV)")
+    parser.add_argument("--build", help="directory of the TOSSIM build to use (default sim)")
+    parser.add_argument("--log", help="keep the debug output in this file")
+    parser.add_argument("--alerts", help="write the alerts the PC received (CSV)")
+    parser.add_argument("--json", help="write the metrics to this file")
+    args = parser.parse_args()
+    if len(args.profile) > C["PROFILE_SIZE"]:
+        parser.error("at most %d profiles" % C["PROFILE_SIZE"])
+    if len(set(first for first, _, _ in args.profile)) < len(args.profile):
+        parser.error("profiles must start at different nodes")
+    if args.build:
+        sys.path.insert(0, os.path.abspath(args.build))
+
+    metrics, log_path, tps = simulate(args.topology, args.time, args.check_interval,
+                                 args.blacklist, args.reach, args.seed, args.noise,
+                                 args.log, lpl=args.lpl, unicast=args.unicast,
+                                 urgent=args.urgent, profiles=args.profile)
+    if args.alerts:
+        write_alerts(args.alerts, log_path, tps)
+    if args.energy:
+        counts = energy.parse_log(log_path)
+        nodes = energy.summarise(counts, args.check_interval, args.time, None, args.lpl)[0]
+        energy.write_nodes(args.energy, counts, nodes)
+    if not args.log:
+        os.unlink(log_path)
+
+    metrics["topology"] = args.topology
+    metrics["seconds"] = args.time
+    metrics["checkInterval"] = args.check_interval
+    metrics["lpl"] = args.lpl
+    metrics["unicast"] = args.unicast
+    metrics["urgent"] = args.urgent
+    text = json.dumps(metrics, indent=2, sort_keys=True)
+    if args.json:
+        with open(args.json, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,169 @@
+#!/usr/bin/env python
+"""Run the simulation over a grid of parameters, on all cores.
+
+    $ sim/sweep.py -p check-interval=500,1000,2000 -p blacklist=60:7:10000,60:7:30000 \\
+          -D ANTITHEFT_ROOT_QUEUE_SIZE=4,8,16 -p seed=1,2,3 -o sweep grid:10x10
+
+runs run.py once for every combination of the values given. -p sets a
+run.py option (time, check-interval, lpl, blacklist, reach, seed, noise,
+or topology instead of the positional topologies); -D sets a compile-time
+define of Nodes/antitheft.h (e.g., ANTITHEFT_ROOT_QUEUE_SIZE). Each
+combination of defines gets its own TOSSIM build under --build-dir,
+built before any run starts.
+
+TOSSIM does not model low-power listening: SimLplP accepts and ignores
+the wakeup interval, so every simulated radio is always on. lpl only
+re-projects the energy of each run onto that wakeup interval after the
+run (see energy.py), and sweeping ANTITHEFT_LPL_INTERVAL changes
+nothing in the simulation.
+
+Runs are independent, so they are spread over -j workers (default: one
+per core). Workers take the next run from one shared queue as soon as
+they finish the last one, so a few slow runs do not hold up the rest;
+the largest topologies are queued first. Every run happens in its own
+process. The metrics of all runs are merged into OUTPUT.json and
+OUTPUT.csv, one row per run with the parameters first; a failed run
+leaves a row with its error.
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import itertools
+import json
+import multiprocessing
+import os
+import subprocess
+import sys
+import time
+from multiprocessing.pool import ThreadPool
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+
+import bench
+import topology
+
+RUN_OPTIONS = ("time", "check-interval", "lpl", "blacklist", "reach", "seed", "noise",
+               "topology")
+
+
+def parameter(text):
+    name, sep, values = text.partition("=")
+    if not sep or not values:
+        raise argparse.ArgumentTypeError("expected NAME=VALUE[,VALUE...]: " + text)
+    return name, values.split(",")
+
+
+def grid(parameters):
+    """Every combination of the parameters' values, as dicts"""
+    names = [name for name, _ in parameters]
+    return [dict(zip(names, values))
+            for values in itertools.product(*[values for _, values in parameters])]
+
+
+def build_name(defines):
+    return "-".join("%s=%s" % d for d in sorted(defines.items())) or "default"
+
+
+def build(directory, defines, variables=None):
+    """Build the simulation with the given defines, and Makefile
+    variables (e.g. DISSEMINATION), in directory"""
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    command = (["make", "-f", os.path.join(HERE, "Makefile"), "micaz", "sim",
+                "SIM_DEFINES=" + " ".join("-D%s=%s" % d for d in sorted(defines.items()))] +
+               ["%s=%s" % v for v in sorted((variables or {}).items())])
+    with open(os.path.join(directory, "build.log"), "w") as log:
+        status = subprocess.call(command, cwd=directory, stdout=log, stderr=subprocess.STDOUT)
+    if status != 0:
+        raise RuntimeError("build %s failed, see %s/build.log" % (build_name(defines), directory))
+
+
+def cost(job):
+    """Rough relative run time of a job, to queue the longest first"""
+    run, _ = job
+    nodes = len(topology.parse(run["topology"], float(run.get("reach", 1.5)))[0])
+    return nodes * float(run.get("time", 60))
+
+
+def simulate(job, build_dir):
+    run, defines = job
+    options = ["--build", os.path.join(build_dir, build_name(defines))]
+    for name in RUN_OPTIONS:
+        if name in run and name not in ("topology", "seed", "reach"):
+            options += ["--" + name, run[name]]
+    try:
+        row = bench.run_isolated(options, run["topology"], int(run.get("seed", 1)),
+                                 float(run.get("reach", 1.5)))
+    except (RuntimeError, OSError, ValueError) as e:
+        row = {"error": str(e)}
+    # The parameters as given, not as run.py echoes them
+    row.update(run)
+    row.update(defines)
+    return row
+
+
+def write(prefix, rows, columns):
+    with open(prefix + ".json", "w") as f:
+        json.dump({"revision": bench.git_revision(), "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+                   "runs": rows}, f, indent=2, sort_keys=True)
+        f.write("\n")
+    with open(prefix + ".csv", "w") as f:
+        out = csv.DictWriter(f, columns, extrasaction="ignore", lineterminator="\n")
+        out.writeheader()
+        out.writerows(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Sweep simulation parameters on all cores.")
+    parser.add_argument("topologies", nargs="*", default=["grid:10x10"],
+                        help="topologies to run (unless given with -p topology=...)")
+    parser.add_argument("-p", dest="run", type=parameter, action="append", default=[],
+                        metavar="NAME=V1,V2", help="run.py option values")
+    parser.add_argument("-D", dest="defines", type=parameter, action="append", default=[],
+                        metavar="NAME=V1,V2", help="compile-time define values")
+    parser.add_argument("-j", "--jobs", type=int, default=multiprocessing.cpu_count(),
+                        help="simulations run at once (default: one per core)")
+    parser.add_argument("-o", "--output", default="sweep",
+                        help="write OUTPUT.json and OUTPUT.csv (default sweep)")
+    parser.add_argument("--build-dir", default=os.path.join(HERE, "sweepbuild"),
+                        help="where the per-define builds go (default sim/sweepbuild)")
+    args = parser.parse_args()
+
+    for name, _ in args.run:
+        if name not in RUN_OPTIONS:
+            parser.error("unknown run.py option %s (one of %s)" % (name, ", ".join(RUN_OPTIONS)))
+    run_parameters = list(args.run)
+    if "topology" not in [name for name, _ in run_parameters]:
+        run_parameters.append(("topology", args.topologies))
+    builds = grid(args.defines)
+    jobs = sorted(((run, defines) for defines in builds for run in grid(run_parameters)),
+                  key=cost, reverse=True)
+
+    start = time.time()
+    pool = ThreadPool(max(1, args.jobs))
+    pool.map(lambda defines: build(os.path.join(args.build_dir, build_name(defines)), defines),
+             builds, chunksize=1)
+    print("%d builds in %.0f s; %d runs on %d workers" % (len(builds), time.time() - start,
+                                                          len(jobs), args.jobs))
+
+    names = [name for name, _ in run_parameters + args.defines]
+    columns = names + [c for c in bench.COLUMNS + ("error",)
+                       if c not in names and c not in ("shape", "size")]
+    rows = []
+    for row in pool.imap_unordered(lambda job: simulate(job, args.build_dir), jobs, chunksize=1):
+        rows.append(row)
+        print("%d/%d %s: %s" % (len(rows), len(jobs), " ".join("%s=%s" % (n, row[n]) for n in names),
+                                row.get("error") or "delivery %s, p90 %s ms" % (
+                                    bench.fmt(row.get("deliveryRatio")),
+                                    bench.fmt(row.get("latencyP90Ms")))))
+        sys.stdout.flush()
+        write(args.output, rows, columns)
+    pool.close()
+    print("%.0f s in all" % (time.time() - start))
+
+
+if __name__ == "__main__":
+    main()
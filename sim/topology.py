@@ -0,0 +1,100 @@
+"""Topologies for the TOSSIM simulation of the AntiTheft application.
+
+A topology maps mote ids to positions; radio gains follow from the
+distances. Generated topologies put the root (id 0) in a corner, one unit
+from its nearest neighbours. Ids skip 999, which alerts use to mark an
+empty path entry.
+"""
+
+import math
+import random
+import re
+
+NO_NODE = 999
+
+# Gain (dBm) of a link of one unit, and its decrease per decade of distance
+GAIN_AT_UNIT = -55.0
+GAIN_PER_DECADE = -30.0
+
+
+def node_ids(count):
+    """The first count usable mote ids, root first."""
+    ids = []
+    i = 0
+    while len(ids) < count:
+        if i != NO_NODE:
+            ids.append(i)
+        i += 1
+    return ids
+
+
+def grid(width, height):
+    ids = node_ids(width * height)
+    return dict((ids[y * width + x], (float(x), float(y)))
+                for y in range(height) for x in range(width))
+
+
+def line(count):
+    return grid(count, 1)
+
+
+def uniform(count, density=1.0, seed=1):
+    """count motes spread uniformly over a square with density motes per
+    square unit, the root in the corner"""
+    rng = random.Random(seed)
+    side = math.sqrt(count / density)
+    ids = node_ids(count)
+    positions = {ids[0]: (0.0, 0.0)}
+    for i in ids[1:]:
+        positions[i] = (rng.uniform(0, side), rng.uniform(0, side))
+    return positions
+
+
+def gain(distance):
+    return GAIN_AT_UNIT + GAIN_PER_DECADE * math.log10(max(distance, 0.1))
+
+
+def links(positions, reach=1.5):
+    """Directed links (from, to, gain) between motes at most reach apart"""
+    result = []
+    items = sorted(positions.items())
+    for i, (a, pa) in enumerate(items):
+        for b, pb in items[i + 1:]:
+            d = math.hypot(pa[0] - pb[0], pa[1] - pb[1])
+            if d <= reach:
+                g = gain(d)
+                result.append((a, b, g))
+                result.append((b, a, g))
+    return result
+
+
+def read_gains(path):
+    """Links of a TOSSIM gain file ("gain <from> <to> <dBm>" lines, as
+    written by LinkLayerModel)"""
+    result = []
+    nodes = set()
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 4 and fields[0] == "gain":
+                a, b, g = int(fields[1]), int(fields[2]), float(fields[3])
+                result.append((a, b, g))
+                nodes.update((a, b))
+    return sorted(nodes), result
+
+
+def parse(spec, reach=1.5, seed=1):
+    """Nodes and links of a topology spec: grid:WxH, line:N,
+    random:N[:density] or a TOSSIM gain file"""
+    m = re.match(r"grid:(\d+)x(\d+)$", spec)
+    if m:
+        positions = grid(int(m.group(1)), int(m.group(2)))
+    elif re.match(r"line:\d+$", spec):
+        positions = line(int(spec.split(":")[1]))
+    elif re.match(r"random:\d+(:[0-9.]+)?$", spec):
+        fields = spec.split(":")
+        density = float(fields[2]) if len(fields) > 2 else 1.0
+        positions = uniform(int(fields[1]), density, seed)
+    else:
+        return read_gains(spec)
+    return sorted(positions), links(positions, reach)